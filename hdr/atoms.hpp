@@ -25,6 +25,7 @@
 #ifndef ATOMS_H_
 #define ATOMS_H_
 
+#include <stdint.h>
 #include <string>
 #include <vector>
 
@@ -100,6 +101,7 @@ namespace atoms
 	extern std::vector <int> category_array;
 	extern std::vector <int> grain_array;
 	extern std::vector <int> cell_array;
+	extern std::vector <uint64_t> global_id_array; /// Decomposition independent atom id from unit cell position
 
 	extern std::vector <double> x_spin_array;
 	extern std::vector <double> y_spin_array;
@@ -38,6 +38,7 @@ namespace grains{
 
 	extern int num_grains;
 	extern bool random_anisotropy; // flag to control randomly oriented uniaxial anisotropy
+	extern bool calculate_material_magnetisation; // flag to calculate magnetisation of each material in each grain
 
 	extern std::vector <int> grain_size_array;
 
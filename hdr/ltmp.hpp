@@ -123,6 +123,11 @@ namespace ltmp{
                                const int start_index,
                                const int end_index);
 
+   //-----------------------------------------------------------------------------
+   // Function to get temperature of each local atom
+   //-----------------------------------------------------------------------------
+   void get_local_temperatures(std::vector<double>& temperature, const int num_atoms);
+
    //-----------------------------------------------------------------------------
    // Function for updating localised temperature
    //-----------------------------------------------------------------------------
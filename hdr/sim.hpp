@@ -40,6 +40,7 @@ namespace sim{
 	extern uint64_t time;
 	extern uint64_t total_time;
 	extern uint64_t loop_time;
+	extern std::vector<uint64_t> hysteresis_loop_times;
 	extern int partial_time;
 	extern uint64_t equilibration_time;
 	extern int runs;
@@ -99,6 +100,7 @@ namespace sim{
 	extern double head_position[2];
 	extern double head_speed;
 	extern bool   head_laser_on;
+	extern bool   localised_temperature_pulse_on;
 
 	extern double cooling_time;
 	extern int cooling_function_flag;
@@ -151,6 +153,7 @@ namespace sim{
    extern bool save_checkpoint_flag; // Save checkpoint
    extern bool save_checkpoint_continuous_flag; // save checkpoints during simulations
    extern int save_checkpoint_rate; // Default increment between checkpoints
+   extern double save_checkpoint_wall_time_interval; // Minutes of wall time between checkpoints (0 = disabled)
 
 	// Initialization functions
 	extern void initialize(int num_materials);
@@ -201,6 +204,7 @@ namespace sim{
    extern double spin_applied_field_energy(const double, const double, const double);
    extern double spin_magnetostatic_energy(const int, const double, const double, const double);
    extern double lattice_anisotropy_function(const double, const int);
+   extern void get_local_temperatures(std::vector<double>& temperature, const int num_atoms);
 
    // LaGrange multiplier variables
    extern double lagrange_lambda_x;
@@ -215,6 +219,11 @@ namespace sim{
    extern double mc_statistics_moves;
    extern double mc_statistics_reject;
 
+   // Magnetisation sums of each material maintained incrementally by the Monte Carlo integrator
+   extern int mc_magnetization_recalculation_rate; /// number of sweeps between full recalculations (0 = no tracking)
+   extern std::vector<double> mc_material_magnetization; /// sums of mu_s*S (x,y,z) and mu_s, 4 per material
+   extern bool mc_material_magnetization_valid; /// false when spins have been changed outside the Monte Carlo integrator
+
 }
 
 namespace cmc{
@@ -24,6 +24,8 @@
 //
 #ifndef STATS_H_
 #define STATS_H_
+#include <complex>
+#include <stdint.h>
 #include <vector>
 #include <string>
 
@@ -42,7 +44,11 @@ namespace stats
 	extern void mag_m_reset();
 	extern double max_torque();
 
-	extern bool calculate_torque;
+	/// Steps at which a statistic is needed by the output list
+	enum schedule_t { never=0, output_steps=1, every_update=2 };
+
+	extern schedule_t torque_schedule;
+	extern void require_torque(const schedule_t schedule);
 	extern double total_system_torque[3];
 	extern double total_mean_system_torque[3];
 
@@ -52,7 +58,8 @@ namespace stats
 
 	extern double torque_data_counter;
 
-   extern bool calculate_energy;
+   extern schedule_t energy_schedule;
+   extern void require_energy(const schedule_t schedule);
 
    /// Statistics energy types
    enum energy_t { all=0, exchange=1, anisotropy=2, cubic_anisotropy=3, surface_anisotropy=4,applied_field=5, magnetostatic=6, second_order_anisotropy=7 };
@@ -62,6 +69,7 @@ namespace stats
 
    /// Statistics output functions
    extern void output_energy(std::ostream&, enum energy_t, enum stat_t);
+   extern void calculate_local_energy(double energies[9]);
 
    //-------------------------------------------------
    // New statistics module functions and variables
@@ -71,7 +79,10 @@ namespace stats
    void initialize(const int num_atoms, const int num_materials, const std::vector<double>& magnetic_moment_array, 
                    const std::vector<int>& material_type_array, const std::vector<int>& height_category_array);
    void update(const std::vector<double>& sx, const std::vector<double>& sy, const std::vector<double>& sz, const std::vector<double>& mm);
+   void update(const std::vector<double>& sx, const std::vector<double>& sy, const std::vector<double>& sz, const std::vector<double>& mm,
+               const std::vector<double>& material_magnetization);
    void reset();
+   void complete_reduction();
 
    // Statistics control flags (to be moved internally when long-awaited refactoring of vio is done)
    extern bool calculate_system_magnetization;
@@ -79,6 +90,32 @@ namespace stats
    extern bool calculate_height_magnetization;
    extern bool calculate_material_height_magnetization;
    extern bool calculate_system_susceptibility;
+   extern bool calculate_system_moments;
+   extern bool calculate_material_moments;
+   extern bool calculate_specific_heat;
+   extern bool calculate_magnetization_autocorrelation;
+   extern bool calculate_energy_autocorrelation;
+   extern bool calculate_structure_factor;
+   extern bool calculate_correlation_function;
+   extern int structure_factor_sample_rate; // number of statistics updates between structure factor samples
+   extern bool calculate_dynamic_structure_factor;
+   extern std::vector<double> dynamic_structure_factor_path; // path vertices in reciprocal lattice units
+   extern int dynamic_structure_factor_points; // number of q-points on each segment of path
+   extern int dynamic_structure_factor_window; // number of samples in each time window
+
+   /// Histogram quantities and groups of atoms
+   enum histogram_quantity_t { spin_z=0, local_temperature=1, grain_magnetization_length=2 };
+   enum histogram_group_t { system_group=0, material_group=1, grain_group=2 };
+
+   extern int histogram_bins; // number of bins in each histogram
+   extern double histogram_maximum_temperature; // upper limit of temperature histograms (K)
+   void add_histogram(const histogram_quantity_t quantity, const histogram_group_t group);
+
+   extern double target_magnetization_error; // standard error of mean magnetization length at which sampling stops (0 = never)
+   extern bool adaptive_partial_time; // flag to adapt time between samples to the autocorrelation time
+
+   bool sampling_converged();
+   int decorrelated_partial_time(const int partial_time, const uint64_t loop_time);
 
    class susceptibility_statistic_t;
 
@@ -96,6 +133,9 @@ namespace stats
          void set_mask(const int mask_size, std::vector<int> inmask, const std::vector<double>& mm);
          void get_mask(std::vector<int>& out_mask, std::vector<double>& out_saturation);
          void calculate_magnetization(const std::vector<double>& sx, const std::vector<double>& sy, const std::vector<double>& sz, const std::vector<double>& mm);
+         int reduction_size();
+         void unpack_magnetization(const double* buffer);
+         void finalize_magnetization();
          void set_magnetization(std::vector<double>& magnetization, std::vector<double>& mean_magnetization, long counter);
          void reset_magnetization_averages();
          const std::vector<double>& get_magnetization();
@@ -144,6 +184,178 @@ namespace stats
 
    };
 
+   //----------------------------------
+   // Moments Class definition
+   //----------------------------------
+   class moments_statistic_t{
+
+      public:
+         moments_statistic_t ();
+         void initialize(magnetization_statistic_t& mag_stat);
+         void calculate(const std::vector<double>& magnetization);
+         void reset_averages();
+         std::string output_binder_cumulant();
+         std::string output_correlation();
+
+      private:
+         bool initialized;
+         int num_elements;
+         double mean_counter;
+         std::vector<double> mean_m2; // running mean of m^2 for each element
+         std::vector<double> mean_m4; // running mean of m^4 for each element
+         std::vector<double> mean_mvec; // running mean of magnetization vector for each element
+         std::vector<double> comoment; // co-moments of magnetization vectors of pairs of elements
+         std::vector<double> delta; // deviation from mean before update
+
+   };
+
+   //----------------------------------
+   // Energy fluctuation Class definition
+   //----------------------------------
+   class energy_statistic_t{
+
+      public:
+         energy_statistic_t ();
+         void initialize(const double num_atoms);
+         void calculate(const double energy);
+         void reset_averages();
+         std::string output_specific_heat(const double temperature);
+
+      private:
+         double num_atoms;
+         double mean_counter;
+         double mean_energy; // running mean energy
+         double energy_m2; // running sum of squared deviations from mean energy
+
+   };
+
+   //----------------------------------
+   // Autocorrelation Class definition
+   //----------------------------------
+   class autocorrelation_statistic_t{
+
+      public:
+         autocorrelation_statistic_t ();
+         void calculate(const double value);
+         void reset_averages();
+         double num_samples() const;
+         bool is_reliable() const;
+         double standard_error() const;
+         double autocorrelation_time() const;
+         std::string output_autocorrelation_time(const int sample_time);
+         std::string output_standard_error();
+
+      private:
+         double variance_of_mean(const unsigned int level) const;
+
+         std::vector<double> counter; // number of blocks at each blocking level
+         std::vector<double> mean; // running mean of blocks at each level
+         std::vector<double> m2; // running sum of squared deviations of blocks at each level
+         std::vector<double> pending; // first block of incomplete pair at each level
+         std::vector<bool> has_pending; // flag indicating incomplete pair at each level
+
+   };
+
+   //----------------------------------
+   // Structure factor Class definition
+   //----------------------------------
+   class structure_factor_statistic_t{
+
+      public:
+         structure_factor_statistic_t ();
+         void initialize(const int nx, const int ny, const int nz, const double size, const double total_moment);
+         void calculate(const std::vector<double>& x_mag, const std::vector<double>& y_mag, const std::vector<double>& z_mag);
+         void reset_averages();
+         void output(const std::string& filename, const bool correlation);
+
+      private:
+         bool initialized;
+         int dimensions[3]; // number of cells in x,y,z
+         int num_cells;
+         double cell_size; // Angstroms
+         double normalisation; // inverse of mean saturation moment per cell
+         double mean_counter;
+         std::vector<double> mean_structure_factor; // running mean of S(q) on cell grid
+         std::vector<std::complex<double> > transform; // work array for Fourier transforms
+
+   };
+
+   //----------------------------------
+   // Dynamic structure factor Class definition
+   //----------------------------------
+   class dynamic_structure_factor_statistic_t{
+
+      public:
+         dynamic_structure_factor_statistic_t ();
+         void initialize(const std::vector<double>& x_coord, const std::vector<double>& y_coord, const std::vector<double>& z_coord,
+                         const int num_local_atoms, const double total_num_atoms, const double unit_cell_size[3],
+                         const std::vector<double>& path, const int points_per_segment, const int window_size);
+         int reduction_size();
+         void calculate_local_amplitudes(const std::vector<double>& sx, const std::vector<double>& sy, const std::vector<double>& sz, double* buffer);
+         void add_sample(const double* buffer);
+         void reset_averages();
+         void output(const std::string& filename, const double sample_time);
+
+      private:
+         bool initialized;
+         int num_q; // total number of q-points
+         int window; // number of samples in each time window
+         double num_atoms; // total number of atoms for normalisation
+         int num_samples; // number of samples in ring buffer
+         int new_samples; // number of samples since last transform
+         int head; // next position in ring buffer
+         double mean_counter;
+         std::vector<double> x; // local atomic positions
+         std::vector<double> y;
+         std::vector<double> z;
+         std::vector<double> q_start; // first q-point of each segment (1/A)
+         std::vector<double> q_step; // q-point spacing along each segment (1/A)
+         std::vector<int> q_count; // number of q-points on each segment
+         std::vector<double> q_rlu; // all q-points in reciprocal lattice units
+         std::vector<double> ring; // ring buffer of complex amplitudes
+         std::vector<double> hann; // window function
+         std::vector<double> sample_power; // power spectrum of latest window
+         std::vector<double> mean_structure_factor; // running mean of S(q,w)
+
+   };
+
+   //----------------------------------
+   // Histogram Class definition
+   //----------------------------------
+   class histogram_statistic_t{
+
+      public:
+         histogram_statistic_t (const histogram_quantity_t in_quantity, const histogram_group_t in_group);
+         histogram_quantity_t get_quantity() const;
+         histogram_group_t get_group() const;
+         void initialize(const int in_num_bins, const double in_minimum, const double in_maximum, const int in_mask_size, const std::vector<int>& in_mask);
+         const std::vector<int>& get_mask() const;
+         int get_num_bins() const;
+         double get_minimum() const;
+         double get_inverse_bin_width() const;
+         int bin(const double value) const;
+         int reduction_size() const;
+         void add_counts(const double* buffer);
+         void reset_averages();
+         void output(std::ostream& ofile, const uint64_t time);
+         void output_header(std::ostream& ofile);
+
+      private:
+         std::string name() const;
+
+         histogram_quantity_t quantity;
+         histogram_group_t group;
+         bool initialized;
+         int num_bins;
+         int mask_size;
+         double minimum;
+         double maximum;
+         double inverse_bin_width;
+         std::vector<int> mask;
+         std::vector<double> counts; // counts in each bin for each mask id, summed over samples
+
+   };
+
    // Statistics classes
    extern magnetization_statistic_t system_magnetization;
    extern magnetization_statistic_t material_magnetization;
@@ -151,6 +363,15 @@ namespace stats
    extern magnetization_statistic_t material_height_magnetization;
 
    extern susceptibility_statistic_t system_susceptibility;
+   extern moments_statistic_t system_moments;
+   extern moments_statistic_t material_moments;
+   extern energy_statistic_t energy_moments;
+   extern autocorrelation_statistic_t magnetization_autocorrelation;
+   extern autocorrelation_statistic_t energy_autocorrelation;
+   extern structure_factor_statistic_t structure_factor;
+   extern dynamic_structure_factor_statistic_t dynamic_structure_factor;
+   extern magnetization_statistic_t grain_magnetization;
+   extern std::vector<histogram_statistic_t> histograms;
    //extern susceptibility_statistic_t material_susceptibility;
 
 }
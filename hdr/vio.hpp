@@ -113,6 +113,14 @@ namespace vout{
 
 	extern bool output_atoms_config;
 	extern int output_atoms_config_rate;
+	extern int output_atoms_config_format; // 0 = text file per processor, 1 = single binary file, 2 = trajectory
+	extern int output_config_precision; // bytes per value in binary configuration files (4 or 8)
+	extern int output_trajectory_bits; // bits per quantised value in trajectory frames
+	extern int output_trajectory_keyframe_interval; // number of frames between key frames in trajectory
+	extern bool output_trajectory_quantised; // store quantised spin directions in trajectory, otherwise raw values
+
+	extern int total_output_atoms;
+	extern std::vector<int> local_output_atom_list;
 
 	extern double atoms_output_min[3];
 	extern double atoms_output_max[3];
@@ -124,6 +132,14 @@ namespace vout{
 
 	extern bool output_cells_config;
 	extern int output_cells_config_rate;
+	extern int output_cells_config_format; // 0 = text file, 1 = binary file
+
+	extern bool asynchronous_output;
+	extern int asynchronous_output_queue_depth;
+
+	extern int output_structure_factor_rate;
+	extern int output_dynamic_structure_factor_rate;
+	extern int output_histogram_rate;
 
 	extern bool output_grains_config;
 	extern int output_config_grain_rate;
@@ -136,6 +152,10 @@ namespace vout{
 
 	extern void data();
 	extern void config();
+	extern void write_snapshot(const std::string& filename, const std::string& preamble, std::vector<double>& data,
+	                           const int columns, const int format);
+	extern void finalize_asynchronous_output();
+	extern void finalize_trajectory();
 	extern void zLogTsInit(std::string);
 
 	//extern int pov_file();
@@ -148,5 +168,6 @@ namespace vout{
 // Checkpoint load/save functions
 void load_checkpoint();
 void save_checkpoint();
+void save_checkpoint_on_wall_time();
 
 #endif /*VIO_H_*/
@@ -43,13 +43,18 @@ namespace vmpi{
 
 	extern int my_rank; 					///< Local CPU ID
 	extern int num_processors;			///< Total number of CPUs
-	extern int mpi_mode; 				///< MPI Simulation Mode (0 = Geometric Decomposition, 1 = Replicated Data, 2 = Statistical Parallelism)
+	extern int mpi_mode; 				///< MPI Simulation Mode (0 = Geometric Decomposition, 1 = Replicated Data, 2 = Statistical Parallelism, 3 = Recursive Bisection)
 	extern int ppn;						///< Processors per node
+	extern int num_threads;				///< Number of OpenMP threads per process (hybrid mode)
 	extern int num_core_atoms;			///< Number of atoms on local CPU with no external communication
 	extern int num_bdry_atoms;			///< Number of atoms on local CPU with external communication
 	extern int num_halo_atoms;			///< Number of atoms on remote CPUs needed for boundary atom integration
 
-	extern bool replicated_data_staged; ///< Flag for staged system generation
+
+	extern int num_domains[3];			///< Number of domains in x,y,z for geometric decomposition
+	extern bool load_balance;			///< Flag to move partition planes at creation to balance atom and bond counts (static)
+	extern bool load_balance_measured;	///< Flag to weight atoms with measured costs from a previous run (profile-guided)
+	extern double load_balance_threshold; ///< Maximum/average load above which partition planes are moved
 
 	extern char hostname[20];			///< Hostname of local CPU
 	extern double min_dimensions[3]; 	///< Minimum coordinates of system on local cpu
@@ -80,9 +85,18 @@ namespace vmpi{
 	extern std::vector<int> recv_num_array;
 	extern std::vector<double> recv_spin_data_array;
 
+	extern int halo_encoding; ///< Encoding of halo spins (0 = double, 1 = single, 2 = 16-bit angles, 3 = 32-bit angles)
+	extern std::vector<float> send_spin_data_array_sp; ///< Single precision halo buffers
+	extern std::vector<float> recv_spin_data_array_sp;
+	extern std::vector<unsigned short> send_spin_angle_array_16; ///< Halo buffers for 16-bit spin angles
+	extern std::vector<unsigned short> recv_spin_angle_array_16;
+	extern std::vector<unsigned int> send_spin_angle_array_32; ///< Halo buffers for 32-bit spin angles
+	extern std::vector<unsigned int> recv_spin_angle_array_32;
+
 	#ifdef MPICF
-		extern std::vector<MPI::Request> requests;
-		extern std::vector<MPI::Status> stati;
+		extern std::vector<MPI_Request> requests; ///< Persistent halo swap requests (created once in init_mpi_comms)
+		extern std::vector<MPI_Status> stati;
+		extern MPI_Comm statistics_communicator(); ///< Communicator for reductions of statistics over atoms
 	#endif
 
 	//functions declarations
@@ -92,9 +106,18 @@ namespace vmpi{
 	extern int geometric_decomposition(int, double []);
 	extern int crystal_xyz(std::vector<cs::catom_t> &);
 	extern int copy_halo_atoms(std::vector<cs::catom_t> &);
-	extern int set_replicated_data(std::vector<cs::catom_t> &);
 	extern int identify_boundary_atoms(std::vector<cs::catom_t> &, std::vector<std::vector <cs::neighbour_t> > &);
 	extern int init_mpi_comms(std::vector<cs::catom_t> & catom_array);
+	extern void init_halo_swap_requests();
+	extern void free_halo_swap_requests();
+	extern void load_balance_decomposition(std::vector<cs::catom_t> &);
+	extern void slab_decomposition(int, double []);
+	extern void recursive_bisection_decomposition(std::vector<cs::catom_t> &);
+	extern void replicated_data_decomposition(std::vector<cs::catom_t> &);
+	extern void save_load_balance_data();
+	extern void statistical_range(const int, int&, int&);
+	extern std::string output_file_name();
+	extern void collate_statistical_output();
 	extern double SwapTimer(double, double&);
 
 	// wrapper functions avoiding MPI library
@@ -154,6 +154,7 @@ int create(){
 	// Set up Parallel Decomposition if required
 	#ifdef MPICF
 		if(vmpi::mpi_mode==0) vmpi::geometric_decomposition(vmpi::num_processors,cs::system_dimensions);
+		else if(vmpi::mpi_mode==1 || vmpi::mpi_mode==3) vmpi::slab_decomposition(vmpi::num_processors,cs::system_dimensions);
 	#endif
 
 	//      Initialise variables for system creation
@@ -161,49 +162,6 @@ int create(){
 		// read_coord_file();
 	}
 
-	#ifdef MPICF
-	// check for staged replicated data generation
-	if(vmpi::replicated_data_staged==true && vmpi::mpi_mode==1){
-
-		// copy ppn to constant temporary
-		const int ppn=vmpi::ppn;
-
-		for(int n=0;n<ppn;n++){
-			bool i_am_it=false;
-			if(vmpi::my_rank%ppn==n) i_am_it=true;
-
-			// Only generate system if I am it
-			if(i_am_it){
-
-				zlog << zTs() << "Generating staged system on rank " << vmpi::my_rank << "..." << std::endl;
-				//std::cerr << zTs() << "Generating staged system on rank " << vmpi::my_rank << "..." << std::endl;
-
-				// Create block of crystal of desired size
-				cs::create_crystal_structure(catom_array);
-
-				// Cut system to the correct type, species etc
-				cs::create_system_type(catom_array);
-
-				vmpi::set_replicated_data(catom_array);
-
-				// Create Neighbour list for system
-				cs::create_neighbourlist(catom_array,cneighbourlist);
-
-				// Identify needed atoms and destroy the rest
-				vmpi::identify_boundary_atoms(catom_array,cneighbourlist);
-
-				zlog << zTs() << "Staged system generation on rank " << vmpi::my_rank << " completed." << std::endl;
-				//std::cerr << zTs() << "Staged system generation on rank " << vmpi::my_rank << " completed." << std::endl;
-			}
-
-			// Wait for process who is it
-			MPI::COMM_WORLD.Barrier();
-
-		} // end of loop over processes
-	}
-	else{
-	#endif
-
 	// Create block of crystal of desired size
 	cs::create_crystal_structure(catom_array);
 
@@ -213,12 +171,25 @@ int create(){
 	// Copy atoms for interprocessor communications
 	#ifdef MPICF
 	if(vmpi::mpi_mode==0){
+		// Move partition planes to balance cost between processors
+		if(vmpi::load_balance) vmpi::load_balance_decomposition(catom_array);
+		MPI::COMM_WORLD.Barrier(); // wait for everyone
+		vmpi::copy_halo_atoms(catom_array);
+		MPI::COMM_WORLD.Barrier(); // sync after halo atoms copied
+	}
+	else if(vmpi::mpi_mode==3){
+		// Split system by recursive bisection and reuse halo machinery
+		vmpi::recursive_bisection_decomposition(catom_array);
 		MPI::COMM_WORLD.Barrier(); // wait for everyone
 		vmpi::copy_halo_atoms(catom_array);
 		MPI::COMM_WORLD.Barrier(); // sync after halo atoms copied
 	}
 	else if(vmpi::mpi_mode==1){
-		vmpi::set_replicated_data(catom_array);
+		// Balance slabs by atom number and reuse halo machinery
+		vmpi::replicated_data_decomposition(catom_array);
+		MPI::COMM_WORLD.Barrier(); // wait for everyone
+		vmpi::copy_halo_atoms(catom_array);
+		MPI::COMM_WORLD.Barrier(); // sync after halo atoms copied
 	}
 	#else
 		//cs::copy_periodic_boundaries(catom_array);
@@ -233,52 +204,16 @@ int create(){
 
 
 	#ifdef MPICF
-	} // stop if for staged generation here
-	// ** Must be done in parallel **
 		vmpi::init_mpi_comms(catom_array);
 		MPI::COMM_WORLD.Barrier();
 	#endif
 
 	// Set atom variables for simulation
-	#ifdef MPICF
-	// check for staged replicated data generation
-	if(vmpi::replicated_data_staged==true && vmpi::mpi_mode==1){
-
-		// copy ppn to constant temporary
-		const int ppn=vmpi::ppn;
-
-		for(int n=0;n<ppn;n++){
-			bool i_am_it=false;
-			if(vmpi::my_rank%ppn==n) i_am_it=true;
-
-			// Only generate system if I am it
-			if(i_am_it){
-
-				zlog << zTs() << "Copying system data to optimised data structures on rank " << vmpi::my_rank << "..." << std::endl;
-				//std::cerr << zTs() << "Copying system data to optimised data structures on rank " << vmpi::my_rank << "..." << std::endl;
-				cs::set_atom_vars(catom_array,cneighbourlist);
-				zlog << zTs() << "Copying on rank " << vmpi::my_rank << " completed." << std::endl;
-				//std::cerr << zTs() << "Copying on rank " << vmpi::my_rank << " completed." << std::endl;
-			}
-
-			// Wait for process who is it
-			MPI::COMM_WORLD.Barrier();
-
-		} // end of loop over processes
-	}
-	else{
-	#endif
-
-	// Print informative message
 	std::cout << "Copying system data to optimised data structures." << std::endl;
 	zlog << zTs() << "Copying system data to optimised data structures." << std::endl;
 
 	cs::set_atom_vars(catom_array,cneighbourlist);
 
-	#ifdef MPICF
-	} // stop if for staged generation here
-	#endif
-
 	// Set grain and cell variables for simulation
 	grains::set_properties();
 	cells::initialise();
@@ -317,7 +252,7 @@ int create(){
 		//vmpi::crystal_xyz(catom_array);
 	int my_num_atoms=vmpi::num_core_atoms+vmpi::num_bdry_atoms;
 	int total_num_atoms=0;
-	MPI::COMM_WORLD.Reduce(&my_num_atoms,&total_num_atoms, 1,MPI_INT, MPI_SUM, 0 );
+	MPI_Reduce(&my_num_atoms,&total_num_atoms, 1,MPI_INT, MPI_SUM, 0, vmpi::statistics_communicator());
 	std::cout << "Total number of atoms (all CPUs): " << total_num_atoms << std::endl;
    zlog << zTs() << "Total number of atoms (all CPUs): " << total_num_atoms << std::endl;
 	#else
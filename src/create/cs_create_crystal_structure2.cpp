@@ -51,7 +51,7 @@ int create_crystal_structure(std::vector<cs::catom_t> & catom_array){
 	int max_bounds[3];
 
 	#ifdef MPICF
-	if(vmpi::mpi_mode==0){
+	if(vmpi::mpi_mode!=2){
 		min_bounds[0] = int(vmpi::min_dimensions[0]/unit_cell.dimensions[0]);
 		min_bounds[1] = int(vmpi::min_dimensions[1]/unit_cell.dimensions[1]);
 		min_bounds[2] = int(vmpi::min_dimensions[2]/unit_cell.dimensions[2]);
@@ -107,7 +107,7 @@ int create_crystal_structure(std::vector<cs::catom_t> & catom_array){
 					double cy = (double(y)+unit_cell.atom[uca].y)*unit_cell.dimensions[1]+cff;
 					double cz = (double(z)+unit_cell.atom[uca].z)*unit_cell.dimensions[2]+cff;
 					#ifdef MPICF
-						if(vmpi::mpi_mode==0){
+						if(vmpi::mpi_mode!=2){
 							// only generate atoms within allowed dimensions
                      if(   (cx>=vmpi::min_dimensions[0] && cx<vmpi::max_dimensions[0]) &&
                            (cy>=vmpi::min_dimensions[1] && cy<vmpi::max_dimensions[1]) &&
@@ -61,6 +61,8 @@
 #include <iostream>
 #include <limits>
 
+#include <stdint.h>
+
 
 
 namespace cs{
@@ -253,42 +255,45 @@ int create_neighbourlist(std::vector<cs::catom_t> & catom_array, std::vector<std
          double vy=0.0;
          double vz=0.0;
 
+         // Parallel periodic boundaries are handled by halo atoms, except in statistical
+         // parallel mode where every processor holds the complete system
          #ifdef MPICF
-           // Parallel periodic boundaries are handled explicitly elsewhere
-         #else
-         // Wrap around for periodic boundaries
-         // Consider virtual atom position for position vector
-         if(cs::pbc[0]==true){
-            if(nx>=int(d[0])){
-               nx=nx-d[0];
-               vx=vx+d[0]*ucdx;
-            }
-            else if(nx<0){
-               nx=nx+d[0];
-               vx=vx-d[0]*ucdx;
-            }
-         }
-         if(cs::pbc[1]==true){
-            if(ny>=int(d[1])){
-               ny=ny-d[1];
-               vy=vy+d[1]*ucdy;
-            }
-            else if(ny<0){
-               ny=ny+d[1];
-               vy=vy-d[1]*ucdy;
+         if(vmpi::mpi_mode==2)
+         #endif
+         {
+            // Wrap around for periodic boundaries
+            // Consider virtual atom position for position vector
+            if(cs::pbc[0]==true){
+               if(nx>=int(d[0])){
+                  nx=nx-d[0];
+                  vx=vx+d[0]*ucdx;
+               }
+               else if(nx<0){
+                  nx=nx+d[0];
+                  vx=vx-d[0]*ucdx;
+               }
             }
-         }
-         if(cs::pbc[2]==true){
-            if(nz>=int(d[2])){
-               nz=nz-d[2];
-               vz=vz+d[2]*ucdz;
+            if(cs::pbc[1]==true){
+               if(ny>=int(d[1])){
+                  ny=ny-d[1];
+                  vy=vy+d[1]*ucdy;
+               }
+               else if(ny<0){
+                  ny=ny+d[1];
+                  vy=vy-d[1]*ucdy;
+               }
             }
-            else if(nz<0){
-               nz=nz+d[2];
-               vz=vz-d[2]*ucdz;
+            if(cs::pbc[2]==true){
+               if(nz>=int(d[2])){
+                  nz=nz-d[2];
+                  vz=vz+d[2]*ucdz;
+               }
+               else if(nz<0){
+                  nz=nz+d[2];
+                  vz=vz-d[2]*ucdz;
+               }
             }
          }
-         #endif
          // check for out-of-bounds access
          if((nx>=0 && static_cast<unsigned int>(nx)<d[0]) &&
             (ny>=0 && static_cast<unsigned int>(ny)<d[1]) &&
@@ -346,6 +351,11 @@ int create_neighbourlist(std::vector<cs::catom_t> & catom_array, std::vector<std
 	}
    zlog << zTs() << "\tDone"<< std::endl;
 
+   // Log number of interactions for comparison between serial and parallel runs
+   uint64_t num_interactions=0;
+   for(unsigned int atom=0;atom<cneighbourlist.size();atom++) num_interactions+=cneighbourlist[atom].size();
+   zlog << zTs() << "Number of neighbour interactions on this processor: " << num_interactions << std::endl;
+
 	// Deallocate supercell array
    zlog << zTs() << "Deallocating supercell array for neighbour list calculation" << std::endl;
 	for(unsigned int i=0; i<d[0] ; i++){
@@ -29,6 +29,7 @@
 //======================================================================
 
 // C++ standard library headers
+#include <algorithm>
 #include <string>
 #include <iostream>
 #include <cmath>
@@ -45,6 +46,7 @@
 #include "unitcell.hpp"
 #include "vio.hpp"
 #include "vmath.hpp"
+#include "vmpi.hpp"
 
 // Internal create header
 #include "internal.hpp"
@@ -137,8 +139,9 @@ int create_system_type(std::vector<cs::catom_t> & catom_array){
 		// Calculate final atomic composition
 		calculate_atomic_composition(catom_array);
 
-		// Check for zero atoms generated
-		if(catom_array.size()==0){
+		// Check for zero atoms generated (empty domains are allowed before load balancing)
+		const bool empty_domain_allowed = ((vmpi::mpi_mode==0 && vmpi::load_balance==true) || vmpi::mpi_mode==1 || vmpi::mpi_mode==3);
+		if(catom_array.size()==0 && empty_domain_allowed==false){
 			terminaltextcolor(RED);
 			std::cerr << "Error, no atoms generated for requested system shape - increase system dimensions or reduce particle size!" << std::endl;
 			terminaltextcolor(WHITE);
@@ -274,6 +277,14 @@ int particle_array(std::vector<cs::catom_t> & catom_array){
 	int num_x_particle = vmath::iceil(cs::system_dimensions[0]/repeat_size);
 	int num_y_particle = vmath::iceil(cs::system_dimensions[1]/repeat_size);
 
+	// Maximum extent of a particle from its origin, used to skip particles outside the local domain
+	const double particle_extent = cs::particle_scale*std::max(std::max(1.0,cs::particle_shape_factor_x),
+	                                                           std::max(cs::particle_shape_factor_y,cs::particle_shape_factor_z))
+	                             + std::max(unit_cell.dimensions[0],unit_cell.dimensions[1]);
+	const double facet_extent = cs::particle_scale*std::max(create::internal::faceted_particle_100_radius,
+	                                                        std::max(create::internal::faceted_particle_110_radius,create::internal::faceted_particle_111_radius));
+	const double extent = std::max(particle_extent,facet_extent);
+
 	// Loop to generate cubic lattice points
 	int particle_number=0;
 
@@ -296,8 +307,13 @@ int particle_array(std::vector<cs::catom_t> & catom_array){
 			if((particle_origin[0]<=(cs::system_dimensions[0]-cs::particle_scale*0.5)) &&
 				(particle_origin[1]<=(cs::system_dimensions[1]-cs::particle_scale*0.5))){
 
+				// Only cut particles overlapping the local domain
+				const double pmin[2] = {particle_origin[0]-extent, particle_origin[1]-extent};
+				const double pmax[2] = {particle_origin[0]+extent, particle_origin[1]+extent};
+				const bool local = (cs::system_creation_flags[1]==0 || create::internal::in_local_region(pmin,pmax));
+
 				// Use particle type flags to determine which particle shape to cut
-				switch(cs::system_creation_flags[1]){
+				if(local) switch(cs::system_creation_flags[1]){
 					case 0: // Bulk
 						bulk(catom_array);
 						break;
@@ -975,3 +991,38 @@ void fill(std::vector<cs::catom_t> & catom_array){
 }
 
 } // end of namespace
+
+namespace create{
+namespace internal{
+
+//-----------------------------------------------------------
+//
+///  Function to determine if a rectangle in the x-y plane
+///  overlaps the domain of atoms generated on this process,
+///  so that particles and grains with no local atoms can be
+///  skipped when cutting the system shape.
+//
+///  (c) R F L Evans
+//
+//-----------------------------------------------------------
+bool in_local_region(const double min[2], const double max[2]){
+
+   #ifdef MPICF
+      // every process generates the complete system in statistical parallel mode
+      if(vmpi::mpi_mode==2) return true;
+
+      for(int i=0; i<2; i++){
+         if(max[i] < vmpi::min_dimensions[i] || min[i] > vmpi::max_dimensions[i]) return false;
+      }
+   #else
+      // serial process owns the whole system
+      (void)min;
+      (void)max;
+   #endif
+
+   return true;
+
+}
+
+} // end of internal namespace
+} // end of create namespace
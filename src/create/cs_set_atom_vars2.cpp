@@ -77,6 +77,7 @@ int set_atom_vars(std::vector<cs::catom_t> & catom_array, std::vector<std::vecto
 	atoms::category_array.resize(atoms::num_atoms,0);
 	atoms::grain_array.resize(atoms::num_atoms,0);
 	atoms::cell_array.resize(atoms::num_atoms,0);
+	atoms::global_id_array.resize(atoms::num_atoms,0);
 
 	atoms::x_total_spin_field_array.resize(atoms::num_atoms,0.0);
 	atoms::y_total_spin_field_array.resize(atoms::num_atoms,0.0);
@@ -103,6 +104,15 @@ int set_atom_vars(std::vector<cs::catom_t> & catom_array, std::vector<std::vecto
 		//std::cout << atom << " grain: " << catom_array[atom].grain << std::endl;
 		atoms::grain_array[atom] = catom_array[atom].grain;
 
+		// set global atom id from unit cell position (halo atoms take the id of their periodic image)
+		const int64_t nx = cs::total_num_unit_cells[0];
+		const int64_t ny = cs::total_num_unit_cells[1];
+		const int64_t nz = cs::total_num_unit_cells[2];
+		const int64_t scx = ((catom_array[atom].scx % nx) + nx) % nx;
+		const int64_t scy = ((catom_array[atom].scy % ny) + ny) % ny;
+		const int64_t scz = ((catom_array[atom].scz % nz) + nz) % nz;
+		atoms::global_id_array[atom] = ((scz*ny + scy)*nx + scx)*int64_t(cs::unit_cell.atom.size()) + catom_array[atom].uc_id;
+
 		// initialise atomic spin positions
       // Use a normalised gaussian for uniform distribution on a unit sphere
 		int mat=atoms::type_array[atom];
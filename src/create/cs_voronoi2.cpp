@@ -32,6 +32,9 @@
 #include "vio.hpp"
 #include "qvoronoi.hpp"
 
+// Internal create header
+#include "internal.hpp"
+
 #include <cmath>
 #include <list>
 #include <iostream>
@@ -386,6 +389,11 @@ int voronoi_film(std::vector<cs::catom_t> & catom_array){
 				if(y > maxy) maxy = y;
 			}
 
+			// skip grains with no atoms in the local domain
+			const double gmin[2] = {double(minx)*unit_cell.dimensions[0], double(miny)*unit_cell.dimensions[1]};
+			const double gmax[2] = {double(maxx+1)*unit_cell.dimensions[0], double(maxy+1)*unit_cell.dimensions[1]};
+			if(create::internal::in_local_region(gmin,gmax)==false) continue;
+
 			// determine coordinate offset for grains
 			const double x0 = grain_coord_array[grain][0];
 			const double y0 = grain_coord_array[grain][1];
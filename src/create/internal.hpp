@@ -93,6 +93,7 @@ namespace create{
       //-----------------------------------------------------------------------------
       extern void alloy(std::vector<cs::catom_t> & catom_array);
       extern void faceted(double particle_origin[],std::vector<cs::catom_t> & catom_array, const int grain);
+      extern bool in_local_region(const double min[2], const double max[2]);
 
    } // end of internal namespace
 } // end of create namespace
@@ -60,6 +60,9 @@ namespace cells{
 
 	int num_cells=0;
 	int num_local_cells=0;
+	int num_cells_x=0;
+	int num_cells_y=0;
+	int num_cells_z=0;
    int num_atoms_in_unit_cell=0;
 	double size=7.0; // Angstroms
 
@@ -119,6 +122,9 @@ namespace cells{
 
 		//update total number of cells
 		cells::num_cells=ncellx*ncelly*ncellz;
+		cells::num_cells_x=ncellx;
+		cells::num_cells_y=ncelly;
+		cells::num_cells_z=ncellz;
 
 		zlog << zTs() << "Macrocells in x,y,z: " << ncellx << "\t" << ncelly << "\t" << ncellz << std::endl;
 		zlog << zTs() << "Total number of macrocells: " << cells::num_cells << std::endl;
@@ -241,11 +247,11 @@ namespace cells{
 
 		// For MPI sum coordinates from all CPUs
 		#ifdef MPICF
-			MPI::COMM_WORLD.Allreduce(MPI_IN_PLACE,&cells::num_atoms_in_cell[0],cells::num_cells,MPI_INT,MPI_SUM);
-			MPI::COMM_WORLD.Allreduce(MPI_IN_PLACE,&cells::x_coord_array[0],cells::num_cells,MPI_DOUBLE,MPI_SUM);
-			MPI::COMM_WORLD.Allreduce(MPI_IN_PLACE,&cells::y_coord_array[0],cells::num_cells,MPI_DOUBLE,MPI_SUM);
-			MPI::COMM_WORLD.Allreduce(MPI_IN_PLACE,&cells::z_coord_array[0],cells::num_cells,MPI_DOUBLE,MPI_SUM);
-         MPI::COMM_WORLD.Allreduce(MPI_IN_PLACE,&total_moment_array[0],cells::num_cells,MPI_DOUBLE,MPI_SUM);
+			MPI_Allreduce(MPI_IN_PLACE,&cells::num_atoms_in_cell[0],cells::num_cells,MPI_INT,MPI_SUM,vmpi::statistics_communicator());
+			MPI_Allreduce(MPI_IN_PLACE,&cells::x_coord_array[0],cells::num_cells,MPI_DOUBLE,MPI_SUM,vmpi::statistics_communicator());
+			MPI_Allreduce(MPI_IN_PLACE,&cells::y_coord_array[0],cells::num_cells,MPI_DOUBLE,MPI_SUM,vmpi::statistics_communicator());
+			MPI_Allreduce(MPI_IN_PLACE,&cells::z_coord_array[0],cells::num_cells,MPI_DOUBLE,MPI_SUM,vmpi::statistics_communicator());
+			MPI_Allreduce(MPI_IN_PLACE,&total_moment_array[0],cells::num_cells,MPI_DOUBLE,MPI_SUM,vmpi::statistics_communicator());
       #endif
 
 		//if(vmpi::my_rank==0){
@@ -354,9 +360,9 @@ int mag() {
 
 #ifdef MPICF
   // Reduce magnetisation on all nodes
-  MPI::COMM_WORLD.Allreduce(MPI_IN_PLACE,&cells::x_mag_array[0],cells::num_cells,MPI_DOUBLE,MPI_SUM);
-  MPI::COMM_WORLD.Allreduce(MPI_IN_PLACE,&cells::y_mag_array[0],cells::num_cells,MPI_DOUBLE,MPI_SUM);
-  MPI::COMM_WORLD.Allreduce(MPI_IN_PLACE,&cells::z_mag_array[0],cells::num_cells,MPI_DOUBLE,MPI_SUM);
+  MPI_Allreduce(MPI_IN_PLACE,&cells::x_mag_array[0],cells::num_cells,MPI_DOUBLE,MPI_SUM,vmpi::statistics_communicator());
+  MPI_Allreduce(MPI_IN_PLACE,&cells::y_mag_array[0],cells::num_cells,MPI_DOUBLE,MPI_SUM,vmpi::statistics_communicator());
+  MPI_Allreduce(MPI_IN_PLACE,&cells::z_mag_array[0],cells::num_cells,MPI_DOUBLE,MPI_SUM,vmpi::statistics_communicator());
 #endif
 
   return EXIT_SUCCESS;
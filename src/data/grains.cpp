@@ -29,6 +29,7 @@
 #include "vmpi.hpp"
 #include "vio.hpp"
 
+#include <algorithm>
 #include <cmath>
 #include <iostream>
 
@@ -36,6 +37,7 @@ namespace grains{
 
 	int num_grains=1; // always assume 1 grain
 	bool random_anisotropy = false; // flag to control randomly oriented uniaxial anisotropy
+	bool calculate_material_magnetisation = false; // flag to calculate magnetisation of each material in each grain
 
 	std::vector <int> grain_size_array(0);
 
@@ -132,12 +134,12 @@ int set_properties(){
 		//MPI::COMM_WORLD.Allreduce(&grains::y_coord_array[0], &grains::y_coord_array[0],grains::num_grains, MPI_INT,MPI_SUM);
 		//MPI::COMM_WORLD.Allreduce(&grains::z_coord_array[0], &grains::z_coord_array[0],grains::num_grains, MPI_INT,MPI_SUM);
 		//MPI::COMM_WORLD.Allreduce(&grains::sat_mag_array[0], &grains::sat_mag_array[0],grains::num_grains, MPI_INT,MPI_SUM);
-		MPI::COMM_WORLD.Allreduce(MPI_IN_PLACE, &grains::grain_size_array[0],grains::num_grains, MPI_INT,MPI_SUM);
-		MPI::COMM_WORLD.Allreduce(MPI_IN_PLACE, &grains::x_coord_array[0],grains::num_grains, MPI_DOUBLE,MPI_SUM);
-		MPI::COMM_WORLD.Allreduce(MPI_IN_PLACE, &grains::y_coord_array[0],grains::num_grains, MPI_DOUBLE,MPI_SUM);
-		MPI::COMM_WORLD.Allreduce(MPI_IN_PLACE, &grains::z_coord_array[0],grains::num_grains, MPI_DOUBLE,MPI_SUM);
-		MPI::COMM_WORLD.Allreduce(MPI_IN_PLACE, &grains::sat_mag_array[0],grains::num_grains, MPI_DOUBLE,MPI_SUM);
-		if(mp::num_materials>1) MPI::COMM_WORLD.Allreduce(MPI_IN_PLACE, &grains::mat_sat_mag_array[0],grains::num_grains*mp::num_materials, MPI_DOUBLE,MPI_SUM);
+		MPI_Allreduce(MPI_IN_PLACE, &grains::grain_size_array[0], grains::num_grains, MPI_INT, MPI_SUM, vmpi::statistics_communicator());
+		MPI_Allreduce(MPI_IN_PLACE, &grains::x_coord_array[0], grains::num_grains, MPI_DOUBLE, MPI_SUM, vmpi::statistics_communicator());
+		MPI_Allreduce(MPI_IN_PLACE, &grains::y_coord_array[0], grains::num_grains, MPI_DOUBLE, MPI_SUM, vmpi::statistics_communicator());
+		MPI_Allreduce(MPI_IN_PLACE, &grains::z_coord_array[0], grains::num_grains, MPI_DOUBLE, MPI_SUM, vmpi::statistics_communicator());
+		MPI_Allreduce(MPI_IN_PLACE, &grains::sat_mag_array[0], grains::num_grains, MPI_DOUBLE, MPI_SUM, vmpi::statistics_communicator());
+		if(mp::num_materials>1) MPI_Allreduce(MPI_IN_PLACE, &grains::mat_sat_mag_array[0], grains::num_grains*mp::num_materials, MPI_DOUBLE, MPI_SUM, vmpi::statistics_communicator());
 	#endif
 
 	//vinfo << "-------------------------------------------------------------------------------------------------------------------" << std::endl;
@@ -168,65 +170,98 @@ int mag(){
 	if(err::check==true){std::cout << "grains::mag has been called" << std::endl;}
 
 	#ifdef MPICF
-		const unsigned int num_local_atoms = vmpi::num_core_atoms+vmpi::num_bdry_atoms;
+		const int num_local_atoms = vmpi::num_core_atoms+vmpi::num_bdry_atoms;
 	#else
-		const unsigned int num_local_atoms = atoms::num_atoms;
+		const int num_local_atoms = atoms::num_atoms;
 	#endif
 
-	//initialise magnetisations
-	for(int grain=0;grain<grains::num_grains;grain++){
-		grains::x_mag_array[grain]=0.0;
-		grains::y_mag_array[grain]=0.0;
-		grains::z_mag_array[grain]=0.0;
-		grains::mag_m_array[grain]=0.0;
-		if(mp::num_materials>1){
-			// loop over materials
-			for(int mat=0;mat<mp::num_materials;mat++){
-				grains::x_mat_mag_array[grain*mp::num_materials+mat]=0.0;
-				grains::y_mat_mag_array[grain*mp::num_materials+mat]=0.0;
-				grains::z_mat_mag_array[grain*mp::num_materials+mat]=0.0;
-				grains::mat_mag_m_array[grain*mp::num_materials+mat]=0.0;
+	// material breakdown is only needed for grain material magnetisation output
+	const int num_materials = mp::num_materials;
+	const bool material_breakdown = (num_materials>1) && grains::calculate_material_magnetisation;
+
+	// packed sums of grain moments [grain][xyz] followed by material moments [grain][material][xyz]
+	const int ng = grains::num_grains;
+	const int nm = material_breakdown ? grains::num_grains*num_materials : 0;
+	const int buffer_size = 3*ng+3*nm;
+	std::vector<double> buffer(buffer_size,0.0);
+	double* const mag = &buffer[0];
+
+	// hoist material moments out of atom loop
+	std::vector<double> mu_s(num_materials);
+	for(int mat=0;mat<num_materials;mat++) mu_s[mat]=mp::material[mat].mu_s_SI;
+
+	const int* const grain_array = &atoms::grain_array[0];
+	const int* const type_array = &atoms::type_array[0];
+	const double* const sx = &atoms::x_spin_array[0];
+	const double* const sy = &atoms::y_spin_array[0];
+	const double* const sz = &atoms::z_spin_array[0];
+
+	// first atom found outside allowable grain range
+	int bad_atom=num_local_atoms;
+
+	// function to calculate grain magnetisations, each thread accumulating into a private
+	// partial array merged at the end
+	#pragma omp parallel
+	{
+		std::vector<double> partial(buffer_size,0.0);
+		int partial_bad_atom=num_local_atoms;
+		#pragma omp for nowait
+		for(int atom=0;atom<num_local_atoms;atom++){
+
+			const int grain = grain_array[atom];
+			const int mat = type_array[atom];
+
+			// check grain is within allowable bounds
+			if((grain>=0) && (grain<ng)){
+				const double mx = sx[atom]*mu_s[mat];
+				const double my = sy[atom]*mu_s[mat];
+				const double mz = sz[atom]*mu_s[mat];
+				partial[3*grain+0]+=mx;
+				partial[3*grain+1]+=my;
+				partial[3*grain+2]+=mz;
+				if(material_breakdown){
+					const int idx=3*ng+3*(grain*num_materials+mat);
+					partial[idx+0]+=mx;
+					partial[idx+1]+=my;
+					partial[idx+2]+=mz;
+				}
 			}
+			else partial_bad_atom=std::min(partial_bad_atom,atom);
+		}
+		#pragma omp critical
+		{
+			for(int i=0;i<buffer_size;i++) mag[i]+=partial[i];
+			bad_atom=std::min(bad_atom,partial_bad_atom);
 		}
 	}
 
-	// function to calculate grain magnetisations
-	for(unsigned int atom=0;atom< num_local_atoms;atom++){
-
-		const int grain = atoms::grain_array[atom];
-		const int mat = atoms::type_array[atom];
-
-		// check grain is within allowable bounds
-		if((grain>=0) && (grain<grains::num_grains)){
-			grains::x_mag_array[grain]+=(atoms::x_spin_array[atom]*mp::material[mat].mu_s_SI);
-			grains::y_mag_array[grain]+=(atoms::y_spin_array[atom]*mp::material[mat].mu_s_SI);
-			grains::z_mag_array[grain]+=(atoms::z_spin_array[atom]*mp::material[mat].mu_s_SI);
-			if(mp::num_materials>1){
-				grains::x_mat_mag_array[grain*mp::num_materials+mat]+=(atoms::x_spin_array[atom]*mp::material[mat].mu_s_SI);
-				grains::y_mat_mag_array[grain*mp::num_materials+mat]+=(atoms::y_spin_array[atom]*mp::material[mat].mu_s_SI);
-				grains::z_mat_mag_array[grain*mp::num_materials+mat]+=(atoms::z_spin_array[atom]*mp::material[mat].mu_s_SI);
-			}
-			
-		}
-		else{
-			terminaltextcolor(RED);
-			std::cerr << "Error - atom " << atom << " belongs to grain " << grain << " which is greater than maximum number of grains ";
-			std::cerr << grains::num_grains << ". Exiting" << std::endl;
-			terminaltextcolor(WHITE);
-			err::vexit();
-		}
+	if(bad_atom<num_local_atoms){
+		terminaltextcolor(RED);
+		std::cerr << "Error - atom " << bad_atom << " belongs to grain " << atoms::grain_array[bad_atom] << " which is greater than maximum number of grains ";
+		std::cerr << grains::num_grains << ". Exiting" << std::endl;
+		terminaltextcolor(WHITE);
+		err::vexit();
 	}
 
-	// Reduce grain properties on all CPUs
+	// Reduce grain properties on all CPUs in a single collective
 	#ifdef MPICF
-		MPI::COMM_WORLD.Allreduce(MPI_IN_PLACE, &grains::x_mag_array[0],grains::num_grains, MPI_DOUBLE,MPI_SUM);
-		MPI::COMM_WORLD.Allreduce(MPI_IN_PLACE, &grains::y_mag_array[0],grains::num_grains, MPI_DOUBLE,MPI_SUM);
-		MPI::COMM_WORLD.Allreduce(MPI_IN_PLACE, &grains::z_mag_array[0],grains::num_grains, MPI_DOUBLE,MPI_SUM);
-		if(mp::num_materials>1) MPI::COMM_WORLD.Allreduce(MPI_IN_PLACE, &grains::x_mat_mag_array[0],grains::num_grains*mp::num_materials, MPI_DOUBLE,MPI_SUM);
-		if(mp::num_materials>1) MPI::COMM_WORLD.Allreduce(MPI_IN_PLACE, &grains::y_mat_mag_array[0],grains::num_grains*mp::num_materials, MPI_DOUBLE,MPI_SUM);
-		if(mp::num_materials>1) MPI::COMM_WORLD.Allreduce(MPI_IN_PLACE, &grains::z_mat_mag_array[0],grains::num_grains*mp::num_materials, MPI_DOUBLE,MPI_SUM);
+		MPI_Allreduce(MPI_IN_PLACE, &buffer[0], buffer_size, MPI_DOUBLE, MPI_SUM, vmpi::statistics_communicator());
 	#endif
 
+	// unpack grain moments
+	for(int grain=0;grain<ng;grain++){
+		grains::x_mag_array[grain]=buffer[3*grain+0];
+		grains::y_mag_array[grain]=buffer[3*grain+1];
+		grains::z_mag_array[grain]=buffer[3*grain+2];
+		grains::mag_m_array[grain]=0.0;
+	}
+	for(int idx=0;idx<nm;idx++){
+		grains::x_mat_mag_array[idx]=buffer[3*ng+3*idx+0];
+		grains::y_mat_mag_array[idx]=buffer[3*ng+3*idx+1];
+		grains::z_mat_mag_array[idx]=buffer[3*ng+3*idx+2];
+		grains::mat_mag_m_array[idx]=0.0;
+	}
+
 	// calculate mag_m of each grain and normalised direction
 	for(int grain=0;grain<grains::num_grains;grain++){
 		// check for grains with zero atoms
@@ -244,7 +279,7 @@ int mag(){
 			grains::y_mag_array[grain]*=norm;
 			grains::z_mag_array[grain]*=norm;
 			// loop over all materials and normalise
-			if(mp::num_materials>1){
+			if(material_breakdown){
 				for(int mat=0;mat<mp::num_materials;mat++){
 					const unsigned int idx=grain*mp::num_materials+mat;
 					const double immm = grains::mat_sat_mag_array[idx] < 1.e-200 ? 1.0 : 1.0/grains::mat_sat_mag_array[idx];
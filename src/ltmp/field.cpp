@@ -90,4 +90,19 @@ namespace ltmp{
       return;
    }
 
+   //-----------------------------------------------------------------------------
+   // Function to get temperature of each local atom (Te or Tp as used for fields)
+   //-----------------------------------------------------------------------------
+   void get_local_temperatures(std::vector<double>& temperature, const int num_atoms){
+
+      const int num_local_atoms = std::min(num_atoms, ltmp::internal::num_local_atoms);
+
+      for(int atom=0; atom<num_local_atoms; ++atom){
+         const double rootT = ltmp::internal::root_temperature_array[ltmp::internal::atom_temperature_index[atom]];
+         temperature[atom] = rootT*rootT;
+      }
+
+      return;
+   }
+
 } // end of ltmp namespace
@@ -35,6 +35,10 @@
 
 #include "stopwatch.h"
 
+#ifdef _OPENMP
+   #include <omp.h>
+#endif
+
 int simulate_system();
 
 /// Main function for vampire
@@ -78,6 +82,12 @@ int main(int argc, char* argv[]){
    // Initialise log file
    vout::zLogTsInit(std::string(argv[0]));
 
+   // Determine number of threads per process for hybrid execution
+   #ifdef _OPENMP
+      vmpi::num_threads = omp_get_max_threads();
+      zlog << zTs() << "Number of OpenMP threads per process: " << vmpi::num_threads << std::endl;
+   #endif
+
    // Output Program Header
    if(vmpi::my_rank==0){
       std::cout << "                                                _          " << std::endl;
@@ -110,6 +120,9 @@ int main(int argc, char* argv[]){
       #ifdef MPICF
       std::cout << "MPI ";
       #endif
+      #ifdef _OPENMP
+      std::cout << "OpenMP ";
+      #endif
       std::cout << std::endl;
       std::cout << std::endl;
       std::cout << "  Vampire includes a copy of the qhull library from C.B. Barber and The "<< std::endl;
@@ -146,6 +159,12 @@ int main(int argc, char* argv[]){
    // Simulate system
    sim::run();
 
+   // Write any snapshots still queued for output
+   vout::finalize_asynchronous_output();
+
+   // Write index of trajectory file
+   vout::finalize_trajectory();
+
    // Finalise MPI
    #ifdef MPICF
       vmpi::finalise();
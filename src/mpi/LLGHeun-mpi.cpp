@@ -78,6 +78,7 @@ int LLG_Heun_mpi(){
 		// Store initial spin positions (all)
 		//----------------------------------------
 		
+		#pragma omp parallel for
 		for(int atom=pre_comm_si;atom<post_comm_ei;atom++){
 			x_initial_spin_array[atom] = atoms::x_spin_array[atom];
 			y_initial_spin_array[atom] = atoms::y_spin_array[atom];
@@ -92,53 +93,58 @@ int LLG_Heun_mpi(){
 		calculate_external_fields(pre_comm_si,pre_comm_ei);
 
 		//----------------------------------------
-		// Calculate Euler Step (Core)
+		// Calculate Euler Step (Core) and complete halo swap
 		//----------------------------------------	
 		
-		for(int atom=pre_comm_si;atom<pre_comm_ei;atom++){
-
-			const int imaterial=atoms::type_array[atom];
-			const double one_oneplusalpha_sq = material_parameters::material[imaterial].one_oneplusalpha_sq;
-			const double alpha_oneplusalpha_sq = material_parameters::material[imaterial].alpha_oneplusalpha_sq;
-
-			// Store local spin in Sand local field in H
-			const double S[3] = {atoms::x_spin_array[atom],atoms::y_spin_array[atom],atoms::z_spin_array[atom]};
-			const double H[3] = {atoms::x_total_spin_field_array[atom]+atoms::x_total_external_field_array[atom],
-										atoms::y_total_spin_field_array[atom]+atoms::y_total_external_field_array[atom],
-										atoms::z_total_spin_field_array[atom]+atoms::z_total_external_field_array[atom]};
-
-			// Calculate Delta S
-			xyz[0]=(one_oneplusalpha_sq)*(S[1]*H[2]-S[2]*H[1]) + (alpha_oneplusalpha_sq)*(S[1]*(S[0]*H[1]-S[1]*H[0])-S[2]*(S[2]*H[0]-S[0]*H[2]));
-			xyz[1]=(one_oneplusalpha_sq)*(S[2]*H[0]-S[0]*H[2]) + (alpha_oneplusalpha_sq)*(S[2]*(S[1]*H[2]-S[2]*H[1])-S[0]*(S[0]*H[1]-S[1]*H[0]));
-			xyz[2]=(one_oneplusalpha_sq)*(S[0]*H[1]-S[1]*H[0]) + (alpha_oneplusalpha_sq)*(S[0]*(S[2]*H[0]-S[0]*H[2])-S[1]*(S[1]*H[2]-S[2]*H[1]));
-
-			// Store dS in euler array
-			x_euler_array[atom]=xyz[0];
-			y_euler_array[atom]=xyz[1];
-			z_euler_array[atom]=xyz[2];
-
-			// Calculate Euler Step
-			S_new[0]=S[0]+xyz[0]*material_parameters::dt;
-			S_new[1]=S[1]+xyz[1]*material_parameters::dt;
-			S_new[2]=S[2]+xyz[2]*material_parameters::dt;
+		#pragma omp parallel private(xyz,S_new,mod_S)
+		{
+			// Master thread completes the halo swap (MPI calls are funnelled) while
+			// the other threads update core atoms, which have no halo neighbours.
+			// Dynamic scheduling lets the master join in once the swap is done.
+			#pragma omp master
+			mpi_complete_halo_swap();
+
+			#pragma omp for schedule(dynamic,256)
+			for(int atom=pre_comm_si;atom<pre_comm_ei;atom++){
+
+				const int imaterial=atoms::type_array[atom];
+				const double one_oneplusalpha_sq = material_parameters::material[imaterial].one_oneplusalpha_sq;
+				const double alpha_oneplusalpha_sq = material_parameters::material[imaterial].alpha_oneplusalpha_sq;
+
+				// Store local spin in Sand local field in H
+				const double S[3] = {atoms::x_spin_array[atom],atoms::y_spin_array[atom],atoms::z_spin_array[atom]};
+				const double H[3] = {atoms::x_total_spin_field_array[atom]+atoms::x_total_external_field_array[atom],
+											atoms::y_total_spin_field_array[atom]+atoms::y_total_external_field_array[atom],
+											atoms::z_total_spin_field_array[atom]+atoms::z_total_external_field_array[atom]};
+
+				// Calculate Delta S
+				xyz[0]=(one_oneplusalpha_sq)*(S[1]*H[2]-S[2]*H[1]) + (alpha_oneplusalpha_sq)*(S[1]*(S[0]*H[1]-S[1]*H[0])-S[2]*(S[2]*H[0]-S[0]*H[2]));
+				xyz[1]=(one_oneplusalpha_sq)*(S[2]*H[0]-S[0]*H[2]) + (alpha_oneplusalpha_sq)*(S[2]*(S[1]*H[2]-S[2]*H[1])-S[0]*(S[0]*H[1]-S[1]*H[0]));
+				xyz[2]=(one_oneplusalpha_sq)*(S[0]*H[1]-S[1]*H[0]) + (alpha_oneplusalpha_sq)*(S[0]*(S[2]*H[0]-S[0]*H[2])-S[1]*(S[1]*H[2]-S[2]*H[1]));
+
+				// Store dS in euler array
+				x_euler_array[atom]=xyz[0];
+				y_euler_array[atom]=xyz[1];
+				z_euler_array[atom]=xyz[2];
+
+				// Calculate Euler Step
+				S_new[0]=S[0]+xyz[0]*material_parameters::dt;
+				S_new[1]=S[1]+xyz[1]*material_parameters::dt;
+				S_new[2]=S[2]+xyz[2]*material_parameters::dt;
 			
-			// Normalise Spin Length
-			mod_S = 1.0/sqrt(S_new[0]*S_new[0] + S_new[1]*S_new[1] + S_new[2]*S_new[2]);
+				// Normalise Spin Length
+				mod_S = 1.0/sqrt(S_new[0]*S_new[0] + S_new[1]*S_new[1] + S_new[2]*S_new[2]);
 			
-			S_new[0]=S_new[0]*mod_S;
-			S_new[1]=S_new[1]*mod_S;
-			S_new[2]=S_new[2]*mod_S;
-
-			//Writing of Spin Values to Storage Array
-			x_spin_storage_array[atom]=S_new[0];
-			y_spin_storage_array[atom]=S_new[1];
-			z_spin_storage_array[atom]=S_new[2];		
+				S_new[0]=S_new[0]*mod_S;
+				S_new[1]=S_new[1]*mod_S;
+				S_new[2]=S_new[2]*mod_S;
+
+				//Writing of Spin Values to Storage Array
+				x_spin_storage_array[atom]=S_new[0];
+				y_spin_storage_array[atom]=S_new[1];
+				z_spin_storage_array[atom]=S_new[2];		
+			}
 		}
-		
-		//----------------------------------------
-		// Complete halo swap
-		//----------------------------------------
-		mpi_complete_halo_swap();
 
 		//----------------------------------------
 		// Calculate fields (boundary)
@@ -151,6 +157,7 @@ int LLG_Heun_mpi(){
 		// Calculate Euler Step (boundary)
 		//----------------------------------------	
 		
+		#pragma omp parallel for private(xyz,S_new,mod_S)
 		for(int atom=post_comm_si;atom<post_comm_ei;atom++){
 
 			const int imaterial=atoms::type_array[atom];
@@ -194,6 +201,7 @@ int LLG_Heun_mpi(){
 		//----------------------------------------
 		// Copy new spins to spin array (all)
 		//----------------------------------------
+		#pragma omp parallel for
 		for(int atom=pre_comm_si;atom<post_comm_ei;atom++){
 			atoms::x_spin_array[atom]=x_spin_storage_array[atom];
 			atoms::y_spin_array[atom]=y_spin_storage_array[atom];
@@ -212,37 +220,40 @@ int LLG_Heun_mpi(){
 		calculate_spin_fields(pre_comm_si,pre_comm_ei);
 
 		//----------------------------------------
-		// Calculate Heun Gradients (core)
+		// Calculate Heun Gradients (core) and complete second halo swap
 		//----------------------------------------	
 		
-		for(int atom=pre_comm_si;atom<pre_comm_ei;atom++){
-
-			const int imaterial=atoms::type_array[atom];;
-			const double one_oneplusalpha_sq = material_parameters::material[imaterial].one_oneplusalpha_sq;
-			const double alpha_oneplusalpha_sq = material_parameters::material[imaterial].alpha_oneplusalpha_sq;
-
-			// Store local spin in Sand local field in H
-			const double S[3] = {atoms::x_spin_array[atom],atoms::y_spin_array[atom],atoms::z_spin_array[atom]};
-			const double H[3] = {atoms::x_total_spin_field_array[atom]+atoms::x_total_external_field_array[atom],
-										atoms::y_total_spin_field_array[atom]+atoms::y_total_external_field_array[atom],
-										atoms::z_total_spin_field_array[atom]+atoms::z_total_external_field_array[atom]};
-
-			// Calculate Delta S
-			xyz[0]=(one_oneplusalpha_sq)*(S[1]*H[2]-S[2]*H[1]) + (alpha_oneplusalpha_sq)*(S[1]*(S[0]*H[1]-S[1]*H[0])-S[2]*(S[2]*H[0]-S[0]*H[2]));
-			xyz[1]=(one_oneplusalpha_sq)*(S[2]*H[0]-S[0]*H[2]) + (alpha_oneplusalpha_sq)*(S[2]*(S[1]*H[2]-S[2]*H[1])-S[0]*(S[0]*H[1]-S[1]*H[0]));
-			xyz[2]=(one_oneplusalpha_sq)*(S[0]*H[1]-S[1]*H[0]) + (alpha_oneplusalpha_sq)*(S[0]*(S[2]*H[0]-S[0]*H[2])-S[1]*(S[1]*H[2]-S[2]*H[1]));
-
-			// Store dS in heun array
-			x_heun_array[atom]=xyz[0];
-			y_heun_array[atom]=xyz[1];
-			z_heun_array[atom]=xyz[2];
+		#pragma omp parallel private(xyz)
+		{
+			// Master thread completes the halo swap (MPI calls are funnelled)
+			#pragma omp master
+			mpi_complete_halo_swap();
+
+			#pragma omp for schedule(dynamic,256)
+			for(int atom=pre_comm_si;atom<pre_comm_ei;atom++){
+
+				const int imaterial=atoms::type_array[atom];;
+				const double one_oneplusalpha_sq = material_parameters::material[imaterial].one_oneplusalpha_sq;
+				const double alpha_oneplusalpha_sq = material_parameters::material[imaterial].alpha_oneplusalpha_sq;
+
+				// Store local spin in Sand local field in H
+				const double S[3] = {atoms::x_spin_array[atom],atoms::y_spin_array[atom],atoms::z_spin_array[atom]};
+				const double H[3] = {atoms::x_total_spin_field_array[atom]+atoms::x_total_external_field_array[atom],
+											atoms::y_total_spin_field_array[atom]+atoms::y_total_external_field_array[atom],
+											atoms::z_total_spin_field_array[atom]+atoms::z_total_external_field_array[atom]};
+
+				// Calculate Delta S
+				xyz[0]=(one_oneplusalpha_sq)*(S[1]*H[2]-S[2]*H[1]) + (alpha_oneplusalpha_sq)*(S[1]*(S[0]*H[1]-S[1]*H[0])-S[2]*(S[2]*H[0]-S[0]*H[2]));
+				xyz[1]=(one_oneplusalpha_sq)*(S[2]*H[0]-S[0]*H[2]) + (alpha_oneplusalpha_sq)*(S[2]*(S[1]*H[2]-S[2]*H[1])-S[0]*(S[0]*H[1]-S[1]*H[0]));
+				xyz[2]=(one_oneplusalpha_sq)*(S[0]*H[1]-S[1]*H[0]) + (alpha_oneplusalpha_sq)*(S[0]*(S[2]*H[0]-S[0]*H[2])-S[1]*(S[1]*H[2]-S[2]*H[1]));
+
+				// Store dS in heun array
+				x_heun_array[atom]=xyz[0];
+				y_heun_array[atom]=xyz[1];
+				z_heun_array[atom]=xyz[2];
+			}
 		}
 
-		//------------------------------------------
-		// Complete second halo swap
-		//------------------------------------------
-		mpi_complete_halo_swap();
-
 		//------------------------------------------
 		// Recalculate spin dependent fields (boundary)
 		//------------------------------------------
@@ -253,6 +264,7 @@ int LLG_Heun_mpi(){
 		// Calculate Heun Gradients (boundary)
 		//----------------------------------------	
 		
+		#pragma omp parallel for private(xyz)
 		for(int atom=post_comm_si;atom<post_comm_ei;atom++){
 
 			const int imaterial=atoms::type_array[atom];;
@@ -280,6 +292,7 @@ int LLG_Heun_mpi(){
 		// Calculate Heun Step
 		//----------------------------------------	
 
+		#pragma omp parallel for private(S_new,mod_S)
 		for(int atom=pre_comm_si;atom<post_comm_ei;atom++){
 			S_new[0]=x_initial_spin_array[atom]+material_parameters::half_dt*(x_euler_array[atom]+x_heun_array[atom]);
 			S_new[1]=y_initial_spin_array[atom]+material_parameters::half_dt*(y_euler_array[atom]+y_heun_array[atom]);
@@ -62,6 +62,7 @@ int LLG_Midpoint_mpi(){
 	mpi_init_halo_swap();
 
 	// Store initial spin positions (all)	
+	#pragma omp parallel for
 	for(int atom=pre_comm_si;atom<post_comm_ei;atom++){
 		x_initial_spin_array[atom] = atoms::x_spin_array[atom];
 		y_initial_spin_array[atom] = atoms::y_spin_array[atom];
@@ -72,46 +73,54 @@ int LLG_Midpoint_mpi(){
 	calculate_spin_fields(pre_comm_si,pre_comm_ei);
 	calculate_external_fields(pre_comm_si,pre_comm_ei);
 
-	// Calculate Predictor Step (Core)
-	for(int atom=pre_comm_si;atom<pre_comm_ei;atom++){
+	// Calculate Predictor Step (core) and complete halo swap
+	#pragma omp parallel
+	{
+		// Master thread completes the halo swap (MPI calls are funnelled) while
+		// the other threads update core atoms, which have no halo neighbours.
+		// Dynamic scheduling lets the master join in once the swap is done.
+		#pragma omp master
+		mpi_complete_halo_swap();
 
-		const int imaterial=atoms::type_array[atom];
-		const double alpha = mp::material[imaterial].alpha;
-		const double beta  = -1.0*mp::dt*mp::material[imaterial].one_oneplusalpha_sq*0.5;
-		const double beta2 = beta*beta;
+		#pragma omp for schedule(dynamic,256)
+		for(int atom=pre_comm_si;atom<pre_comm_ei;atom++){
+
+			const int imaterial=atoms::type_array[atom];
+			const double alpha = mp::material[imaterial].alpha;
+			const double beta  = -1.0*mp::dt*mp::material[imaterial].one_oneplusalpha_sq*0.5;
+			const double beta2 = beta*beta;
 		
-		// Store local spin in S and local field in H
-		const double S[3] = {atoms::x_spin_array[atom],atoms::y_spin_array[atom],atoms::z_spin_array[atom]};
-		const double H[3] = {atoms::x_total_spin_field_array[atom]+atoms::x_total_external_field_array[atom],
-									atoms::y_total_spin_field_array[atom]+atoms::y_total_external_field_array[atom],
-									atoms::z_total_spin_field_array[atom]+atoms::z_total_external_field_array[atom]};
+			// Store local spin in S and local field in H
+			const double S[3] = {atoms::x_spin_array[atom],atoms::y_spin_array[atom],atoms::z_spin_array[atom]};
+			const double H[3] = {atoms::x_total_spin_field_array[atom]+atoms::x_total_external_field_array[atom],
+										atoms::y_total_spin_field_array[atom]+atoms::y_total_external_field_array[atom],
+										atoms::z_total_spin_field_array[atom]+atoms::z_total_external_field_array[atom]};
 
-		// Calculate F = [H + alpha* (S x H)]
-		const double F[3] = {H[0] + alpha*(S[1]*H[2]-S[2]*H[1]),
-									H[1] + alpha*(S[2]*H[0]-S[0]*H[2]),
-									H[2] + alpha*(S[0]*H[1]-S[1]*H[0])};
+			// Calculate F = [H + alpha* (S x H)]
+			const double F[3] = {H[0] + alpha*(S[1]*H[2]-S[2]*H[1]),
+										H[1] + alpha*(S[2]*H[0]-S[0]*H[2]),
+										H[2] + alpha*(S[0]*H[1]-S[1]*H[0])};
 									
-		const double FdotF = F[0]*F[0] + F[1]*F[1] + F[2]*F[2];
-		const double beta2FdotS = beta2*(F[0]*S[0] + F[1]*S[1] + F[2]*S[2]);
-		const double one_o_one_plus_beta2FdotF = 1.0/(1.0 + beta2*FdotF);
-		const double one_minus_beta2FdotF = 1.0 - beta2*FdotF;
+			const double FdotF = F[0]*F[0] + F[1]*F[1] + F[2]*F[2];
+			const double beta2FdotS = beta2*(F[0]*S[0] + F[1]*S[1] + F[2]*S[2]);
+			const double one_o_one_plus_beta2FdotF = 1.0/(1.0 + beta2*FdotF);
+			const double one_minus_beta2FdotF = 1.0 - beta2*FdotF;
 		
-		// Calculate intermediate spin position (S + S')/2
-		x_spin_storage_array[atom] = (S[0] + one_o_one_plus_beta2FdotF*(S[0]*one_minus_beta2FdotF + 2.0*(beta*(F[1]*S[2]-F[2]*S[1]) + F[0]*beta2FdotS)))*0.5;
-		y_spin_storage_array[atom] = (S[1] + one_o_one_plus_beta2FdotF*(S[1]*one_minus_beta2FdotF + 2.0*(beta*(F[2]*S[0]-F[0]*S[2]) + F[1]*beta2FdotS)))*0.5;
-		z_spin_storage_array[atom] = (S[2] + one_o_one_plus_beta2FdotF*(S[2]*one_minus_beta2FdotF + 2.0*(beta*(F[0]*S[1]-F[1]*S[0]) + F[2]*beta2FdotS)))*0.5;
+			// Calculate intermediate spin position (S + S')/2
+			x_spin_storage_array[atom] = (S[0] + one_o_one_plus_beta2FdotF*(S[0]*one_minus_beta2FdotF + 2.0*(beta*(F[1]*S[2]-F[2]*S[1]) + F[0]*beta2FdotS)))*0.5;
+			y_spin_storage_array[atom] = (S[1] + one_o_one_plus_beta2FdotF*(S[1]*one_minus_beta2FdotF + 2.0*(beta*(F[2]*S[0]-F[0]*S[2]) + F[1]*beta2FdotS)))*0.5;
+			z_spin_storage_array[atom] = (S[2] + one_o_one_plus_beta2FdotF*(S[2]*one_minus_beta2FdotF + 2.0*(beta*(F[0]*S[1]-F[1]*S[0]) + F[2]*beta2FdotS)))*0.5;
 		
+		}
 	}
 		
 
-	// Complete halo swap
-	mpi_complete_halo_swap();
-
 	// Calculate fields (boundary)
 	calculate_spin_fields(post_comm_si,post_comm_ei);
 	calculate_external_fields(post_comm_si,post_comm_ei);
 
 	// Calculate Predictor Step (boundary)
+	#pragma omp parallel for
 	for(int atom=post_comm_si;atom<post_comm_ei;atom++){
 
 		const int imaterial=atoms::type_array[atom];
@@ -143,6 +152,7 @@ int LLG_Midpoint_mpi(){
 	}
 
 	// Copy new spins to spin array (all)
+	#pragma omp parallel for
 	for(int atom=pre_comm_si;atom<post_comm_ei;atom++){
 		atoms::x_spin_array[atom]=x_spin_storage_array[atom];
 		atoms::y_spin_array[atom]=y_spin_storage_array[atom];
@@ -155,44 +165,50 @@ int LLG_Midpoint_mpi(){
 	// Recalculate spin dependent fields (core)
 	calculate_spin_fields(pre_comm_si,pre_comm_ei);
 
-	// Calculate Corrector Step (core)
-	for(int atom=pre_comm_si;atom<pre_comm_ei;atom++){
+	// Calculate Corrector Step (core) and complete second halo swap
+	#pragma omp parallel
+	{
+		// Master thread completes the halo swap (MPI calls are funnelled)
+		#pragma omp master
+		mpi_complete_halo_swap();
 
-		const int imaterial=atoms::type_array[atom];
-		const double alpha = mp::material[imaterial].alpha;
-		const double beta  = -1.0*mp::dt*mp::material[imaterial].one_oneplusalpha_sq*0.5;
-		const double beta2 = beta*beta;
+		#pragma omp for schedule(dynamic,256)
+		for(int atom=pre_comm_si;atom<pre_comm_ei;atom++){
+
+			const int imaterial=atoms::type_array[atom];
+			const double alpha = mp::material[imaterial].alpha;
+			const double beta  = -1.0*mp::dt*mp::material[imaterial].one_oneplusalpha_sq*0.5;
+			const double beta2 = beta*beta;
 		
-		// Store local spin in S and local field in H
-		const double M[3] = {atoms::x_spin_array[atom],atoms::y_spin_array[atom],atoms::z_spin_array[atom]};
-		const double S[3] = {x_initial_spin_array[atom],y_initial_spin_array[atom],z_initial_spin_array[atom]};
-		const double H[3] = {atoms::x_total_spin_field_array[atom]+atoms::x_total_external_field_array[atom],
-									atoms::y_total_spin_field_array[atom]+atoms::y_total_external_field_array[atom],
-									atoms::z_total_spin_field_array[atom]+atoms::z_total_external_field_array[atom]};
+			// Store local spin in S and local field in H
+			const double M[3] = {atoms::x_spin_array[atom],atoms::y_spin_array[atom],atoms::z_spin_array[atom]};
+			const double S[3] = {x_initial_spin_array[atom],y_initial_spin_array[atom],z_initial_spin_array[atom]};
+			const double H[3] = {atoms::x_total_spin_field_array[atom]+atoms::x_total_external_field_array[atom],
+										atoms::y_total_spin_field_array[atom]+atoms::y_total_external_field_array[atom],
+										atoms::z_total_spin_field_array[atom]+atoms::z_total_external_field_array[atom]};
 
-		// Calculate F = [H + alpha* (M x H)]
-		const double F[3] = {H[0] + alpha*(M[1]*H[2]-M[2]*H[1]),
-									H[1] + alpha*(M[2]*H[0]-M[0]*H[2]),
-									H[2] + alpha*(M[0]*H[1]-M[1]*H[0])};
+			// Calculate F = [H + alpha* (M x H)]
+			const double F[3] = {H[0] + alpha*(M[1]*H[2]-M[2]*H[1]),
+										H[1] + alpha*(M[2]*H[0]-M[0]*H[2]),
+										H[2] + alpha*(M[0]*H[1]-M[1]*H[0])};
 									
-		const double FdotF = F[0]*F[0] + F[1]*F[1] + F[2]*F[2];
-		const double beta2FdotS = beta2*(F[0]*S[0] + F[1]*S[1] + F[2]*S[2]);
-		const double one_o_one_plus_beta2FdotF = 1.0/(1.0 + beta2*FdotF);
-		const double one_minus_beta2FdotF = 1.0 - beta2*FdotF;
+			const double FdotF = F[0]*F[0] + F[1]*F[1] + F[2]*F[2];
+			const double beta2FdotS = beta2*(F[0]*S[0] + F[1]*S[1] + F[2]*S[2]);
+			const double one_o_one_plus_beta2FdotF = 1.0/(1.0 + beta2*FdotF);
+			const double one_minus_beta2FdotF = 1.0 - beta2*FdotF;
 
-		// Calculate final spin position
-		x_spin_storage_array[atom] = one_o_one_plus_beta2FdotF*(S[0]*one_minus_beta2FdotF + 2.0*(beta*(F[1]*S[2]-F[2]*S[1]) + F[0]*beta2FdotS));
-		y_spin_storage_array[atom] = one_o_one_plus_beta2FdotF*(S[1]*one_minus_beta2FdotF + 2.0*(beta*(F[2]*S[0]-F[0]*S[2]) + F[1]*beta2FdotS));
-		z_spin_storage_array[atom] = one_o_one_plus_beta2FdotF*(S[2]*one_minus_beta2FdotF + 2.0*(beta*(F[0]*S[1]-F[1]*S[0]) + F[2]*beta2FdotS));
+			// Calculate final spin position
+			x_spin_storage_array[atom] = one_o_one_plus_beta2FdotF*(S[0]*one_minus_beta2FdotF + 2.0*(beta*(F[1]*S[2]-F[2]*S[1]) + F[0]*beta2FdotS));
+			y_spin_storage_array[atom] = one_o_one_plus_beta2FdotF*(S[1]*one_minus_beta2FdotF + 2.0*(beta*(F[2]*S[0]-F[0]*S[2]) + F[1]*beta2FdotS));
+			z_spin_storage_array[atom] = one_o_one_plus_beta2FdotF*(S[2]*one_minus_beta2FdotF + 2.0*(beta*(F[0]*S[1]-F[1]*S[0]) + F[2]*beta2FdotS));
+		}
 	}
 
-	// Complete second halo swap
-	mpi_complete_halo_swap();
-
 	// Recalculate spin dependent fields (boundary)
 	calculate_spin_fields(post_comm_si,post_comm_ei);
 
 	// Calculate Corrector Step (boundary)
+	#pragma omp parallel for
 	for(int atom=post_comm_si;atom<post_comm_ei;atom++){
 
 		const int imaterial=atoms::type_array[atom];
@@ -224,6 +240,7 @@ int LLG_Midpoint_mpi(){
 	}
 	
 	// Copy new spins to spin array (all)
+	#pragma omp parallel for
 	for(int atom=pre_comm_si;atom<post_comm_ei;atom++){
 		atoms::x_spin_array[atom]=x_spin_storage_array[atom];
 		atoms::y_spin_array[atom]=y_spin_storage_array[atom];
@@ -38,9 +38,163 @@
 #ifdef MPICF
 #include "atoms.hpp"
 #include "errors.hpp"
+#include "vio.hpp"
 #include "vmpi.hpp"
+#include <cmath>
 #include <iostream>
 
+namespace vmpi{
+
+	//------------------------------------------------------------------------------------------------------
+	// Halo encodings. Boundary spins are sent either as three doubles (exact), three floats, or as the
+	// polar and azimuthal angles quantised to 16 or 32 bit integers. The integrator always works in double
+	// precision; reduced precision spins are renormalised on receipt, so only the double encoding may be
+	// used with the LLB equation where the spin length varies.
+	//------------------------------------------------------------------------------------------------------
+	const double pi=3.14159265358979323846;
+
+	/// Number of values sent per spin
+	int halo_values_per_spin(){
+		if(vmpi::halo_encoding>=2) return 2;
+		return 3;
+	}
+
+	/// Number of bytes sent per spin
+	int halo_bytes_per_spin(){
+		switch(vmpi::halo_encoding){
+			case 1: return 3*sizeof(float);
+			case 2: return 2*sizeof(unsigned short);
+			case 3: return 2*sizeof(unsigned int);
+			default: return 3*sizeof(double);
+		}
+	}
+
+	/// Convert spin to quantised polar and azimuthal angles
+	template <typename T> void encode_spin_angles(const double sx, const double sy, const double sz, const double qmax, T& qtheta, T& qphi){
+
+		const double mod_s = sqrt(sx*sx + sy*sy + sz*sz);
+		double cos_theta = mod_s > 0.0 ? sz/mod_s : 1.0;
+		if(cos_theta > 1.0) cos_theta = 1.0;
+		if(cos_theta < -1.0) cos_theta = -1.0;
+		const double theta = acos(cos_theta); // 0 - pi
+		double phi = atan2(sy,sx); // -pi - pi
+		if(phi < 0.0) phi += 2.0*pi;
+
+		qtheta = T(floor(theta*(qmax/pi) + 0.5));
+		// phi is periodic, so round to nearest and wrap maximum onto zero
+		const double qp = floor(phi*((qmax+1.0)/(2.0*pi)) + 0.5);
+		qphi = qp > qmax ? T(0) : T(qp);
+
+		return;
+
+	}
+
+	/// Convert quantised polar and azimuthal angles to unit spin
+	template <typename T> void decode_spin_angles(const T qtheta, const T qphi, const double qmax, double& sx, double& sy, double& sz){
+
+		const double theta = double(qtheta)*(pi/qmax);
+		const double phi = double(qphi)*(2.0*pi/(qmax+1.0));
+		const double sin_theta = sin(theta);
+
+		sx = sin_theta*cos(phi);
+		sy = sin_theta*sin(phi);
+		sz = cos(theta);
+
+		return;
+
+	}
+
+void init_halo_swap_requests(){
+	//====================================================================================
+	//
+	///											init_halo_swap_requests
+	///
+	///						Creates persistent send/receive requests for the halo swap
+	///
+	//====================================================================================
+	//
+	//		The send and receive buffers are sized once in init_mpi_comms and never move,
+	//		so the message envelopes can be set up here and simply restarted with
+	//		MPI_Startall every half step. Only neighbouring processors with a non-zero
+	//		message size get a request.
+	//
+	//====================================================================================
+
+	// check calling of routine if error checking is activated
+	if(err::check==true){std::cout << "vmpi::init_halo_swap_requests has been called" << std::endl;}
+
+	// Free any previously allocated requests
+	vmpi::free_halo_swap_requests();
+
+	// Allocate buffers for reduced precision halo encodings
+	const int num_send = vmpi::send_atom_translation_array.size();
+	const int num_recv = vmpi::recv_atom_translation_array.size();
+	const int nv = vmpi::halo_values_per_spin();
+	MPI_Datatype datatype = MPI_DOUBLE;
+	char* send_buffer = reinterpret_cast<char*>(vmpi::send_spin_data_array.data());
+	char* recv_buffer = reinterpret_cast<char*>(vmpi::recv_spin_data_array.data());
+	switch(vmpi::halo_encoding){
+		case 1:
+			vmpi::send_spin_data_array_sp.resize(nv*num_send);
+			vmpi::recv_spin_data_array_sp.resize(nv*num_recv);
+			send_buffer = reinterpret_cast<char*>(vmpi::send_spin_data_array_sp.data());
+			recv_buffer = reinterpret_cast<char*>(vmpi::recv_spin_data_array_sp.data());
+			datatype = MPI_FLOAT;
+			break;
+		case 2:
+			vmpi::send_spin_angle_array_16.resize(nv*num_send);
+			vmpi::recv_spin_angle_array_16.resize(nv*num_recv);
+			send_buffer = reinterpret_cast<char*>(vmpi::send_spin_angle_array_16.data());
+			recv_buffer = reinterpret_cast<char*>(vmpi::recv_spin_angle_array_16.data());
+			datatype = MPI_UNSIGNED_SHORT;
+			break;
+		case 3:
+			vmpi::send_spin_angle_array_32.resize(nv*num_send);
+			vmpi::recv_spin_angle_array_32.resize(nv*num_recv);
+			send_buffer = reinterpret_cast<char*>(vmpi::send_spin_angle_array_32.data());
+			recv_buffer = reinterpret_cast<char*>(vmpi::recv_spin_angle_array_32.data());
+			datatype = MPI_UNSIGNED;
+			break;
+	}
+	const int bytes_per_value = vmpi::halo_bytes_per_spin()/nv;
+
+	for (int p=0;p<vmpi::num_processors;p++){
+		if(vmpi::send_num_array[p]!=0){
+			int num_pts = nv*vmpi::send_num_array[p];
+			int si = nv*vmpi::send_start_index_array[p];
+			MPI_Request request;
+			MPI_Send_init(send_buffer+si*bytes_per_value,num_pts,datatype,p,48,MPI_COMM_WORLD,&request);
+			vmpi::requests.push_back(request);
+		}
+		if(vmpi::recv_num_array[p]!=0){
+			int num_pts = nv*vmpi::recv_num_array[p];
+			int si = nv*vmpi::recv_start_index_array[p];
+			MPI_Request request;
+			MPI_Recv_init(recv_buffer+si*bytes_per_value,num_pts,datatype,p,48,MPI_COMM_WORLD,&request);
+			vmpi::requests.push_back(request);
+		}
+	}
+
+	vmpi::stati.resize(vmpi::requests.size());
+
+	zlog << zTs() << "Number of persistent halo swap requests: " << vmpi::requests.size() << std::endl;
+	zlog << zTs() << "Halo swap sends " << vmpi::halo_bytes_per_spin() << " bytes per spin, " << num_send*vmpi::halo_bytes_per_spin() << " bytes per swap" << std::endl;
+
+	return;
+
+}
+
+void free_halo_swap_requests(){
+
+	for(unsigned int i=0;i<vmpi::requests.size();i++) MPI_Request_free(&vmpi::requests[i]);
+	vmpi::requests.resize(0);
+	vmpi::stati.resize(0);
+
+	return;
+
+}
+
+} // end of namespace vmpi
 
 int mpi_init_halo_swap(){
 	//====================================================================================
@@ -57,8 +211,6 @@ int mpi_init_halo_swap(){
 	//
 	//====================================================================================
 
-	//using namespace mpi_comms;
-
 	//----------------------------------------------------------
 	// check calling of routine if error checking is activated
 	//----------------------------------------------------------
@@ -71,39 +223,68 @@ int mpi_init_halo_swap(){
 	// Pack spins for sending
 	//----------------------------------------------------------
 
-	//std::cout << "rank: " << vmpi::my_rank << " num_halo_swaps: " << vmpi::send_atom_translation_array.size();
-	//std::cout << "\t" << "num_boundary_swaps: " << vmpi::recv_atom_translation_array.size() << std::endl;
-
-	for(unsigned int i=0;i<vmpi::send_atom_translation_array.size();i++){
-		int atom = vmpi::send_atom_translation_array[i];
-		vmpi::send_spin_data_array[3*i+0] = atoms::x_spin_array[atom];
-		vmpi::send_spin_data_array[3*i+1] = atoms::y_spin_array[atom];
-		vmpi::send_spin_data_array[3*i+2] = atoms::z_spin_array[atom];
-		//std::cout << vmpi::my_rank << "\t" << i << "\t";
-		//std::cout << atoms::x_spin_array[vmpi::send_atom_translation_array[i]] << "\t";
-		//std::cout << atoms::y_spin_array[vmpi::send_atom_translation_array[i]] << "\t";
-		//std::cout << atoms::z_spin_array[vmpi::send_atom_translation_array[i]] << std::endl;
-	}
+	// Use local restricted pointers so the compiler can vectorise the gather
+	const int num_send = vmpi::send_atom_translation_array.size();
+	if(num_send>0){
+		const int* __restrict__ const translation = &vmpi::send_atom_translation_array[0];
+		const double* __restrict__ const sx = &atoms::x_spin_array[0];
+		const double* __restrict__ const sy = &atoms::y_spin_array[0];
+		const double* __restrict__ const sz = &atoms::z_spin_array[0];
 
-	//----------------------------------------------------------
-	// Send spin data array and post receives
-	//----------------------------------------------------------
+		switch(vmpi::halo_encoding){
 
-	vmpi::requests.resize(0);
+			case 0:{
+				double* __restrict__ const buffer = &vmpi::send_spin_data_array[0];
+				#pragma omp parallel for
+				for(int i=0;i<num_send;i++){
+					const int atom = translation[i];
+					buffer[3*i+0] = sx[atom];
+					buffer[3*i+1] = sy[atom];
+					buffer[3*i+2] = sz[atom];
+				}
+				break;
+			}
+
+			case 1:{
+				float* __restrict__ const buffer = &vmpi::send_spin_data_array_sp[0];
+				#pragma omp parallel for
+				for(int i=0;i<num_send;i++){
+					const int atom = translation[i];
+					buffer[3*i+0] = float(sx[atom]);
+					buffer[3*i+1] = float(sy[atom]);
+					buffer[3*i+2] = float(sz[atom]);
+				}
+				break;
+			}
+
+			case 2:{
+				unsigned short* __restrict__ const buffer = &vmpi::send_spin_angle_array_16[0];
+				#pragma omp parallel for
+				for(int i=0;i<num_send;i++){
+					const int atom = translation[i];
+					vmpi::encode_spin_angles(sx[atom], sy[atom], sz[atom], 65535.0, buffer[2*i+0], buffer[2*i+1]);
+				}
+				break;
+			}
+
+			case 3:{
+				unsigned int* __restrict__ const buffer = &vmpi::send_spin_angle_array_32[0];
+				#pragma omp parallel for
+				for(int i=0;i<num_send;i++){
+					const int atom = translation[i];
+					vmpi::encode_spin_angles(sx[atom], sy[atom], sz[atom], 4294967295.0, buffer[2*i+0], buffer[2*i+1]);
+				}
+				break;
+			}
 
-	for (int p=0;p<vmpi::num_processors;p++){
-		if(vmpi::send_num_array[p]!=0){
-			int num_pts = 3*vmpi::send_num_array[p];
-			int si = 3*vmpi::send_start_index_array[p];
-			vmpi::requests.push_back(MPI::COMM_WORLD.Isend(&vmpi::send_spin_data_array[si],num_pts,MPI_DOUBLE,p,48));
-		}
-		if(vmpi::recv_num_array[p]!=0){
-			int num_pts = 3*vmpi::recv_num_array[p];
-			int si = 3*vmpi::recv_start_index_array[p];
-			vmpi::requests.push_back(MPI::COMM_WORLD.Irecv(&vmpi::recv_spin_data_array[si],num_pts,MPI_DOUBLE,p,48));
 		}
 	}
 
+	//----------------------------------------------------------
+	// Start persistent sends and receives
+	//----------------------------------------------------------
+	if(vmpi::requests.size()>0) MPI_Startall(vmpi::requests.size(),&vmpi::requests[0]);
+
 	//----------------------------------------------------------
 	// Return
 	//----------------------------------------------------------
@@ -131,23 +312,70 @@ int mpi_complete_halo_swap(){
 
 	// Swap timers compute -> wait
 	vmpi::TotalComputeTime+=vmpi::SwapTimer(vmpi::ComputeTime, vmpi::WaitTime);
-	
+
 	// Wait for all comms to complete
-	vmpi::stati.resize(vmpi::requests.size());
-	MPI::Request::Waitall(vmpi::requests.size(),&vmpi::requests[0],&vmpi::stati[0]);
+	if(vmpi::requests.size()>0) MPI_Waitall(vmpi::requests.size(),&vmpi::requests[0],&vmpi::stati[0]);
 
 	// Swap timers wait -> compute
 	vmpi::TotalWaitTime+=vmpi::SwapTimer(vmpi::WaitTime, vmpi::ComputeTime);
-	
-	// Unpack received spins
-	for(unsigned int i=0;i<vmpi::recv_atom_translation_array.size();i++){
-		atoms::x_spin_array[vmpi::recv_atom_translation_array[i]] = vmpi::recv_spin_data_array[3*i+0];
-		atoms::y_spin_array[vmpi::recv_atom_translation_array[i]] = vmpi::recv_spin_data_array[3*i+1];
-		atoms::z_spin_array[vmpi::recv_atom_translation_array[i]] = vmpi::recv_spin_data_array[3*i+2];
-		//std::cout << vmpi::my_rank << "\t" << i << "\t" << vmpi::recv_atom_translation_array[i] << "\t";
-		//std::cout << atoms::x_spin_array[vmpi::recv_atom_translation_array[i]] << "\t";
-		//std::cout << atoms::y_spin_array[vmpi::recv_atom_translation_array[i]] << "\t";
-		//std::cout << atoms::z_spin_array[vmpi::recv_atom_translation_array[i]] << std::endl;
+
+	// Unpack received spins (serial, as this is called from the master thread
+	// inside the threaded core atom update in hybrid mode)
+	const int num_recv = vmpi::recv_atom_translation_array.size();
+	if(num_recv>0){
+		const int* __restrict__ const translation = &vmpi::recv_atom_translation_array[0];
+		double* __restrict__ const sx = &atoms::x_spin_array[0];
+		double* __restrict__ const sy = &atoms::y_spin_array[0];
+		double* __restrict__ const sz = &atoms::z_spin_array[0];
+
+		switch(vmpi::halo_encoding){
+
+			case 0:{
+				const double* __restrict__ const buffer = &vmpi::recv_spin_data_array[0];
+				for(int i=0;i<num_recv;i++){
+					const int atom = translation[i];
+					sx[atom] = buffer[3*i+0];
+					sy[atom] = buffer[3*i+1];
+					sz[atom] = buffer[3*i+2];
+				}
+				break;
+			}
+
+			case 1:{
+				// renormalise spins to remove rounding of the length
+				const float* __restrict__ const buffer = &vmpi::recv_spin_data_array_sp[0];
+				for(int i=0;i<num_recv;i++){
+					const int atom = translation[i];
+					const double x = buffer[3*i+0];
+					const double y = buffer[3*i+1];
+					const double z = buffer[3*i+2];
+					const double imod = 1.0/sqrt(x*x + y*y + z*z);
+					sx[atom] = x*imod;
+					sy[atom] = y*imod;
+					sz[atom] = z*imod;
+				}
+				break;
+			}
+
+			case 2:{
+				const unsigned short* __restrict__ const buffer = &vmpi::recv_spin_angle_array_16[0];
+				for(int i=0;i<num_recv;i++){
+					const int atom = translation[i];
+					vmpi::decode_spin_angles(buffer[2*i+0], buffer[2*i+1], 65535.0, sx[atom], sy[atom], sz[atom]);
+				}
+				break;
+			}
+
+			case 3:{
+				const unsigned int* __restrict__ const buffer = &vmpi::recv_spin_angle_array_32[0];
+				for(int i=0;i<num_recv;i++){
+					const int atom = translation[i];
+					vmpi::decode_spin_angles(buffer[2*i+0], buffer[2*i+1], 4294967295.0, sx[atom], sy[atom], sz[atom]);
+				}
+				break;
+			}
+
+		}
 	}
 
 	return 0;
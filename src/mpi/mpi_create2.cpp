@@ -38,13 +38,17 @@
 namespace vmpi{
 	int mpi_mode=0;
 	int ppn=1;						///< Processors per node
+	int num_threads=1;			///< Number of OpenMP threads per process
 	int my_rank=0;
 	int num_processors=1;
 	int num_core_atoms;
 	int num_bdry_atoms;
 	int num_halo_atoms;
 
-	bool replicated_data_staged=false;
+	int num_domains[3]={1,1,1};
+	bool load_balance=false;
+	bool load_balance_measured=false;
+	double load_balance_threshold=1.05;
 
 	char hostname[20];
 
@@ -75,9 +79,17 @@ namespace vmpi{
 	std::vector<int> recv_start_index_array;
 	std::vector<int> recv_num_array;
 	std::vector<double> recv_spin_data_array;
+
+	int halo_encoding=0;
+	std::vector<float> send_spin_data_array_sp(0);
+	std::vector<float> recv_spin_data_array_sp(0);
+	std::vector<unsigned short> send_spin_angle_array_16(0);
+	std::vector<unsigned short> recv_spin_angle_array_16(0);
+	std::vector<unsigned int> send_spin_angle_array_32(0);
+	std::vector<unsigned int> recv_spin_angle_array_32(0);
 	#ifdef MPICF
-	std::vector<MPI::Request> requests(0);
-	std::vector<MPI::Status> stati(0);
+	std::vector<MPI_Request> requests(0);
+	std::vector<MPI_Status> stati(0);
 	#endif
 }
 
@@ -193,6 +205,9 @@ namespace vmpi{
 	//std::cout << my_rank << "\t" << x1 << "\t" << x2 << "\t" << y1 << "\t" << y2 << "\t" << z1 << "\t" << z2 << std::endl;
 
 	// set namespaced variables
+	vmpi::num_domains[0]=nx;
+	vmpi::num_domains[1]=ny;
+	vmpi::num_domains[2]=nz;
 	vmpi::min_dimensions[0]=x1;
 	vmpi::min_dimensions[1]=y1;
 	vmpi::min_dimensions[2]=z1;
@@ -730,76 +745,6 @@ int copy_halo_atoms(std::vector<cs::catom_t> & catom_array){
 
 }
 
-/// @brief Set Replicated Data
-///
-/// @details Sets atom CPU ID for replicated data decomposition
-///
-/// @section License
-/// Use of this code, either in source or compiled form, is subject to license from the authors.
-/// Copyright \htmlonly &copy \endhtmlonly Richard Evans, 2009-2011. All Rights Reserved.
-///
-/// @section Information
-/// @author  Richard Evans, richard.evans@york.ac.uk
-/// @version 1.0
-/// @date    15/03/2011
-///
-/// @return EXIT_SUCCESS
-///
-/// @internal
-///	Created:		15/03/2011
-///	Revision:	  ---
-///=====================================================================================
-///
-int set_replicated_data(std::vector<cs::catom_t> & catom_array){
-
-	// check calling of routine if error checking is activated
-	if(err::check==true){std::cout << "vmpi::set_replicated_data has been called" << std::endl;}
-
-	// check for num_atoms > num_CPUS
-	if(catom_array.size()<vmpi::num_processors){
-		terminaltextcolor(RED);
-		std::cerr << "Error! - number of atoms is less than number of CPUs - replicated data parallelisation is not possible!" << std::endl;
-		terminaltextcolor(WHITE);
-		err::vexit();
-	}
-
-	// arrays to store atom ranges on each CPU
-	std::vector<int> rd_num_atoms(vmpi::num_processors,0);
-	std::vector<int> rd_start_atom(vmpi::num_processors,0);
-	std::vector<int> rd_end_atom(vmpi::num_processors,0);
-
-	// Divide system according to atom numbers, replicated on all CPUs
-	for(int p=0;p<vmpi::num_processors;p++){
-		rd_num_atoms[p]=catom_array.size()/vmpi::num_processors;
-		rd_start_atom[p] = p*rd_num_atoms[p];
-		rd_end_atom[p] = (p+1)*rd_num_atoms[p]-1;
-	}
-
-	// add spare atoms to last CPU
-	rd_end_atom[vmpi::num_processors-1]  = catom_array.size()-1;
-	rd_num_atoms[vmpi::num_processors-1] = rd_end_atom[vmpi::num_processors-1]-rd_start_atom[vmpi::num_processors-1];
-
-	// Populate atoms with CPU id and mpi_type
-	for(int p=0;p<vmpi::num_processors;p++){
-		if(p==vmpi::my_rank){
-			for(int atom=rd_start_atom[p];atom<=rd_end_atom[p];atom++){
-				catom_array[atom].mpi_cpuid = p;
-				catom_array[atom].mpi_type = 0; // core
-				catom_array[atom].mpi_atom_number=atom; // atom numbers are mirrored on all CPUs
-			}
-		}
-		else{
-			for(int atom=rd_start_atom[p];atom<=rd_end_atom[p];atom++){
-				catom_array[atom].mpi_cpuid = p;
-				catom_array[atom].mpi_type = 2; // halo
-				catom_array[atom].mpi_atom_number=atom; // atom numbers are mirrored on all CPUs
-			}
-		}
-	}
-
-	return EXIT_SUCCESS;
-}
-
 int sort_atoms_by_mpi_type(std::vector<cs::catom_t> &,std::vector<std::vector <cs::neighbour_t> > &);
 
 /// @brief Identify Boundary Atoms
@@ -1127,6 +1072,9 @@ int init_mpi_comms(std::vector<cs::catom_t> & catom_array){
 	  }
 	}
 
+	// Set up persistent requests for halo swap now buffers are fixed in size
+	vmpi::init_halo_swap_requests();
+
 	return EXIT_SUCCESS;
 }
 
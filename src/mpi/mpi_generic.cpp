@@ -33,6 +33,8 @@
 //====================================================================================
 
 #include "errors.hpp"
+#include "stats.hpp"
+#include "vio.hpp"
 #include "vmpi.hpp"
 #include <iostream>
 #include <fstream>
@@ -66,13 +68,27 @@ int initialise(){
 	int resultlen;
 
 	// Initialise MPI
-	MPI::Init();
+	#ifdef _OPENMP
+		// Hybrid mode: all MPI calls are funnelled through the master thread
+		int provided = MPI::Init_thread(MPI_THREAD_FUNNELED);
+	#else
+		MPI::Init();
+	#endif
 
 	// Get number of processors and rank
 	vmpi::my_rank = MPI::COMM_WORLD.Get_rank();
 	vmpi::num_processors = MPI::COMM_WORLD.Get_size();
 	MPI::Get_processor_name(vmpi::hostname, resultlen);
 
+	#ifdef _OPENMP
+		if(provided < MPI_THREAD_FUNNELED){
+			terminaltextcolor(RED);
+			std::cerr << "Error - MPI library does not support MPI_THREAD_FUNNELED required for hybrid MPI/OpenMP mode. Exiting." << std::endl;
+			terminaltextcolor(WHITE);
+			MPI::COMM_WORLD.Abort(EXIT_FAILURE);
+		}
+	#endif
+
 	// Start MPI Timer
 	vmpi::start_time=MPI_Wtime();
 
@@ -181,6 +197,18 @@ int finalise(){
 		}
 	}
 	
+	// Complete any outstanding reduction of statistics
+	stats::complete_reduction();
+
+	// Save measured costs for load balancing of subsequent runs
+	vmpi::save_load_balance_data();
+
+	// Collect output from independent simulations
+	vmpi::collate_statistical_output();
+
+	// Release persistent halo swap requests
+	vmpi::free_halo_swap_requests();
+
 	// Stop MPI Timer and output to screen
 	vmpi::end_time=MPI_Wtime();
 	if(vmpi::my_rank==0){
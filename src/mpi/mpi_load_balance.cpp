@@ -0,0 +1,645 @@
+//-----------------------------------------------------------------------------
+//
+// This source file is part of the VAMPIRE open source package under the
+// GNU GPL (version 2) licence (see licence file for details).
+//
+// (c) R F L Evans 2016. All rights reserved.
+//
+//-----------------------------------------------------------------------------
+//
+// Static, profile-guided load balanced spatial decompositions
+//
+// The equal volume decomposition in vmpi::geometric_decomposition gives very
+// different atom counts per process for granular films, particle arrays and
+// systems with vacuum. Here the partition planes are moved so that each
+// domain carries the same estimated cost. The cost of an atom is taken as
+// one plus its number of bonds, optionally scaled by the compute time per
+// unit cost measured for the same region of space in a previous run.
+//
+// Balancing is static: the decomposition is fixed once during system
+// creation and atoms are never redistributed during a simulation. Measured
+// costs are written at the end of each run (file mpi-load-balance) and only
+// take effect when the next run is started with mpi-load-balance = measured.
+//
+// Planes are chosen hierarchically: x planes from the global x profile,
+// y planes separately for each x slab and z planes for each x-y column, so
+// every domain remains a box and the existing halo machinery still applies.
+//
+// Alternatively (mpi-mode = recursive-bisection) the system is split by
+// recursive coordinate bisection with the same cost model, which handles any
+// number of processors and irregular geometries.
+//
+// Replicated data mode (mpi-mode = replicated-data) splits the system into
+// slabs along the longest dimension holding equal numbers of atoms, so that
+// each process only generates its own slab and halo rather than the
+// complete system.
+//
+//-----------------------------------------------------------------------------
+
+// C++ standard library headers
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+// Vampire headers
+#include "create.hpp"
+#include "errors.hpp"
+#include "unitcell.hpp"
+#include "vio.hpp"
+#include "vmpi.hpp"
+
+#ifdef MPICF
+
+namespace vmpi{
+
+   // Local cost of atoms on this process (without measured scaling)
+   double local_atom_cost=0.0;
+
+   //------------------------------------------------------------------------------------------------------
+   // Function to divide a 1D cost profile into n parts of approximately equal cost. Plane positions are
+   // returned as bin indices with planes[0]=0 and planes[n]=number of bins, with at least one bin per part.
+   //------------------------------------------------------------------------------------------------------
+   bool partition_profile(const std::vector<double>& profile, const int n, std::vector<int>& planes){
+
+      const int num_bins = profile.size();
+      planes.assign(n+1,0);
+      planes[n]=num_bins;
+
+      // not enough bins to give every domain a unit cell
+      if(num_bins < n) return false;
+
+      // cumulative cost at each bin boundary
+      std::vector<double> cumulative(num_bins+1,0.0);
+      for(int b=0; b<num_bins; b++) cumulative[b+1]=cumulative[b]+profile[b];
+      const double total = cumulative[num_bins];
+
+      for(int k=1; k<n; k++){
+         const double target = total*double(k)/double(n);
+         const int min_b = planes[k-1]+1;
+         const int max_b = num_bins-(n-k);
+         int best = min_b;
+         for(int b=min_b; b<=max_b; b++){
+            if(fabs(cumulative[b]-target) < fabs(cumulative[best]-target)) best=b;
+            if(cumulative[b] > target) break;
+         }
+         planes[k]=best;
+      }
+
+      return true;
+
+   }
+
+   //------------------------------------------------------------------------------------------------------
+   // Function to find the part of a partitioned profile containing a given bin
+   //------------------------------------------------------------------------------------------------------
+   int find_part(const std::vector<int>& planes, const int bin){
+      int part=0;
+      while(part < int(planes.size())-2 && bin >= planes[part+1]) part++;
+      return part;
+   }
+
+   //------------------------------------------------------------------------------------------------------
+   // Function to read measured cost factors from a previous run. Each line holds the box of a previous
+   // domain and its compute time per unit cost; factors are normalised to a mean of one.
+   //------------------------------------------------------------------------------------------------------
+   void read_measured_costs(std::vector<double>& boxes, std::vector<double>& factors){
+
+      boxes.resize(0);
+      factors.resize(0);
+
+      std::ifstream ifile("mpi-load-balance");
+      if(!ifile.is_open()){
+         zlog << zTs() << "Warning - measured load balancing requested but file mpi-load-balance could not be opened. Using atom and bond counts." << std::endl;
+         return;
+      }
+
+      std::string line;
+      while(getline(ifile,line)){
+         if(line.size()==0 || line[0]=='#') continue;
+         std::istringstream iss(line);
+         int rank;
+         double box[6], cost;
+         if(iss >> rank >> box[0] >> box[1] >> box[2] >> box[3] >> box[4] >> box[5] >> cost){
+            for(int i=0; i<6; i++) boxes.push_back(box[i]);
+            factors.push_back(cost);
+         }
+      }
+
+      // normalise factors to mean of one, ignoring domains with no measurement
+      double sum=0.0;
+      int count=0;
+      for(unsigned int i=0; i<factors.size(); i++){
+         if(factors[i]>0.0){
+            sum+=factors[i];
+            count++;
+         }
+      }
+      const double mean = count > 0 ? sum/double(count) : 1.0;
+      for(unsigned int i=0; i<factors.size(); i++) factors[i] = factors[i] > 0.0 ? factors[i]/mean : 1.0;
+
+      zlog << zTs() << "Read measured costs for " << factors.size() << " domains from mpi-load-balance" << std::endl;
+
+      return;
+
+   }
+
+   void check_empty_domains(std::vector<cs::catom_t> &);
+
+   //------------------------------------------------------------------------------------------------------
+   // Function to calculate the estimated cost and unit cell bin of each local atom. The cost of an atom is
+   // one plus its number of bonds, scaled by measured costs if requested. Returns the local total cost.
+   //------------------------------------------------------------------------------------------------------
+   double calculate_atom_costs(std::vector<cs::catom_t> & catom_array, std::vector<double>& cost, std::vector<int>& bin, int nb[3]){
+
+      // unit cell resolution for partition planes
+      const double ucd[3] = {cs::unit_cell.dimensions[0], cs::unit_cell.dimensions[1], cs::unit_cell.dimensions[2]};
+      for(int i=0; i<3; i++) nb[i] = std::max(1,int(cs::total_num_unit_cells[i]));
+
+      // cost of each unit cell atom (self + bonds)
+      std::vector<double> uc_cost(cs::unit_cell.atom.size());
+      for(unsigned int i=0; i<cs::unit_cell.atom.size(); i++) uc_cost[i] = 1.0 + double(cs::unit_cell.atom[i].ni);
+
+      // measured cost factors from previous run
+      std::vector<double> boxes;
+      std::vector<double> factors;
+      if(vmpi::load_balance_measured) read_measured_costs(boxes, factors);
+
+      const int num_atoms = catom_array.size();
+      cost.resize(num_atoms);
+      bin.resize(3*num_atoms);
+
+      vmpi::local_atom_cost=0.0;
+      double local_cost=0.0;
+      for(int atom=0; atom<num_atoms; atom++){
+         const double r[3] = {catom_array[atom].x, catom_array[atom].y, catom_array[atom].z};
+         double c = uc_cost[catom_array[atom].uc_id];
+         vmpi::local_atom_cost += c;
+
+         // scale by measured cost of region in previous run
+         for(unsigned int d=0; d<factors.size(); d++){
+            const double* box = &boxes[6*d];
+            if(r[0]>=box[0] && r[0]<box[3] && r[1]>=box[1] && r[1]<box[4] && r[2]>=box[2] && r[2]<box[5]){
+               c*=factors[d];
+               break;
+            }
+         }
+         cost[atom]=c;
+         local_cost+=c;
+
+         for(int i=0; i<3; i++){
+            int b = int(r[i]/ucd[i]);
+            if(b<0) b=0;
+            if(b>=nb[i]) b=nb[i]-1;
+            bin[3*atom+i]=b;
+         }
+      }
+
+      return local_cost;
+
+   }
+
+   //------------------------------------------------------------------------------------------------------
+   // Function to regenerate local atoms after the domain of the local process has changed
+   //------------------------------------------------------------------------------------------------------
+   void regenerate_local_atoms(std::vector<cs::catom_t> & catom_array){
+
+      zlog << zTs() << "Local domain: " << vmpi::min_dimensions[0] << " - " << vmpi::max_dimensions[0] << ", "
+                                        << vmpi::min_dimensions[1] << " - " << vmpi::max_dimensions[1] << ", "
+                                        << vmpi::min_dimensions[2] << " - " << vmpi::max_dimensions[2] << std::endl;
+
+      catom_array.resize(0);
+      cs::create_crystal_structure(catom_array);
+      cs::create_system_type(catom_array);
+
+      // Update local cost for measured balancing
+      vmpi::local_atom_cost=0.0;
+      for(unsigned int atom=0; atom<catom_array.size(); atom++) vmpi::local_atom_cost += 1.0 + double(cs::unit_cell.atom[catom_array[atom].uc_id].ni);
+
+      check_empty_domains(catom_array);
+
+      return;
+
+   }
+
+   //------------------------------------------------------------------------------------------------------
+   // Function to move geometric decomposition planes so that each process has the same estimated cost.
+   // If the imbalance of the equal volume decomposition exceeds the threshold the local atoms are
+   // regenerated within the new domain. This is done once during creation; the partition is not
+   // changed while the simulation runs.
+   //------------------------------------------------------------------------------------------------------
+   void load_balance_decomposition(std::vector<cs::catom_t> & catom_array){
+
+      // check calling of routine if error checking is activated
+      if(err::check==true){std::cout << "vmpi::load_balance_decomposition has been called" << std::endl;}
+
+      const int nx = vmpi::num_domains[0];
+      const int ny = vmpi::num_domains[1];
+      const int nz = vmpi::num_domains[2];
+
+      // unit cell resolution for partition planes
+      const double ucd[3] = {cs::unit_cell.dimensions[0], cs::unit_cell.dimensions[1], cs::unit_cell.dimensions[2]};
+      int nb[3];
+
+      // Calculate cost and bin of each local atom
+      const int num_atoms = catom_array.size();
+      std::vector<double> cost;
+      std::vector<int> bin;
+      const double local_cost = calculate_atom_costs(catom_array, cost, bin, nb);
+
+      // Determine imbalance of current decomposition
+      double max_cost=0.0;
+      double total_cost=0.0;
+      MPI_Allreduce(&local_cost, &max_cost, 1, MPI_DOUBLE, MPI_MAX, MPI_COMM_WORLD);
+      MPI_Allreduce(&local_cost, &total_cost, 1, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
+      const double mean_cost = total_cost/double(vmpi::num_processors);
+      const double imbalance = mean_cost > 0.0 ? max_cost/mean_cost : 1.0;
+
+      zlog << zTs() << "Load imbalance (maximum/average cost) for equal volume decomposition: " << imbalance << std::endl;
+
+      if(imbalance <= vmpi::load_balance_threshold){
+         check_empty_domains(catom_array);
+         return;
+      }
+
+      //-------------------------------------------------------------
+      // x planes from global profile
+      //-------------------------------------------------------------
+      std::vector<double> profile_x(nb[0],0.0);
+      for(int atom=0; atom<num_atoms; atom++) profile_x[bin[3*atom+0]]+=cost[atom];
+      MPI_Allreduce(MPI_IN_PLACE, &profile_x[0], nb[0], MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
+
+      std::vector<int> planes_x;
+      bool ok = partition_profile(profile_x, nx, planes_x);
+
+      //-------------------------------------------------------------
+      // y planes for each x slab
+      //-------------------------------------------------------------
+      std::vector<double> profile_y(nx*nb[1],0.0);
+      for(int atom=0; atom<num_atoms; atom++){
+         const int ix = find_part(planes_x, bin[3*atom+0]);
+         profile_y[ix*nb[1]+bin[3*atom+1]]+=cost[atom];
+      }
+      MPI_Allreduce(MPI_IN_PLACE, &profile_y[0], nx*nb[1], MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
+
+      std::vector<std::vector<int> > planes_y(nx);
+      for(int ix=0; ix<nx; ix++){
+         std::vector<double> slab(profile_y.begin()+ix*nb[1], profile_y.begin()+(ix+1)*nb[1]);
+         ok = partition_profile(slab, ny, planes_y[ix]) && ok;
+      }
+
+      //-------------------------------------------------------------
+      // z planes for each x-y column
+      //-------------------------------------------------------------
+      std::vector<double> profile_z(nx*ny*nb[2],0.0);
+      for(int atom=0; atom<num_atoms; atom++){
+         const int ix = find_part(planes_x, bin[3*atom+0]);
+         const int iy = find_part(planes_y[ix], bin[3*atom+1]);
+         profile_z[(ix*ny+iy)*nb[2]+bin[3*atom+2]]+=cost[atom];
+      }
+      MPI_Allreduce(MPI_IN_PLACE, &profile_z[0], nx*ny*nb[2], MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
+
+      std::vector<std::vector<int> > planes_z(nx*ny);
+      double new_max_cost=0.0;
+      for(int col=0; col<nx*ny; col++){
+         std::vector<double> column(profile_z.begin()+col*nb[2], profile_z.begin()+(col+1)*nb[2]);
+         ok = partition_profile(column, nz, planes_z[col]) && ok;
+         // estimate cost of new domains
+         for(int iz=0; iz<nz; iz++){
+            double domain_cost=0.0;
+            for(int b=planes_z[col][iz]; b<planes_z[col][iz+1]; b++) domain_cost+=column[b];
+            if(domain_cost>new_max_cost) new_max_cost=domain_cost;
+         }
+      }
+      const double new_imbalance = mean_cost > 0.0 ? new_max_cost/mean_cost : 1.0;
+
+      if(!ok || new_imbalance >= imbalance){
+         zlog << zTs() << "Load balancing unable to improve decomposition, keeping equal volume domains" << std::endl;
+         check_empty_domains(catom_array);
+         return;
+      }
+
+      //-------------------------------------------------------------
+      // Set new domain for local process
+      //-------------------------------------------------------------
+      const int my_rank_x = int(vmpi::my_rank%(nx*ny)/ny);
+      const int my_rank_y = (vmpi::my_rank%(nx*ny))%ny;
+      const int my_rank_z = int(vmpi::my_rank/(nx*ny));
+      const int col = my_rank_x*ny+my_rank_y;
+
+      // outer domain faces stay on the system boundary
+      vmpi::min_dimensions[0] = double(planes_x[my_rank_x])*ucd[0];
+      vmpi::max_dimensions[0] = my_rank_x==nx-1 ? cs::system_dimensions[0] : double(planes_x[my_rank_x+1])*ucd[0];
+      vmpi::min_dimensions[1] = double(planes_y[my_rank_x][my_rank_y])*ucd[1];
+      vmpi::max_dimensions[1] = my_rank_y==ny-1 ? cs::system_dimensions[1] : double(planes_y[my_rank_x][my_rank_y+1])*ucd[1];
+      vmpi::min_dimensions[2] = double(planes_z[col][my_rank_z])*ucd[2];
+      vmpi::max_dimensions[2] = my_rank_z==nz-1 ? cs::system_dimensions[2] : double(planes_z[col][my_rank_z+1])*ucd[2];
+
+      if(vmpi::my_rank==0){
+         std::cout << "Load balancing moved partition planes, estimated imbalance " << imbalance << " -> " << new_imbalance << std::endl;
+      }
+      zlog << zTs() << "Load balancing moved partition planes, estimated imbalance " << imbalance << " -> " << new_imbalance << std::endl;
+
+      // Regenerate local atoms within new domain
+      regenerate_local_atoms(catom_array);
+
+      return;
+
+   }
+
+   //------------------------------------------------------------------------------------------------------
+   // Function to set an initial decomposition into equal slabs along the longest system dimension. This
+   // works for any number of processors and is used to generate atoms for recursive bisection and
+   // replicated data decompositions.
+   //------------------------------------------------------------------------------------------------------
+   void slab_decomposition(int num_cpus, double system_dimensions[3]){
+
+      // check calling of routine if error checking is activated
+      if(err::check==true){std::cout << "vmpi::slab_decomposition has been called" << std::endl;}
+
+      int axis=0;
+      for(int i=1; i<3; i++) if(system_dimensions[i] > system_dimensions[axis]) axis=i;
+
+      for(int i=0; i<3; i++){
+         vmpi::min_dimensions[i]=0.0;
+         vmpi::max_dimensions[i]=system_dimensions[i];
+      }
+
+      const double d = system_dimensions[axis]/double(num_cpus);
+      vmpi::min_dimensions[axis] = double(vmpi::my_rank)*d;
+      vmpi::max_dimensions[axis] = vmpi::my_rank==num_cpus-1 ? system_dimensions[axis] : double(vmpi::my_rank+1)*d;
+
+      return;
+
+   }
+
+   //------------------------------------------------------------------------------------------------------
+   // Function to move the planes of the initial slab decomposition so that each process holds the same
+   // number of atoms, as the replicated data decomposition divides the system by atom number. Planes are
+   // placed on unit cell boundaries and local atoms are regenerated if the domain has changed.
+   //------------------------------------------------------------------------------------------------------
+   void replicated_data_decomposition(std::vector<cs::catom_t> & catom_array){
+
+      // check calling of routine if error checking is activated
+      if(err::check==true){std::cout << "vmpi::replicated_data_decomposition has been called" << std::endl;}
+
+      const double ucd[3] = {cs::unit_cell.dimensions[0], cs::unit_cell.dimensions[1], cs::unit_cell.dimensions[2]};
+
+      // slab axis is the longest system dimension, as in slab_decomposition
+      int axis=0;
+      for(int i=1; i<3; i++) if(cs::system_dimensions[i] > cs::system_dimensions[axis]) axis=i;
+      const int num_bins = std::max(1,int(cs::total_num_unit_cells[axis]));
+
+      // global profile of atom numbers along slab axis
+      const int num_atoms = catom_array.size();
+      std::vector<double> profile(num_bins,0.0);
+      for(int atom=0; atom<num_atoms; atom++){
+         const double r[3] = {catom_array[atom].x, catom_array[atom].y, catom_array[atom].z};
+         int b = int(r[axis]/ucd[axis]);
+         if(b<0) b=0;
+         if(b>=num_bins) b=num_bins-1;
+         profile[b]+=1.0;
+      }
+      MPI_Allreduce(MPI_IN_PLACE, &profile[0], num_bins, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
+
+      std::vector<int> planes;
+      if(partition_profile(profile, vmpi::num_processors, planes)==false){
+         terminaltextcolor(RED);
+         std::cerr << "Error - replicated data decomposition requires at least one unit cell per processor along the longest system dimension - reduce the number of processors or increase system size!" << std::endl;
+         terminaltextcolor(WHITE);
+         zlog << zTs() << "Error - replicated data decomposition requires at least one unit cell per processor along the longest system dimension - reduce the number of processors or increase system size!" << std::endl;
+         err::vexit();
+      }
+
+      // determine imbalance of new slabs
+      double total_atoms=0.0;
+      double max_atoms=0.0;
+      for(int p=0; p<vmpi::num_processors; p++){
+         double slab_atoms=0.0;
+         for(int b=planes[p]; b<planes[p+1]; b++) slab_atoms+=profile[b];
+         total_atoms+=slab_atoms;
+         if(slab_atoms>max_atoms) max_atoms=slab_atoms;
+      }
+      const double mean_atoms = total_atoms/double(vmpi::num_processors);
+      const double imbalance = mean_atoms > 0.0 ? max_atoms/mean_atoms : 1.0;
+
+      // outer domain faces stay on the system boundary
+      const double old_min = vmpi::min_dimensions[axis];
+      const double old_max = vmpi::max_dimensions[axis];
+      vmpi::min_dimensions[axis] = double(planes[vmpi::my_rank])*ucd[axis];
+      vmpi::max_dimensions[axis] = vmpi::my_rank==vmpi::num_processors-1 ? cs::system_dimensions[axis] : double(planes[vmpi::my_rank+1])*ucd[axis];
+
+      if(vmpi::my_rank==0){
+         std::cout << "System decomposed into " << vmpi::num_processors << " slabs for replicated data, estimated imbalance " << imbalance << std::endl;
+      }
+      zlog << zTs() << "System decomposed into " << vmpi::num_processors << " slabs for replicated data, estimated imbalance " << imbalance << std::endl;
+
+      // Regenerate local atoms only if domain has changed
+      if(vmpi::min_dimensions[axis]!=old_min || vmpi::max_dimensions[axis]!=old_max) regenerate_local_atoms(catom_array);
+      else check_empty_domains(catom_array);
+
+      return;
+
+   }
+
+   /// Structure to store a box of unit cells and the processors assigned to it
+   struct bisection_box_t{
+
+      int lo[3]; // first unit cell in x,y,z
+      int hi[3]; // last+1 unit cell in x,y,z
+      int first_rank; // first processor assigned to box
+      int num_ranks; // number of processors assigned to box
+      double cost; // total cost of atoms in box
+
+   };
+
+   //------------------------------------------------------------------------------------------------------
+   // Function to decompose the system by recursive coordinate bisection. Each box is cut along its longest
+   // dimension at the weighted median (in units of unit cells) so that the cost of the two halves is in
+   // proportion to the number of processors assigned to them, giving compact domains for any processor
+   // count. All processors compute the same tree, so only the cost profiles need to be reduced.
+   //------------------------------------------------------------------------------------------------------
+   void recursive_bisection_decomposition(std::vector<cs::catom_t> & catom_array){
+
+      // check calling of routine if error checking is activated
+      if(err::check==true){std::cout << "vmpi::recursive_bisection_decomposition has been called" << std::endl;}
+
+      const double ucd[3] = {cs::unit_cell.dimensions[0], cs::unit_cell.dimensions[1], cs::unit_cell.dimensions[2]};
+      int nb[3];
+
+      // Calculate cost and bin of each local atom
+      const int num_atoms = catom_array.size();
+      std::vector<double> cost;
+      std::vector<int> bin;
+      double total_cost = calculate_atom_costs(catom_array, cost, bin, nb);
+      MPI_Allreduce(MPI_IN_PLACE, &total_cost, 1, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
+
+      // Initialise root box
+      bisection_box_t root;
+      for(int i=0; i<3; i++){
+         root.lo[i]=0;
+         root.hi[i]=nb[i];
+      }
+      root.first_rank=0;
+      root.num_ranks=vmpi::num_processors;
+      root.cost=total_cost;
+
+      std::vector<bisection_box_t> boxes(1,root);
+      std::vector<bisection_box_t> leaves(0);
+      leaves.reserve(vmpi::num_processors);
+
+      // Bisect boxes in the same order on all processors
+      for(unsigned int idx=0; idx<boxes.size(); idx++){
+
+         const bisection_box_t box = boxes[idx];
+         if(box.num_ranks==1){
+            leaves.push_back(box);
+            continue;
+         }
+
+         // cut along longest dimension that can be cut
+         int axis=-1;
+         for(int i=0; i<3; i++){
+            if(box.hi[i]-box.lo[i] < 2) continue;
+            if(axis<0 || double(box.hi[i]-box.lo[i])*ucd[i] > double(box.hi[axis]-box.lo[axis])*ucd[axis]) axis=i;
+         }
+         if(axis<0){
+            terminaltextcolor(RED);
+            std::cerr << "Error - system too small to be decomposed by recursive bisection onto " << vmpi::num_processors << " processors. Exiting." << std::endl;
+            terminaltextcolor(WHITE);
+            zlog << zTs() << "Error - system too small to be decomposed by recursive bisection onto " << vmpi::num_processors << " processors. Exiting." << std::endl;
+            err::vexit();
+         }
+
+         // cost profile of box along axis
+         const int num_bins = box.hi[axis]-box.lo[axis];
+         std::vector<double> profile(num_bins,0.0);
+         for(int atom=0; atom<num_atoms; atom++){
+            const int* b = &bin[3*atom];
+            if(b[0]>=box.lo[0] && b[0]<box.hi[0] && b[1]>=box.lo[1] && b[1]<box.hi[1] && b[2]>=box.lo[2] && b[2]<box.hi[2]){
+               profile[b[axis]-box.lo[axis]]+=cost[atom];
+            }
+         }
+         MPI_Allreduce(MPI_IN_PLACE, &profile[0], num_bins, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
+
+         // find cut closest to weighted median
+         const int n1 = box.num_ranks/2;
+         const double target = box.cost*double(n1)/double(box.num_ranks);
+         double cumulative = 0.0;
+         double best_cost = 0.0;
+         int cut = 1;
+         double best = 1.0e300;
+         for(int b=1; b<num_bins; b++){
+            cumulative+=profile[b-1];
+            if(fabs(cumulative-target) < best){
+               best = fabs(cumulative-target);
+               best_cost = cumulative;
+               cut = b;
+            }
+         }
+
+         bisection_box_t lower = box;
+         bisection_box_t upper = box;
+         lower.hi[axis] = box.lo[axis]+cut;
+         upper.lo[axis] = box.lo[axis]+cut;
+         lower.num_ranks = n1;
+         upper.num_ranks = box.num_ranks-n1;
+         upper.first_rank = box.first_rank+n1;
+         lower.cost = best_cost;
+         upper.cost = box.cost-best_cost;
+
+         boxes.push_back(lower);
+         boxes.push_back(upper);
+
+      }
+
+      // Determine imbalance and local box
+      double max_cost=0.0;
+      bisection_box_t my_box = root;
+      for(unsigned int l=0; l<leaves.size(); l++){
+         if(leaves[l].cost > max_cost) max_cost = leaves[l].cost;
+         if(leaves[l].first_rank==vmpi::my_rank) my_box = leaves[l];
+      }
+      const double mean_cost = total_cost/double(vmpi::num_processors);
+      const double imbalance = mean_cost > 0.0 ? max_cost/mean_cost : 1.0;
+
+      // outer domain faces stay on the system boundary
+      for(int i=0; i<3; i++){
+         vmpi::min_dimensions[i] = double(my_box.lo[i])*ucd[i];
+         vmpi::max_dimensions[i] = my_box.hi[i]==nb[i] ? cs::system_dimensions[i] : double(my_box.hi[i])*ucd[i];
+      }
+
+      if(vmpi::my_rank==0){
+         std::cout << "System decomposed by recursive coordinate bisection onto " << vmpi::num_processors << " CPUs, estimated imbalance " << imbalance << std::endl;
+      }
+      zlog << zTs() << "System decomposed by recursive coordinate bisection onto " << vmpi::num_processors << " CPUs, estimated imbalance " << imbalance << std::endl;
+
+      // Regenerate local atoms within new domain
+      regenerate_local_atoms(catom_array);
+
+      return;
+
+   }
+
+   //------------------------------------------------------------------------------------------------------
+   // Function to check that load balancing has left atoms on every process
+   //------------------------------------------------------------------------------------------------------
+   void check_empty_domains(std::vector<cs::catom_t> & catom_array){
+
+      if(catom_array.size()==0){
+         terminaltextcolor(RED);
+         std::cerr << "Error, no atoms generated on rank " << vmpi::my_rank << " after load balancing - reduce the number of processors or increase system size!" << std::endl;
+         terminaltextcolor(WHITE);
+         zlog << zTs() << "Error, no atoms generated on rank " << vmpi::my_rank << " after load balancing - reduce the number of processors or increase system size!" << std::endl;
+         err::vexit();
+      }
+
+      return;
+
+   }
+
+   //------------------------------------------------------------------------------------------------------
+   // Function to save measured compute time per unit cost for each domain, used to weight atoms with
+   // sim:mpi-load-balance = measured in subsequent runs (the current run is not repartitioned)
+   //------------------------------------------------------------------------------------------------------
+   void save_load_balance_data(){
+
+      if(vmpi::load_balance==false && vmpi::mpi_mode!=3) return;
+
+      // total compute time on local process
+      double compute_time = vmpi::TotalComputeTime;
+      for(unsigned int i=0; i<vmpi::ComputeTimeArray.size(); i++) compute_time += vmpi::ComputeTimeArray[i];
+
+      std::vector<double> local_data(7);
+      for(int i=0; i<3; i++){
+         local_data[i] = vmpi::min_dimensions[i];
+         local_data[3+i] = vmpi::max_dimensions[i];
+      }
+      local_data[6] = vmpi::local_atom_cost > 0.0 ? compute_time/vmpi::local_atom_cost : 0.0;
+
+      std::vector<double> data(0);
+      if(vmpi::my_rank==0) data.resize(7*vmpi::num_processors);
+      MPI_Gather(local_data.data(), 7, MPI_DOUBLE, data.data(), 7, MPI_DOUBLE, 0, MPI_COMM_WORLD); // receive buffer only used on root
+
+      if(vmpi::my_rank==0){
+         std::ofstream ofile("mpi-load-balance");
+         ofile << "# Measured costs for static load balancing of the next run (sim:mpi-load-balance = measured)" << std::endl;
+         ofile << "# rank\tmin_x\tmin_y\tmin_z\tmax_x\tmax_y\tmax_z\tcompute time per unit cost" << std::endl;
+         for(int p=0; p<vmpi::num_processors; p++){
+            ofile << p;
+            for(int i=0; i<7; i++) ofile << "\t" << data[7*p+i];
+            ofile << std::endl;
+         }
+         ofile.close();
+         zlog << zTs() << "Measured costs per domain saved to file mpi-load-balance for profile-guided decomposition of the next run" << std::endl;
+      }
+
+      return;
+
+   }
+
+} // end of namespace vmpi
+
+#endif
@@ -0,0 +1,134 @@
+//-----------------------------------------------------------------------------
+//
+// This source file is part of the VAMPIRE open source package under the
+// GNU GPL (version 2) licence (see licence file for details).
+//
+// (c) R F L Evans 2016. All rights reserved.
+//
+//-----------------------------------------------------------------------------
+//
+// Statistical parallelism (mpi-mode = statistical-parallelism)
+//
+// Every processor generates the complete system and integrates it with the
+// serial integrators and its own random number seed. The parameter loop of
+// the program (temperatures, constraint angles, hysteresis sweep rates) is
+// divided into contiguous blocks, one per processor, so no communication is
+// needed during the simulation. Statistics are reduced over the
+// communicator returned by statistics_communicator(), which contains only
+// the local processor in this mode. Each processor writes the output for
+// its block to a separate file which is appended to the main output file in
+// rank order at the end, giving the same ordering as a serial calculation.
+//
+//-----------------------------------------------------------------------------
+
+// C++ standard library headers
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+// Vampire headers
+#include "errors.hpp"
+#include "vio.hpp"
+#include "vmpi.hpp"
+
+namespace vmpi{
+
+   //------------------------------------------------------------------------------------------------------
+   // Function to determine the range of points [first_point, last_point) of a program parameter loop
+   // computed on the local processor. All points are local unless running in statistical parallel mode.
+   //------------------------------------------------------------------------------------------------------
+   void statistical_range(const int num_points, int& first_point, int& last_point){
+
+      first_point = 0;
+      last_point = num_points;
+
+      #ifdef MPICF
+         if(vmpi::mpi_mode==2){
+            // divide points as evenly as possible, with spare points on lowest ranks
+            const int base = num_points/vmpi::num_processors;
+            const int spare = num_points%vmpi::num_processors;
+            first_point = vmpi::my_rank*base + (vmpi::my_rank < spare ? vmpi::my_rank : spare);
+            last_point = first_point + base + (vmpi::my_rank < spare ? 1 : 0);
+
+            zlog << zTs() << "Statistical parallelism: simulating points " << first_point << " to " << last_point-1 << " of " << num_points << std::endl;
+         }
+      #endif
+
+      return;
+
+   }
+
+   #ifdef MPICF
+   //------------------------------------------------------------------------------------------------------
+   // Function to return the communicator for reductions of statistics over the atoms of the system.
+   // Each processor holds the complete system in statistical parallel mode, so no reduction is needed.
+   //------------------------------------------------------------------------------------------------------
+   MPI_Comm statistics_communicator(){
+      if(vmpi::mpi_mode==2) return MPI_COMM_SELF;
+      else return MPI_COMM_WORLD;
+   }
+   #endif
+
+   //------------------------------------------------------------------------------------------------------
+   // Function to return the name of the output file written by the local processor
+   //------------------------------------------------------------------------------------------------------
+   std::string output_file_name(){
+
+      std::stringstream filename;
+      filename << "output";
+
+      #ifdef MPICF
+         if(vmpi::mpi_mode==2 && vmpi::my_rank!=0) filename << "." << vmpi::my_rank;
+      #endif
+
+      return filename.str();
+
+   }
+
+   //------------------------------------------------------------------------------------------------------
+   // Function to append output files from all processors to the main output file in rank order
+   //------------------------------------------------------------------------------------------------------
+   void collate_statistical_output(){
+
+      #ifdef MPICF
+
+         if(vmpi::mpi_mode!=2) return;
+
+         // check calling of routine if error checking is activated
+         if(err::check==true){std::cout << "vmpi::collate_statistical_output has been called" << std::endl;}
+
+         // ensure all data is on disk before collating
+         if(zmag.is_open()) zmag.close();
+         MPI::COMM_WORLD.Barrier();
+
+         if(vmpi::my_rank==0){
+
+            std::ofstream output;
+            output.open("output",std::ofstream::app);
+
+            for(int p=1; p<vmpi::num_processors; p++){
+               std::stringstream filename;
+               filename << "output." << p;
+               std::ifstream partial(filename.str().c_str());
+               if(!partial.is_open()) continue;
+               // copy data if any
+               if(partial.peek()!=std::ifstream::traits_type::eof()) output << partial.rdbuf();
+               partial.close();
+               std::remove(filename.str().c_str());
+            }
+
+            output.close();
+
+            zlog << zTs() << "Output data from " << vmpi::num_processors << " processors collated into output file" << std::endl;
+
+         }
+
+      #endif
+
+      return;
+
+   }
+
+}
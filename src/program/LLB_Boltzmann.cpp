@@ -99,6 +99,7 @@ int LLB_Boltzmann(){
 			atoms::y_spin_array[atom]=0.0;
 			atoms::z_spin_array[atom]=1.0;
 	}
+	sim::mc_material_magnetization_valid=false;
 	
 	for(int T=300;T<310;T+=10){
 		sim::temperature=double(T);
@@ -93,6 +93,15 @@ void cmc_anisotropy(){
 		err::zexit("Program CMC-anisotropy requires Constrained Monte Carlo as the integrator. Check input file.");
 	}
 	
+	// Determine constraint directions simulated on this processor (a block of them in statistical parallel mode)
+	int num_directions=0;
+	for(double theta=sim::constraint_theta_min; theta<=sim::constraint_theta_max; theta+=sim::constraint_theta_delta){
+		for(double phi=sim::constraint_phi_min; phi<=sim::constraint_phi_max; phi+=sim::constraint_phi_delta) num_directions++;
+	}
+	int first_direction, last_direction;
+	vmpi::statistical_range(num_directions, first_direction, last_direction);
+	int direction=0;
+
 	// set minimum rotational angle
 	sim::constraint_theta=sim::constraint_theta_min;
 
@@ -104,55 +113,61 @@ void cmc_anisotropy(){
 
 		// perform azimuthal angle sweep
 		while(sim::constraint_phi<=sim::constraint_phi_max){
-			
-			// Re-initialise spin moments for CMC
-			sim::CMCinit();
-			
-			// Set starting temperature
-			sim::temperature=sim::Tmin;
-			
-			// Perform Temperature Loop
-			while(sim::temperature<=sim::Tmax){
-
-				// Equilibrate system
-				sim::integrate(sim::equilibration_time);
-				
-				// Reset mean magnetisation counters
-				stats::mag_m_reset();
-				
-				// Reset start time
-				int start_time=sim::time;
-
-				// Simulate system
-				while(sim::time<sim::loop_time+start_time){
-					
-					// Integrate system
-					sim::integrate(sim::partial_time);
-				
-					// Calculate magnetisation statistics
-					stats::mag_m();
-
-				}
-				
-				// Output data
-				vout::data();
-				
-				// Increment temperature
-				sim::temperature+=sim::delta_temperature;
-				
-			} // End of temperature loop
-			
+
+			if(direction>=first_direction && direction<last_direction){
+
+				// Re-initialise spin moments for CMC
+				sim::CMCinit();
+
+				// Set starting temperature
+				sim::temperature=sim::Tmin;
+
+				// Perform Temperature Loop
+				while(sim::temperature<=sim::Tmax){
+
+					// Equilibrate system
+					sim::integrate(sim::equilibration_time);
+
+					// Reset mean magnetisation counters
+					stats::mag_m_reset();
+
+					// Reset start time
+					int start_time=sim::time;
+
+					// Simulate system
+					while(sim::time<sim::loop_time+start_time){
+
+						// Integrate system
+						sim::integrate(sim::partial_time);
+
+						// Calculate magnetisation statistics
+						stats::mag_m();
+
+					}
+
+					// Output data
+					vout::data();
+
+					// Increment temperature
+					sim::temperature+=sim::delta_temperature;
+
+				} // End of temperature loop
+
+			}
+			direction++;
+
 			// Increment azimuthal angle
 			sim::constraint_phi+=sim::constraint_phi_delta;
 			sim::constraint_phi_changed=true;
-			
+
 		} // End of azimuthal angle sweep
-      if(vout::gnuplot_array_format) zmag << std::endl;
+		// block separator is written by the processor simulating the last direction of the sweep
+		if(vout::gnuplot_array_format && direction>first_direction && direction<=last_direction) zmag << std::endl;
 
 		// Increment rotational angle
 		sim::constraint_theta+=sim::constraint_theta_delta;
 		sim::constraint_theta_changed=true;
-		
+
 	} // End of rotational angle sweep
 
 	return;
@@ -93,42 +93,64 @@ int curie_temperature(){
 	// check calling of routine if error checking is activated
 	if(err::check==true){std::cout << "program::curie_temperature has been called" << std::endl;}
 
+	// Determine temperatures simulated on this processor (a block of them in statistical parallel mode)
+	int num_temperatures=0;
+	for(double T=sim::Tmin; T<=sim::Tmax; T+=sim::delta_temperature) num_temperatures++;
+	int first_temperature, last_temperature;
+	vmpi::statistical_range(num_temperatures, first_temperature, last_temperature);
+
 	// Set starting temperature
     // Initialise sim::temperature
+	int temperature_index=0;
 	if(sim::load_checkpoint_flag && sim::load_checkpoint_continue_flag){
 		sim::temperature+=sim::delta_temperature;
+		temperature_index=vmath::iround((sim::temperature-sim::Tmin)/sim::delta_temperature);
     }
     else sim::temperature=sim::Tmin;
 
 	// Perform Temperature Loop
 	while(sim::temperature<=sim::Tmax){
 
-		// Equilibrate system only if not checkpoint
-	   if(sim::load_checkpoint_flag && sim::load_checkpoint_continue_flag){}
-		else sim::integrate(sim::equilibration_time);
+		if(temperature_index>=first_temperature && temperature_index<last_temperature){
 
-		// Reset mean magnetisation counters
-		stats::mag_m_reset();
+			// Equilibrate system only if not checkpoint
+		   if(sim::load_checkpoint_flag && sim::load_checkpoint_continue_flag){}
+			else sim::integrate(sim::equilibration_time);
 
-		// Reset start time
-		int start_time=sim::time;
+			// Reset mean magnetisation counters
+			stats::mag_m_reset();
 
-		// Simulate system
-		while(sim::time<sim::loop_time+start_time){
+			// Reset start time
+			int start_time=sim::time;
 
-			// Integrate system
-			sim::integrate(sim::partial_time);
+			// Simulate system
+			while(sim::time<sim::loop_time+start_time){
 
-			// Calculate magnetisation statistics
-			stats::mag_m();
+				// Integrate system
+				sim::integrate(sim::partial_time);
 
-		}
+				// Calculate magnetisation statistics
+				stats::mag_m();
+
+				// Stop sampling once mean magnetisation is known to required accuracy
+				if(stats::sampling_converged()) break;
+
+			}
 
-		// Output data
-		vout::data();
+			// Output data
+			vout::data();
+
+			// Space samples at next temperature by the autocorrelation time
+			if(stats::adaptive_partial_time){
+				sim::partial_time=stats::decorrelated_partial_time(sim::partial_time, sim::loop_time);
+				zlog << zTs() << "Time steps increment set to " << sim::partial_time << " from autocorrelation time" << std::endl;
+			}
+
+		}
 
 		// Increment temperature
 		sim::temperature+=sim::delta_temperature;
+		temperature_index++;
 
 	} // End of temperature loop
 
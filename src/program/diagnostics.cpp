@@ -94,6 +94,7 @@ namespace program{
                atoms::y_spin_array[atom] = sy;
                atoms::z_spin_array[atom] = sz;
             }
+            sim::mc_material_magnetization_valid=false;
 
             sim::integrate(timesteps);
             stats::mag_m_reset();
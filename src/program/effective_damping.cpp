@@ -51,6 +51,9 @@ void rotate_spins_around_x_axis(double ddx){
 
    }
 
+   // spins no longer match magnetisation tracked by Monte Carlo integrator
+   sim::mc_material_magnetization_valid=false;
+
    return;
 
 }
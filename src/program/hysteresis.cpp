@@ -46,11 +46,13 @@
 #include <cstdlib>
 
 // Vampire Header files
+#include "atoms.hpp"
 #include "vmath.hpp"
 #include "errors.hpp"
 #include "sim.hpp"
 #include "stats.hpp"
 #include "vio.hpp"
+#include "vmpi.hpp"
 
 
 namespace program{
@@ -91,77 +93,129 @@ int hysteresis(){
 	int iH_old;
 	int start_time;
 
-	// Equilibrate system in saturation field
-	sim::H_applied=sim::Heq;
+	// Sweep rates to simulate, each given by the time steps at each field point. In statistical
+	// parallel mode each processor simulates a block of sweep rates.
+	std::vector<uint64_t> loop_times=sim::hysteresis_loop_times;
+	if(loop_times.size()==0) loop_times.push_back(sim::loop_time);
+	const int num_sweeps=loop_times.size();
+	int first_sweep, last_sweep;
+	vmpi::statistical_range(num_sweeps, first_sweep, last_sweep);
+
+	// checkpoints do not record the sweep rate
+	if(num_sweeps>1 && sim::load_checkpoint_flag && sim::load_checkpoint_continue_flag){
+		terminaltextcolor(RED);
+		std::cerr << "Error - continuing from a checkpoint is not supported for hysteresis loops at several sweep rates. Exiting" << std::endl;
+		terminaltextcolor(WHITE);
+		zlog << zTs() << "Error - continuing from a checkpoint is not supported for hysteresis loops at several sweep rates. Exiting" << std::endl;
+		err::vexit();
+	}
+
+	// Each sweep starts from the initial state, so that results do not depend on the division of sweeps
+	std::vector<double> initial_x_spin, initial_y_spin, initial_z_spin;
+	if(last_sweep-first_sweep>1){
+		initial_x_spin=atoms::x_spin_array;
+		initial_y_spin=atoms::y_spin_array;
+		initial_z_spin=atoms::z_spin_array;
+	}
+	const int initial_partial_time=sim::partial_time;
+
+	// Perform sweep rate loop
+	for(int sweep=first_sweep; sweep<last_sweep; sweep++){
+
+		if(sweep>first_sweep){
+			atoms::x_spin_array=initial_x_spin;
+			atoms::y_spin_array=initial_y_spin;
+			atoms::z_spin_array=initial_z_spin;
+			sim::mc_material_magnetization_valid=false;
+			sim::partial_time=initial_partial_time;
+			sim::parity=-1;
+		}
 
-	// Initialise sim::integrate only if it not a checkpoint
-	if(sim::load_checkpoint_flag && sim::load_checkpoint_continue_flag){}
-	else sim::integrate(sim::equilibration_time);
+		sim::loop_time=loop_times[sweep];
+		if(num_sweeps>1) zlog << zTs() << "Simulating hysteresis loop with " << sim::loop_time << " time steps per field point" << std::endl;
 
-   // Hinc must be positive
-	int iHinc=vmath::iround(double(fabs(sim::Hinc))*1.0E6);
+		// Equilibrate system in saturation field
+		sim::H_applied=sim::Heq;
 
-   int Hfield;
-   int iparity=sim::parity;
-	parity_old=iparity;
+		// Initialise sim::integrate only if it not a checkpoint
+		if(sim::load_checkpoint_flag && sim::load_checkpoint_continue_flag){}
+		else sim::integrate(sim::equilibration_time);
 
-   // Save value of iH from previous simulation
-	if(sim::load_checkpoint_continue_flag) iH_old=int(sim::iH);
+	   // Hinc must be positive
+		int iHinc=vmath::iround(double(fabs(sim::Hinc))*1.0E6);
 
-	// Perform Field Loop -parity
-	while(iparity<2){
+	   int Hfield;
+	   int iparity=sim::parity;
+		parity_old=iparity;
 
-		if(sim::load_checkpoint_flag && sim::load_checkpoint_continue_flag){
+	   // Save value of iH from previous simulation
+		if(sim::load_checkpoint_continue_flag) iH_old=int(sim::iH);
 
-         //necessary to upload value of iH_old when loading the checkpoint !!!
-		   iH_old=int(sim::iH);
-			if(parity_old<0){
-				if(iparity<0) miHmax=iH_old;
-				else if(iparity>0 && iH_old<=0) miHmax=iH_old; //miHmax=(iHmax-iHinc);
-				else if(iparity>0 && iH_old>0) miHmax=-(iHmax);
-			}
-			else if(parity_old>0) miHmax=iH_old;
-			Hfield=miHmax;
-		}
-		else	Hfield=miHmax;
+		// Perform Field Loop -parity
+		while(iparity<2){
 
-		// Perform Field Loop -field
-		while(Hfield<=iHmax){
+			if(sim::load_checkpoint_flag && sim::load_checkpoint_continue_flag){
+
+	         //necessary to upload value of iH_old when loading the checkpoint !!!
+			   iH_old=int(sim::iH);
+				if(parity_old<0){
+					if(iparity<0) miHmax=iH_old;
+					else if(iparity>0 && iH_old<=0) miHmax=iH_old; //miHmax=(iHmax-iHinc);
+					else if(iparity>0 && iH_old>0) miHmax=-(iHmax);
+				}
+				else if(parity_old>0) miHmax=iH_old;
+				Hfield=miHmax;
+			}
+			else	Hfield=miHmax;
 
-			// Set applied field (Tesla)
-			sim::H_applied=double(Hfield)*double(iparity)*1.0e-6;
+			// Perform Field Loop -field
+			while(Hfield<=iHmax){
 
-			// Reset start time
-			start_time=sim::time;
+				// Set applied field (Tesla)
+				sim::H_applied=double(Hfield)*double(iparity)*1.0e-6;
 
-			// Reset mean magnetisation counters
-			stats::mag_m_reset();
+				// Reset start time
+				start_time=sim::time;
 
-			// Integrate system
-			while(sim::time<sim::loop_time+start_time){
+				// Reset mean magnetisation counters
+				stats::mag_m_reset();
 
 				// Integrate system
-				sim::integrate(sim::partial_time);
+				while(sim::time<sim::loop_time+start_time){
 
-				// Calculate mag_m, mag
-				stats::mag_m();
+					// Integrate system
+					sim::integrate(sim::partial_time);
 
-			}
+					// Calculate mag_m, mag
+					stats::mag_m();
+
+					// Stop sampling once mean magnetisation is known to required accuracy
+					if(stats::sampling_converged()) break;
+
+				}
+
+				// Increment of iH
+				Hfield+=iHinc;
+				sim::iH=int64_t(Hfield); //sim::iH+=iHinc;
+
+				// Output to screen and file after each field
+				vout::data();
 
-			// Increment of iH
-			Hfield+=iHinc;
-			sim::iH=int64_t(Hfield); //sim::iH+=iHinc;
+				// Space samples at next field by the autocorrelation time
+				if(stats::adaptive_partial_time){
+					sim::partial_time=stats::decorrelated_partial_time(sim::partial_time, sim::loop_time);
+					zlog << zTs() << "Time steps increment set to " << sim::partial_time << " from autocorrelation time" << std::endl;
+				}
 
-			// Output to screen and file after each field
-			vout::data();
+			} // End of field loop
 
-		} // End of field loop
+			// Increment of parity
+	      iparity+=2;
+	      sim::parity=int64_t(iparity);
 
-		// Increment of parity
-      iparity+=2;
-      sim::parity=int64_t(iparity);
+		} // End of parity loop
 
-	} // End of parity loop
+	} // End of sweep rate loop
 
 	return EXIT_SUCCESS;
 
@@ -30,6 +30,9 @@ namespace program{
       err::vexit();
    }
 
+   // Local temperatures are now set by the localised temperature pulse
+   sim::localised_temperature_pulse_on=true;
+
    // Set equilibration temperature and field
    sim::temperature=sim::Teq;
 
@@ -108,6 +108,7 @@ void setting_process(){
 		atoms::z_spin_array[i] = Configurations[Array][2];
 
 	}
+	sim::mc_material_magnetization_valid=false;
 
 	// Calculate magnetisation statistics
 	stats::mag_m();
@@ -39,6 +39,7 @@
 #include "errors.hpp"
 #include "LLG.hpp"
 #include "vmpi.hpp"
+#include "vio.hpp"
 #include "random.hpp"
 
 #include <cmath>
@@ -111,6 +112,14 @@ int LLB(const int num_steps){
 	if(err::check==true){std::cout << "LLB has been called" << std::endl;}
 
 	#ifdef MPICF
+		// reduced precision halo encodings renormalise boundary spins, which loses the LLB spin length
+		if(vmpi::halo_encoding!=0){
+			terminaltextcolor(RED);
+			std::cerr << "Error - LLB integration requires sim:mpi-halo-encoding = double as other encodings do not preserve spin length, exiting" << std::endl;
+			terminaltextcolor(WHITE);
+			zlog << zTs() << "Error - LLB integration requires sim:mpi-halo-encoding = double as other encodings do not preserve spin length, exiting" << std::endl;
+			err::vexit();
+		}
 		//LLB_mpi(num_steps);
 	#else
 		LLB_serial_heun(num_steps);
@@ -174,6 +174,7 @@ int LLG_Heun(){
 	double mod_S;		// magnitude of spin moment 
 
 	// Store initial spin positions		
+	#pragma omp parallel for
 	for(int atom=0;atom<num_atoms;atom++){
 		x_initial_spin_array[atom] = atoms::x_spin_array[atom];
 		y_initial_spin_array[atom] = atoms::y_spin_array[atom];
@@ -185,6 +186,7 @@ int LLG_Heun(){
 	calculate_external_fields(0,num_atoms);
 	
 	// Calculate Euler Step
+	#pragma omp parallel for private(xyz,S_new,mod_S)
 	for(int atom=0;atom<num_atoms;atom++){
 
 		const int imaterial=atoms::type_array[atom];
@@ -226,6 +228,7 @@ int LLG_Heun(){
  	}
 		
 	// Copy new spins to spin array
+	#pragma omp parallel for
 	for(int atom=0;atom<num_atoms;atom++){
 		atoms::x_spin_array[atom]=x_spin_storage_array[atom];
 		atoms::y_spin_array[atom]=y_spin_storage_array[atom];
@@ -236,6 +239,7 @@ int LLG_Heun(){
 	calculate_spin_fields(0,num_atoms);
 		
 	// Calculate Heun Gradients
+	#pragma omp parallel for private(xyz)
 	for(int atom=0;atom<num_atoms;atom++){
 
 		const int imaterial=atoms::type_array[atom];;
@@ -260,6 +264,7 @@ int LLG_Heun(){
 	}
 
 	// Calculate Heun Step
+	#pragma omp parallel for private(S_new,mod_S)
 	for(int atom=0;atom<num_atoms;atom++){
 		S_new[0]=x_initial_spin_array[atom]+mp::half_dt*(x_euler_array[atom]+x_heun_array[atom]);
 		S_new[1]=y_initial_spin_array[atom]+mp::half_dt*(y_euler_array[atom]+y_heun_array[atom]);
@@ -70,6 +70,9 @@ void calculate_surface_anisotropy_fields(const int,const int);
 void calculate_lagrange_fields(const int,const int);
 void calculate_full_spin_fields(const int start_index,const int end_index);
 
+// full width at half maximum of HAMR laser heating profile (A)
+const double hamr_laser_fwhm=200.0;
+
 int calculate_spin_fields(const int start_index,const int end_index){
 
 	///======================================================
@@ -168,6 +171,7 @@ int calculate_exchange_fields(const int start_index,const int end_index){
 	// Use appropriate function for exchange calculation
 	switch(atoms::exchange_type){
 		case 0: // isotropic
+			#pragma omp parallel for schedule(static)
 			for(int atom=start_index;atom<end_index;atom++){
 				double Hx=0.0;
 				double Hy=0.0;
@@ -187,6 +191,7 @@ int calculate_exchange_fields(const int start_index,const int end_index){
 			}
 			break;
 		case 1: // vector
+			#pragma omp parallel for schedule(static)
 			for(int atom=start_index;atom<end_index;atom++){
 				double Hx=0.0;
 				double Hy=0.0;
@@ -210,6 +215,7 @@ int calculate_exchange_fields(const int start_index,const int end_index){
 			}
 			break;
 		case 2: // tensor
+			#pragma omp parallel for schedule(static)
 			for(int atom=start_index;atom<end_index;atom++){
 				double Hx=0.0;
 				double Hy=0.0;
@@ -260,12 +266,14 @@ int calculate_anisotropy_fields(const int start_index,const int end_index){
 		// Use appropriate function for anisotropy calculation
 	switch(sim::AnisotropyType){
 		case 0: // scalar
+			#pragma omp parallel for schedule(static)
 			for(int atom=start_index;atom<end_index;atom++){
 				const int imaterial=atoms::type_array[atom];
 				atoms::z_total_spin_field_array[atom] -= 2.0*mp::MaterialScalarAnisotropyArray[imaterial].K*atoms::z_spin_array[atom];
 			}
 			break;
 		case 1: // tensor
+			#pragma omp parallel for schedule(static)
 			for(int atom=start_index;atom<end_index;atom++){
 				const int imaterial=atoms::type_array[atom];
 
@@ -306,6 +314,7 @@ int calculate_anisotropy_fields(const int start_index,const int end_index){
 ///
 ///------------------------------------------------------
 void calculate_second_order_uniaxial_anisotropy_fields(const int start_index,const int end_index){
+   #pragma omp parallel for schedule(static)
    for(int atom=start_index;atom<end_index;atom++){
       const int imaterial=atoms::type_array[atom];
       const double ex = mp::material.at(imaterial).UniaxialAnisotropyUnitVector.at(0);
@@ -338,6 +347,7 @@ void calculate_second_order_uniaxial_anisotropy_fields(const int start_index,con
 ///
 ///------------------------------------------------------
 void calculate_sixth_order_uniaxial_anisotropy_fields(const int start_index,const int end_index){
+   #pragma omp parallel for schedule(static)
    for(int atom=start_index;atom<end_index;atom++){
       const int imaterial=atoms::type_array[atom];
       const double ex = mp::material.at(imaterial).UniaxialAnisotropyUnitVector.at(0);
@@ -391,6 +401,7 @@ void calculate_spherical_harmonic_fields(const int start_index,const int end_ind
    const double oneo16 = 1.0/16.0;
 
    // loop over all atoms
+   #pragma omp parallel for schedule(static)
    for(int atom=start_index; atom<end_index; atom++){
 
       // Determine atom type
@@ -445,6 +456,7 @@ void calculate_random_spherical_harmonic_fields(const int start_index,const int
   const double oneo16 = 1.0/16.0;
 
   // loop over all atoms
+  #pragma omp parallel for schedule(static)
   for(int atom=start_index; atom<end_index; atom++){
 
     // Determine atom type
@@ -505,6 +517,7 @@ void calculate_lattice_anisotropy_fields(const int start_index,const int end_ind
    for(int imat=0; imat<mp::num_materials; imat++) ez.push_back(mp::material.at(imat).UniaxialAnisotropyUnitVector.at(2));
 
    // Now calculate fields
+   #pragma omp parallel for schedule(static)
    for(int atom=start_index;atom<end_index;atom++){
       const int imaterial=atoms::type_array[atom];
       const double Sx = atoms::x_spin_array[atom];
@@ -535,6 +548,7 @@ int calculate_cubic_anisotropy_fields(const int start_index,const int end_index)
 	///
 	///------------------------------------------------------
 	//std::cout << "here" << std::endl;
+	#pragma omp parallel for schedule(static)
 	for(int atom=start_index;atom<end_index;atom++){
 		const int imaterial=atoms::type_array[atom];
 		const double Kc=2.0*mp::MaterialCubicAnisotropyArray[imaterial];
@@ -562,6 +576,7 @@ void calculate_surface_anisotropy_fields(const int start_index,const int end_ind
 	// check calling of routine if error checking is activated
 	if(err::check==true){std::cout << "calculate_surface_anisotropy_fields has been called" << std::endl;}
 
+	#pragma omp parallel for schedule(static)
 	for(int atom=start_index;atom<end_index;atom++){
 		// only calculate for surface atoms
 		if(atoms::surface_array[atom]==true){
@@ -614,6 +629,7 @@ int calculate_applied_fields(const int start_index,const int end_index){
 		}
 
 		// Add local field AND global field
+		#pragma omp parallel for schedule(static)
 		for(int atom=start_index;atom<end_index;atom++){
 			const int imaterial=atoms::type_array[atom];
 			atoms::x_total_external_field_array[atom] += Hx + Hlocal[3*imaterial + 0];
@@ -623,6 +639,7 @@ int calculate_applied_fields(const int start_index,const int end_index){
 	}
 	else{
 		// Calculate global field
+		#pragma omp parallel for schedule(static)
 		for(int atom=start_index;atom<end_index;atom++){
 			atoms::x_total_external_field_array[atom] += Hx;
 			atoms::y_total_external_field_array[atom] += Hy;
@@ -645,6 +662,7 @@ int calculate_applied_fields(const int start_index,const int end_index){
 		//std::cout << "mu_0" << "\t" << mu_0 << std::endl;
 		//std::cout << "Magnetisation " << stats::total_mag_actual[0] << "\t" << stats::total_mag_actual[1] << "\t" << stats::total_mag_actual[2] << std::endl;
 		//std::cout << "External Demag Field " << HD[0] << "\t" << HD[1] << "\t" << HD[2] << std::endl;
+		#pragma omp parallel for schedule(static)
 		for(int atom=start_index;atom<end_index;atom++){
 			atoms::x_total_external_field_array[atom] += HD[0];
 			atoms::y_total_external_field_array[atom] += HD[1];
@@ -684,10 +702,12 @@ int calculate_thermal_fields(const int start_index,const int end_index){
       sigma_prefactor.push_back(sqrt_T*mp::material[mat].H_th_sigma);
    }
 
+   // Random numbers are generated serially to keep a single reproducible stream
    generate (atoms::x_total_external_field_array.begin()+start_index,atoms::x_total_external_field_array.begin()+end_index, mtrandom::gaussian);
    generate (atoms::y_total_external_field_array.begin()+start_index,atoms::y_total_external_field_array.begin()+end_index, mtrandom::gaussian);
    generate (atoms::z_total_external_field_array.begin()+start_index,atoms::z_total_external_field_array.begin()+end_index, mtrandom::gaussian);
 
+   #pragma omp parallel for schedule(static)
    for(int atom=start_index;atom<end_index;atom++){
 
       const int imaterial=atoms::type_array[atom];
@@ -714,6 +734,7 @@ int calculate_dipolar_fields(const int start_index,const int end_index){
    if(err::check==true){std::cout << "calculate_dipolar_fields has been called" << std::endl;}
 
    // Add dipolar fields
+   #pragma omp parallel for schedule(static)
    for(int atom=start_index;atom<end_index;atom++){
       atoms::x_total_external_field_array[atom] += atoms::x_dipolar_field_array[atom];
       atoms::y_total_external_field_array[atom] += atoms::y_dipolar_field_array[atom];
@@ -723,17 +744,21 @@ int calculate_dipolar_fields(const int start_index,const int end_index){
    return 0;
 }
 
+//------------------------------------------------------------------------------
+// Function to calculate temperature of HAMR laser heating profile at (cx,cy)
+//------------------------------------------------------------------------------
+inline double hamr_laser_temperature(const double cx, const double cy){
+	const double fwhm2=hamr_laser_fwhm*hamr_laser_fwhm;
+	const double px = sim::head_position[0];
+	const double py = sim::head_position[1];
+	const double r2 = (cx-px)*(cx-px)+(cy-py)*(cy-py);
+	return sim::Tmin+(sim::Tmax-sim::Tmin)*exp(-r2/fwhm2);
+}
+
 void calculate_hamr_fields(const int start_index,const int end_index){
 
 	if(err::check==true){std::cout << "calculate_hamr_fields has been called" << std::endl;}
 
-	// Declare hamr variables
-	const double fwhm=200.0; // A
-	const double fwhm2=fwhm*fwhm;
-	const double px = sim::head_position[0];
-	const double py = sim::head_position[1];
-	const double DeltaT=sim::Tmax-sim::Tmin;
-
 	// declare head-field variables
 	const double H_bounds_min[2]={-400.0,-250.0}; // A
 	const double H_bounds_max[2]={-100.0,+250.0}; // A
@@ -755,10 +780,7 @@ void calculate_hamr_fields(const int start_index,const int end_index){
 	if(sim::head_laser_on){
 		for(int atom=start_index;atom<end_index;atom++){
 			const int imaterial=atoms::type_array[atom];
-			const double cx = atoms::x_coord_array[atom];
-			const double cy = atoms::y_coord_array[atom];
-			const double r2 = (cx-px)*(cx-px)+(cy-py)*(cy-py);
-			const double sqrt_T = sqrt(sim::Tmin+DeltaT*exp(-r2/fwhm2));
+			const double sqrt_T = sqrt(hamr_laser_temperature(atoms::x_coord_array[atom],atoms::y_coord_array[atom]));
 			const double H_th_sigma = sqrt_T*mp::material[imaterial].H_th_sigma;
 			atoms::x_total_external_field_array[atom] *= H_th_sigma; //*mtrandom::gaussian();
 			atoms::y_total_external_field_array[atom] *= H_th_sigma; //*mtrandom::gaussian();
@@ -795,6 +817,28 @@ void calculate_hamr_fields(const int start_index,const int end_index){
 	}
 }
 
+namespace sim{
+
+//------------------------------------------------------------------------------
+// Function to get temperature of each local atom, including localised heating
+// by the HAMR laser or the localised temperature pulse
+//------------------------------------------------------------------------------
+void get_local_temperatures(std::vector<double>& temperature, const int num_atoms){
+
+	if(sim::head_laser_on){
+		for(int atom=0;atom<num_atoms;atom++){
+			temperature[atom] = hamr_laser_temperature(atoms::x_coord_array[atom],atoms::y_coord_array[atom]);
+		}
+	}
+	else if(sim::localised_temperature_pulse_on) ltmp::get_local_temperatures(temperature, num_atoms);
+	else std::fill(temperature.begin(),temperature.begin()+num_atoms,sim::temperature);
+
+	return;
+
+}
+
+} // end of namespace sim
+
 void calculate_fmr_fields(const int start_index,const int end_index){
 
 	if(err::check==true){std::cout << "calculate_fmr_fields has been called" << std::endl;}
@@ -874,6 +918,7 @@ void calculate_lagrange_fields(const int start_index,const int end_index){
    const double N=sim::lagrange_N;
 
    // Calculate LaGrange fields
+   #pragma omp parallel for schedule(static)
    for(int atom=start_index;atom<end_index;atom++){
       const double sx=atoms::x_spin_array[atom];
       const double sy=atoms::y_spin_array[atom];
@@ -905,6 +950,7 @@ void calculate_full_spin_fields(const int start_index,const int end_index){
 
 	using namespace sim::internal;
 
+   #pragma omp parallel for schedule(static)
    for(int atom=start_index;atom<end_index;atom++){
 
 		// temporary variables for field components
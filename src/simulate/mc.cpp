@@ -60,12 +60,41 @@
 
 namespace sim{
 
+// number of sweeps since magnetisation sums were last recalculated
+int mc_magnetization_sweeps=0;
+
+//------------------------------------------------------------------------------
+// Function to recalculate sums of mu_s*S and mu_s for each material from all
+// spins, removing any rounding drift of the incremental updates
+//------------------------------------------------------------------------------
+void mc_recalculate_material_magnetization(){
+
+	sim::mc_material_magnetization.assign(4*mp::num_materials,0.0);
+
+	for(int atom=0;atom<atoms::num_atoms;atom++){
+		const double mu = atoms::m_spin_array[atom];
+		double* const M = &sim::mc_material_magnetization[4*atoms::type_array[atom]];
+		M[0] += atoms::x_spin_array[atom]*mu;
+		M[1] += atoms::y_spin_array[atom]*mu;
+		M[2] += atoms::z_spin_array[atom]*mu;
+		M[3] += mu;
+	}
+
+	sim::mc_material_magnetization_valid=true;
+	mc_magnetization_sweeps=0;
+
+	return;
+
+}
+
 /// @brief Monte Carlo Integrator
 ///
 /// @callgraph
 /// @callergraph
 ///
-/// @details Integrates the system using a Monte Carlo solver with tuned step width
+/// @details Integrates the system using a Monte Carlo solver with tuned step width.
+///          The magnetisation of each material is updated with every accepted move
+///          so that statistics do not need to sum over all spins after each sweep.
 ///
 /// @section License
 /// Use of this code, either in source or compiled form, is subject to license from the authors.
@@ -116,6 +145,13 @@ int MonteCarlo(){
    double statistics_moves = 0.0;
    double statistics_reject = 0.0;
 
+   // Periodically recalculate magnetisation sums in full to bound rounding drift
+   const bool track_magnetization = (sim::mc_magnetization_recalculation_rate>0);
+   if(track_magnetization){
+      if(!sim::mc_material_magnetization_valid || mc_magnetization_sweeps>=sim::mc_magnetization_recalculation_rate) mc_recalculate_material_magnetization();
+      mc_magnetization_sweeps++;
+   }
+
 	// loop over natoms to form a single Monte Carlo step
 	for(int i=0;i<nmoves; i++){
 
@@ -153,20 +189,26 @@ int MonteCarlo(){
 		// Calculate difference in Joules/mu_B
 		DE = (Enew-Eold)*mp::material[imaterial].mu_s_SI*1.07828231e23; //1/9.27400915e-24
 
-		// Check for lower energy state and accept unconditionally
-		if(DE<0) continue;
-		// Otherwise evaluate probability for move
-		else{
-			if(exp(-DE*rescaled_material_kBTBohr[imaterial]) >= mtrandom::grnd()) continue;
-			// If rejected reset spin coordinates and continue
-			else{
-				atoms::x_spin_array[atom] = Sold[0];
-				atoms::y_spin_array[atom] = Sold[1];
-				atoms::z_spin_array[atom] = Sold[2];
-            // add one to rejection counter
-            statistics_reject += 1.0;
-				continue;
+		// Check for lower energy state and accept unconditionally, otherwise evaluate probability for move
+		if(DE<0 || exp(-DE*rescaled_material_kBTBohr[imaterial]) >= mtrandom::grnd()){
+			// Add change in moment to magnetisation of material
+			if(track_magnetization){
+				const double mu = atoms::m_spin_array[atom];
+				double* const M = &sim::mc_material_magnetization[4*imaterial];
+				M[0] += (Snew[0]-Sold[0])*mu;
+				M[1] += (Snew[1]-Sold[1])*mu;
+				M[2] += (Snew[2]-Sold[2])*mu;
 			}
+			continue;
+		}
+		// If rejected reset spin coordinates and continue
+		else{
+			atoms::x_spin_array[atom] = Sold[0];
+			atoms::y_spin_array[atom] = Sold[1];
+			atoms::z_spin_array[atom] = Sold[2];
+         // add one to rejection counter
+         statistics_reject += 1.0;
+			continue;
 		}
 	}
 
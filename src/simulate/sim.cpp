@@ -61,6 +61,7 @@ namespace sim{
 	uint64_t time=0;
 	uint64_t total_time=10000;
 	uint64_t loop_time=10000;
+	std::vector<uint64_t> hysteresis_loop_times(0); /// loop time of each sweep rate of hysteresis program
 	int partial_time=1000;
 	uint64_t equilibration_time=0;
 	int runs=1; /// for certain repetitions in programs
@@ -102,6 +103,7 @@ namespace sim{
 	double head_position[2]={0.0,cs::system_dimensions[1]*0.5}; // A
 	double head_speed=30.0; /// nm/ns
 	bool   head_laser_on=false;
+	bool   localised_temperature_pulse_on=false; /// local temperatures set by localised temperature pulse program
 	bool   constraint_rotation=false; /// enables rotation of spins to new constraint direction
 	bool   constraint_phi_changed=false; /// flag to note change in phi
 	double constraint_phi=0.0; /// Constrained minimisation vector (azimuthal) [degrees]
@@ -174,6 +176,7 @@ namespace sim{
    bool save_checkpoint_flag=false; // Save checkpoint
    bool save_checkpoint_continuous_flag=false; // save checkpoints during simulations
    int save_checkpoint_rate=1; // Default increment between checkpoints
+   double save_checkpoint_wall_time_interval=0.0; // Minutes of wall time between checkpoints (0 = disabled)
 
 	// Local function declarations
    void integrate_serial(int);
@@ -183,6 +186,11 @@ namespace sim{
    double mc_statistics_moves = 0.0;
    double mc_statistics_reject = 0.0;
 
+   // Monte Carlo magnetisation tracking
+   int mc_magnetization_recalculation_rate = 100;
+   std::vector<double> mc_material_magnetization(0);
+   bool mc_material_magnetization_valid = false;
+
 /// @brief Function to increment time counter and associted variables
 ///
 /// @section License
@@ -499,9 +507,14 @@ int integrate(int n_steps){
 	// Check for calling of function
 	if(err::check==true) std::cout << "sim::integrate has been called" << std::endl;
 
+	// Magnetisation sums are only maintained by the Monte Carlo integrator
+	if(sim::integrator!=1) sim::mc_material_magnetization_valid=false;
+
 	// Call serial or parallell depending at compile time
 	#ifdef MPICF
-		sim::integrate_mpi(n_steps);
+		// Processors hold independent copies of the system in statistical parallel mode
+		if(vmpi::mpi_mode==2) sim::integrate_serial(n_steps);
+		else sim::integrate_mpi(n_steps);
 	#else
 		sim::integrate_serial(n_steps);
 	#endif
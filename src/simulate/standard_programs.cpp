@@ -118,6 +118,7 @@ int hamr_run(){
 		atoms::y_spin_array[atom]=0.0;
 		atoms::z_spin_array[atom]=1.0;
 	}
+	sim::mc_material_magnetization_valid=false;
 	
 	// Set up loop variables
 	sim::H_applied=-0.8;
@@ -219,6 +220,7 @@ int two_temperature_pulse(){
 		atoms::z_spin_array[atom]=1.0;
 		}		
 	}
+	sim::mc_material_magnetization_valid=false;
 	//vout::pov_file();
 	// Set up loop variables
 	sim::H_applied=0.0;
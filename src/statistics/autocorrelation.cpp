@@ -0,0 +1,248 @@
+//-----------------------------------------------------------------------------
+//
+// This source file is part of the VAMPIRE open source package under the
+// GNU GPL (version 2) licence (see licence file for details).
+//
+// (c) R F L Evans 2014. All rights reserved.
+//
+//-----------------------------------------------------------------------------
+//
+// Streaming estimate of the integrated autocorrelation time by blocking
+// analysis (Flyvbjerg and Petersen, J. Chem. Phys. 91, 461 (1989)).
+//
+// Successive pairs of samples are averaged into blocks of twice the length,
+// repeatedly, keeping only the running mean and variance of each level and
+// one pending value per level. The variance of the mean estimated from blocks
+// grows with block length until blocks are longer than the correlation time,
+// after which it reaches a plateau giving the true statistical error
+//
+//       sigma^2 = 2 tau_int var(x) / N
+//
+// Memory and time per sample are O(log N), so the estimate is available at
+// any point during a run without storing the time series.
+//
+//-----------------------------------------------------------------------------
+
+// C++ standard library headers
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+
+// Vampire headers
+#include "stats.hpp"
+#include "vio.hpp"
+
+namespace stats{
+
+// minimum number of blocks for the variance at a blocking level to be trusted
+const double min_blocks = 16.0;
+
+//------------------------------------------------------------------------------------------------------
+// Constructor
+//------------------------------------------------------------------------------------------------------
+autocorrelation_statistic_t::autocorrelation_statistic_t (){}
+
+//------------------------------------------------------------------------------------------------------
+// Function to add a sample, propagating completed blocks to higher levels
+//------------------------------------------------------------------------------------------------------
+void autocorrelation_statistic_t::calculate(const double value){
+
+   double x = value;
+
+   for(unsigned int level=0; ; ++level){
+
+      // add new level when first needed
+      if(level==counter.size()){
+         counter.push_back(0.0);
+         mean.push_back(0.0);
+         m2.push_back(0.0);
+         pending.push_back(0.0);
+         has_pending.push_back(false);
+      }
+
+      // update running mean and variance of blocks at this level (Welford)
+      counter[level]+=1.0;
+      const double delta = x - mean[level];
+      mean[level] += delta/counter[level];
+      m2[level] += delta*(x - mean[level]);
+
+      // store first of pair and wait for partner
+      if(!has_pending[level]){
+         pending[level] = x;
+         has_pending[level] = true;
+         return;
+      }
+
+      // average pair into a block at the next level
+      has_pending[level] = false;
+      x = 0.5*(pending[level] + x);
+
+   }
+
+}
+
+//------------------------------------------------------------------------------------------------------
+// Function to reset statistical averages
+//------------------------------------------------------------------------------------------------------
+void autocorrelation_statistic_t::reset_averages(){
+
+   counter.clear();
+   mean.clear();
+   m2.clear();
+   pending.clear();
+   has_pending.clear();
+
+   return;
+
+}
+
+//------------------------------------------------------------------------------------------------------
+// Function to return variance of the mean estimated from blocks at a given level
+//------------------------------------------------------------------------------------------------------
+double autocorrelation_statistic_t::variance_of_mean(const unsigned int level) const {
+
+   if(level>=counter.size() || counter[level] < 2.0) return 0.0;
+   return m2[level]/(counter[level]*(counter[level]-1.0));
+
+}
+
+//------------------------------------------------------------------------------------------------------
+// Function to return number of samples
+//------------------------------------------------------------------------------------------------------
+double autocorrelation_statistic_t::num_samples() const {
+
+   return counter.size() > 0 ? counter[0] : 0.0;
+
+}
+
+//------------------------------------------------------------------------------------------------------
+// Function to return true when enough blocking levels are available to resolve the plateau
+//------------------------------------------------------------------------------------------------------
+bool autocorrelation_statistic_t::is_reliable() const {
+
+   // require at least a few doublings beyond the level with the minimum number of blocks
+   return num_samples() >= 8.0*min_blocks;
+
+}
+
+//------------------------------------------------------------------------------------------------------
+// Function to return standard error of the mean, taken as the maximum over levels with enough blocks
+//------------------------------------------------------------------------------------------------------
+double autocorrelation_statistic_t::standard_error() const {
+
+   double variance = variance_of_mean(0);
+   for(unsigned int level=1; level<counter.size(); ++level){
+      if(counter[level] < min_blocks) break;
+      variance = std::max(variance, variance_of_mean(level));
+   }
+
+   return sqrt(variance);
+
+}
+
+//------------------------------------------------------------------------------------------------------
+// Function to return integrated autocorrelation time in units of samples (1/2 for independent samples)
+//------------------------------------------------------------------------------------------------------
+double autocorrelation_statistic_t::autocorrelation_time() const {
+
+   const double naive_variance = variance_of_mean(0);
+   if(naive_variance <= 0.0) return 0.5;
+
+   const double error = standard_error();
+   return 0.5*error*error/naive_variance;
+
+}
+
+//------------------------------------------------------------------------------------------------------
+// Function to output integrated autocorrelation time in time steps as string
+//------------------------------------------------------------------------------------------------------
+std::string autocorrelation_statistic_t::output_autocorrelation_time(const int sample_time){
+
+   // complete any outstanding reduction of statistics
+   stats::complete_reduction();
+
+   // result string stream
+   std::ostringstream result;
+   result.precision(vout::precision);
+   if(vout::fixed) result.setf( std::ios::fixed, std::ios::floatfield );
+
+   result << autocorrelation_time()*double(sample_time) << "\t";
+
+   return result.str();
+
+}
+
+//------------------------------------------------------------------------------------------------------
+// Function to output standard error of the mean as string
+//------------------------------------------------------------------------------------------------------
+std::string autocorrelation_statistic_t::output_standard_error(){
+
+   // complete any outstanding reduction of statistics
+   stats::complete_reduction();
+
+   // result string stream
+   std::ostringstream result;
+   result.precision(vout::precision);
+   if(vout::fixed) result.setf( std::ios::fixed, std::ios::floatfield );
+
+   result << standard_error() << "\t";
+
+   return result.str();
+
+}
+
+//------------------------------------------------------------------------------------------------------
+// Function to determine if the mean magnetization length has reached the target standard error.
+// Reduced statistics are identical on all processors, so all make the same decision.
+//------------------------------------------------------------------------------------------------------
+bool sampling_converged(){
+
+   if(stats::target_magnetization_error <= 0.0) return false;
+
+   // include latest sample
+   stats::complete_reduction();
+
+   if(!stats::magnetization_autocorrelation.is_reliable()) return false;
+
+   return stats::magnetization_autocorrelation.standard_error() <= stats::target_magnetization_error;
+
+}
+
+//------------------------------------------------------------------------------------------------------
+// Function to return time between samples such that successive samples are approximately independent,
+// given the current time between samples and the maximum number of steps at each point. The time is
+// kept fixed if the dynamic structure factor is calculated, since its time window and frequency axis
+// assume a constant time between samples.
+//------------------------------------------------------------------------------------------------------
+int decorrelated_partial_time(const int partial_time, const uint64_t loop_time){
+
+   if(stats::calculate_dynamic_structure_factor){
+      static bool warned = false;
+      if(!warned){
+         zlog << zTs() << "Warning: time steps increment not adapted as dynamic structure factor assumes a constant time between samples" << std::endl;
+         warned = true;
+      }
+      return partial_time;
+   }
+
+   stats::complete_reduction();
+
+   // cannot estimate correlation time from too few samples
+   if(!stats::magnetization_autocorrelation.is_reliable()) return partial_time;
+
+   // slowest decay of enabled observables in samples
+   double tau = stats::magnetization_autocorrelation.autocorrelation_time();
+   if(stats::calculate_energy_autocorrelation) tau = std::max(tau, stats::energy_autocorrelation.autocorrelation_time());
+
+   // samples separated by 2 tau_int are approximately independent
+   double new_time = floor(2.0*tau*double(partial_time) + 0.5);
+
+   // keep enough samples at each point for the next estimate
+   const double max_time = std::max(1.0, floor(double(loop_time)/(8.0*min_blocks)));
+   new_time = std::min(std::max(new_time, 1.0), max_time);
+
+   return int(new_time);
+
+}
+
+} // end of namespace stats
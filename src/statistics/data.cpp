@@ -12,6 +12,9 @@
 // Vampire headers
 #include "stats.hpp"
 
+// Statistics module headers
+#include "internal.hpp"
+
 namespace stats{
 
    bool calculate_system_magnetization          = false;
@@ -19,6 +22,23 @@ namespace stats{
    bool calculate_height_magnetization          = false;
    bool calculate_material_height_magnetization = false;
    bool calculate_system_susceptibility         = false;
+   bool calculate_system_moments                = false;
+   bool calculate_material_moments              = false;
+   bool calculate_specific_heat                 = false;
+   bool calculate_magnetization_autocorrelation = false;
+   bool calculate_energy_autocorrelation        = false;
+   bool calculate_structure_factor              = false;
+   bool calculate_correlation_function          = false;
+   int structure_factor_sample_rate = 1;
+   bool calculate_dynamic_structure_factor = false;
+   std::vector<double> dynamic_structure_factor_path(0);
+   int dynamic_structure_factor_points = 10;
+   int dynamic_structure_factor_window = 256;
+   int histogram_bins = 50;
+   double histogram_maximum_temperature = 1000.0;
+
+   double target_magnetization_error = 0.0;
+   bool adaptive_partial_time = false;
 
    magnetization_statistic_t system_magnetization;
    magnetization_statistic_t material_magnetization;
@@ -27,10 +47,43 @@ namespace stats{
 
    susceptibility_statistic_t system_susceptibility;
 
+   moments_statistic_t system_moments;
+   moments_statistic_t material_moments;
+   energy_statistic_t energy_moments;
+   autocorrelation_statistic_t magnetization_autocorrelation;
+   autocorrelation_statistic_t energy_autocorrelation;
+   structure_factor_statistic_t structure_factor;
+   dynamic_structure_factor_statistic_t dynamic_structure_factor;
+   magnetization_statistic_t grain_magnetization;
+   std::vector<histogram_statistic_t> histograms;
+
    //-----------------------------------------------------------------------------
    // Shared variables used for statistics calculation
    //-----------------------------------------------------------------------------
    namespace internal{
 
+      bool reduction_pending = false; // flag set while a batched reduction is in flight
+      std::vector<double> reduction_buffer(0); // packed local sums of all statistics
+
+      #ifdef MPICF
+         MPI_Request reduction_request; // request for batched non-blocking reduction
+      #endif
+
+      int fused_num_masks = 0; // number of magnetization statistics calculated in fused pass
+      std::vector<int> fused_offsets(0); // offsets of each atom into reduction buffer for each statistic
+      int fused_num_atoms = 0; // number of atoms in fused pass
+      int fused_buffer_size = 0; // size of magnetization sums in reduction buffer
+      std::vector<int> atom_histograms(0); // indices of histograms of per-atom quantities calculated in fused pass
+      std::vector<int> histogram_offsets(0); // offsets of each atom into reduction buffer for each histogram
+      int histogram_buffer_size = 0; // size of histogram counts following magnetization sums in reduction buffer
+      bool calculate_grain_magnetization = false; // flag to calculate grain magnetization for histograms
+      std::vector<int> occupied_grains(0); // list of grains containing magnetic atoms
+      bool calculate_atom_temperature = false; // flag to calculate local temperature of each atom for histograms
+      std::vector<double> atom_temperature(0); // local temperature of each atom
+      bool calculate_energy_sample = false; // flag to add total energy to reduction buffer
+      int energy_sample_offset = 0; // position of total energy in reduction buffer
+      int structure_factor_counter = 0; // number of statistics updates since first structure factor sample
+      int dynamic_structure_factor_offset = 0; // start of q-point amplitudes in reduction buffer
+
    } // end of internal namespace
 } // end of stats namespace
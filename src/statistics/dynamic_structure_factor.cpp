@@ -0,0 +1,288 @@
+//-----------------------------------------------------------------------------
+//
+// This source file is part of the VAMPIRE open source package under the
+// GNU GPL (version 2) licence (see licence file for details).
+//
+// (c) R F L Evans 2014. All rights reserved.
+//
+//-----------------------------------------------------------------------------
+//
+// Dynamic spin structure factor S(q,w) along a path in reciprocal space
+//
+// At every statistics update the spins are projected onto each q-point of
+// the path
+//
+//       m_a(q,t) = sum_i s_a,i(t) exp(-i q.r_i)
+//
+// and only these complex amplitudes are kept in a ring buffer of one time
+// window. Each time half a window of new samples has arrived, the latest
+// window is multiplied by a Hann function and Fourier transformed in time,
+// and |m_a(q,w)|^2 is added to the running average (Welch's method). Memory
+// is therefore O(N_q N_t) rather than O(N N_t) for stored snapshots.
+//
+// Phase factors along each straight segment of the path are generated by
+// recurrence, so that only two complex exponentials are needed per atom
+// per segment.
+//
+//-----------------------------------------------------------------------------
+
+// C++ standard library headers
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <fstream>
+
+// Vampire headers
+#include "errors.hpp"
+#include "stats.hpp"
+#include "vio.hpp"
+
+// Statistics module headers
+#include "internal.hpp"
+
+namespace stats{
+
+//------------------------------------------------------------------------------------------------------
+// Constructor
+//------------------------------------------------------------------------------------------------------
+dynamic_structure_factor_statistic_t::dynamic_structure_factor_statistic_t (): initialized(false), num_q(0), window(0),
+                                                                                 num_atoms(0.0), num_samples(0), new_samples(0), head(0), mean_counter(0.0){}
+
+//------------------------------------------------------------------------------------------------------
+// Function to initialize data structures
+//
+// The path is given as a list of vertices in reciprocal lattice units of the unit cell, with
+// points_per_segment q-points on each segment between vertices (and the final vertex included).
+//------------------------------------------------------------------------------------------------------
+void dynamic_structure_factor_statistic_t::initialize(const std::vector<double>& x_coord,
+                                                      const std::vector<double>& y_coord,
+                                                      const std::vector<double>& z_coord,
+                                                      const int num_local_atoms,
+                                                      const double total_num_atoms,
+                                                      const double unit_cell_size[3],
+                                                      const std::vector<double>& path,
+                                                      const int points_per_segment,
+                                                      const int window_size){
+
+   const int num_vertices = path.size()/3;
+   if(num_vertices==0){
+      terminaltextcolor(RED);
+      std::cerr << "Error - dynamic structure factor requested but no q-points given - please specify config:dynamic-structure-factor-q-point" << std::endl;
+      terminaltextcolor(WHITE);
+      zlog << zTs() << "Error - dynamic structure factor requested but no q-points given - please specify config:dynamic-structure-factor-q-point" << std::endl;
+      err::vexit();
+   }
+
+   // copy local atomic positions
+   x.assign(x_coord.begin(), x_coord.begin()+num_local_atoms);
+   y.assign(y_coord.begin(), y_coord.begin()+num_local_atoms);
+   z.assign(z_coord.begin(), z_coord.begin()+num_local_atoms);
+   num_atoms = total_num_atoms;
+
+   // convert path to straight segments of q-points in inverse Angstroms
+   q_start.clear();
+   q_step.clear();
+   q_count.clear();
+   q_rlu.clear();
+   for(int v=0; v<num_vertices; v++){
+      const bool last = (v==num_vertices-1);
+      const int count = last ? 1 : points_per_segment;
+      for(int i=0; i<3; i++){
+         const double reciprocal = 2.0*M_PI/unit_cell_size[i];
+         const double dh = last ? 0.0 : (path[3*(v+1)+i]-path[3*v+i])/double(count);
+         q_start.push_back(path[3*v+i]*reciprocal);
+         q_step.push_back(dh*reciprocal);
+      }
+      q_count.push_back(count);
+      for(int k=0; k<count; k++){
+         for(int i=0; i<3; i++) q_rlu.push_back(path[3*v+i] + (last ? 0.0 : double(k)*(path[3*(v+1)+i]-path[3*v+i])/double(count)));
+      }
+   }
+   num_q = q_rlu.size()/3;
+
+   window = window_size;
+   ring.assign(6*num_q*window,0.0);
+   mean_structure_factor.assign(3*num_q*window,0.0);
+
+   // Hann window normalised to unit mean power
+   hann.resize(window);
+   double power=0.0;
+   for(int t=0; t<window; t++){
+      hann[t] = 0.5*(1.0 - cos(2.0*M_PI*double(t)/double(window)));
+      power += hann[t]*hann[t];
+   }
+   for(int t=0; t<window; t++) hann[t] /= sqrt(power/double(window));
+
+   reset_averages();
+
+   zlog << zTs() << "Dynamic structure factor initialised with " << num_q << " q-points and " << window << " samples per window" << std::endl;
+
+   initialized=true;
+
+   return;
+
+}
+
+//------------------------------------------------------------------------------------------------------
+// Function to return number of doubles added to the reduction buffer
+//------------------------------------------------------------------------------------------------------
+int dynamic_structure_factor_statistic_t::reduction_size(){
+   return 6*num_q;
+}
+
+//------------------------------------------------------------------------------------------------------
+// Function to calculate local contributions to spin amplitudes at each q-point, packed as
+// (re x, im x, re y, im y, re z, im z) for each q-point
+//------------------------------------------------------------------------------------------------------
+void dynamic_structure_factor_statistic_t::calculate_local_amplitudes(const std::vector<double>& sx,
+                                                                      const std::vector<double>& sy,
+                                                                      const std::vector<double>& sz,
+                                                                      double* buffer){
+
+   const int num_elements = 6*num_q;
+   std::fill(buffer, buffer+num_elements, 0.0);
+
+   const int local_atoms = x.size();
+   const int num_segments = q_count.size();
+
+   // each thread accumulates into a private partial array, merged at the end
+   #pragma omp parallel
+   {
+      std::vector<double> partial(num_elements,0.0);
+      #pragma omp for nowait
+      for(int atom=0; atom<local_atoms; ++atom){
+
+         int q=0;
+         for(int s=0; s<num_segments; s++){
+
+            // starting phase and phase increment along segment
+            const double p0 = -(q_start[3*s]*x[atom] + q_start[3*s+1]*y[atom] + q_start[3*s+2]*z[atom]);
+            const double dp = -(q_step[3*s]*x[atom] + q_step[3*s+1]*y[atom] + q_step[3*s+2]*z[atom]);
+            std::complex<double> phase(cos(p0),sin(p0));
+            const std::complex<double> step(cos(dp),sin(dp));
+
+            for(int k=0; k<q_count[s]; k++){
+               const int offset = 6*q;
+               partial[offset+0] += sx[atom]*phase.real();
+               partial[offset+1] += sx[atom]*phase.imag();
+               partial[offset+2] += sy[atom]*phase.real();
+               partial[offset+3] += sy[atom]*phase.imag();
+               partial[offset+4] += sz[atom]*phase.real();
+               partial[offset+5] += sz[atom]*phase.imag();
+               phase *= step;
+               q++;
+            }
+
+         }
+      }
+      #pragma omp critical
+      for(int i=0; i<num_elements; ++i) buffer[i] += partial[i];
+   }
+
+   return;
+
+}
+
+//------------------------------------------------------------------------------------------------------
+// Function to add reduced amplitudes to the ring buffer, transforming the latest window every half window
+//------------------------------------------------------------------------------------------------------
+void dynamic_structure_factor_statistic_t::add_sample(const double* buffer){
+
+   if(!initialized) return;
+
+   // store sample at head of ring buffer, laid out as [element][time]
+   for(int e=0; e<6*num_q; e++) ring[e*window+head] = buffer[e];
+   head = (head+1)%window;
+   if(num_samples<window) num_samples++;
+   new_samples++;
+
+   if(num_samples<window || 2*new_samples<window) return;
+   new_samples = 0;
+
+   // transform latest window for each q-point and component, oldest sample first
+   std::vector<std::complex<double> > signal(window);
+   for(int qc=0; qc<3*num_q; qc++){
+      for(int t=0; t<window; t++){
+         const int index = (head+t)%window;
+         signal[t] = std::complex<double>(ring[(2*qc)*window+index], ring[(2*qc+1)*window+index])*hann[t];
+      }
+      stats::internal::fft_1d(&signal[0], window, +1);
+      for(int w=0; w<window; w++) sample_power[qc*window+w] = std::norm(signal[w]);
+   }
+
+   // update running mean
+   mean_counter+=1.0;
+   const double inv_counter = 1.0/mean_counter;
+   // normalised so that the sum over frequencies gives the equal time structure factor
+   const double norm = 1.0/(num_atoms*double(window)*double(window));
+   for(unsigned int i=0; i<mean_structure_factor.size(); i++){
+      mean_structure_factor[i] += (sample_power[i]*norm - mean_structure_factor[i])*inv_counter;
+   }
+
+   return;
+
+}
+
+//------------------------------------------------------------------------------------------------------
+// Function to reset statistical averages
+//------------------------------------------------------------------------------------------------------
+void dynamic_structure_factor_statistic_t::reset_averages(){
+
+   std::fill(ring.begin(),ring.end(),0.0);
+   std::fill(mean_structure_factor.begin(),mean_structure_factor.end(),0.0);
+   sample_power.assign(mean_structure_factor.size(),0.0);
+   num_samples = 0;
+   new_samples = 0;
+   head = 0;
+   mean_counter = 0.0;
+
+   return;
+
+}
+
+//------------------------------------------------------------------------------------------------------
+// Function to write S(q,f) to file as blocks of constant q, given the time between samples (s)
+//------------------------------------------------------------------------------------------------------
+void dynamic_structure_factor_statistic_t::output(const std::string& filename, const double sample_time){
+
+   if(!initialized) return;
+
+   std::ofstream ofile(filename.c_str());
+   if(!ofile.is_open()){
+      terminaltextcolor(RED);
+      std::cerr << "Error - unable to open dynamic structure factor file " << filename << " for writing" << std::endl;
+      terminaltextcolor(WHITE);
+      zlog << zTs() << "Error - unable to open dynamic structure factor file " << filename << " for writing" << std::endl;
+      err::vexit();
+   }
+   ofile.precision(vout::precision);
+   if(vout::fixed) ofile.setf( std::ios::fixed, std::ios::floatfield );
+
+   // frequency resolution in THz
+   const double df = 1.0e-12/(double(window)*sample_time);
+
+   ofile << "# Dynamic spin structure factor" << std::endl;
+   ofile << "# Number of q-points: " << num_q << std::endl;
+   ofile << "# Samples per window: " << window << " at interval " << sample_time << " s" << std::endl;
+   ofile << "# Number of windows: " << mean_counter << std::endl;
+   ofile << "# q index\th\tk\tl (r.l.u.)\tf (THz)\tSxx\tSyy\tSzz" << std::endl;
+
+   for(int q=0; q<num_q; q++){
+      // order frequencies from most negative to most positive
+      for(int i=0; i<window; i++){
+         const int w = (i + (window+1)/2)%window;
+         const int fw = 2*w >= window ? w-window : w;
+         ofile << q << "\t" << q_rlu[3*q] << "\t" << q_rlu[3*q+1] << "\t" << q_rlu[3*q+2] << "\t" << double(fw)*df;
+         for(int c=0; c<3; c++) ofile << "\t" << mean_structure_factor[(3*q+c)*window+w];
+         ofile << std::endl;
+      }
+      ofile << std::endl;
+   }
+
+   ofile.close();
+
+   return;
+
+}
+
+} // end of namespace stats
@@ -0,0 +1,262 @@
+//-----------------------------------------------------------------------------
+//
+// This source file is part of the VAMPIRE open source package under the
+// GNU GPL (version 2) licence (see licence file for details).
+//
+// (c) R F L Evans 2014. All rights reserved.
+//
+//-----------------------------------------------------------------------------
+//
+// Fused calculation of all magnetization statistics
+//
+// Each magnetization statistic (system, material, height, material-height)
+// sums the spins of all atoms into its own mask categories. Calculating them
+// separately streams the spin, moment and mask arrays once per statistic, so
+// here the masks of all enabled statistics are combined into a single table
+// of offsets into the packed reduction buffer. Each spin is then read once
+// and added to every statistic in a single pass, together with the bin
+// counts of any histograms of per-atom quantities.
+//
+//-----------------------------------------------------------------------------
+
+// C++ standard library headers
+#include <algorithm>
+
+// Vampire headers
+#include "stats.hpp"
+
+// Statistics module headers
+#include "internal.hpp"
+
+namespace stats{
+   namespace internal{
+
+      //------------------------------------------------------------------------------------------------------
+      // Function to add a statistic to the fused offset table
+      //------------------------------------------------------------------------------------------------------
+      void add_fused_statistic(magnetization_statistic_t& statistic, const int k, int& base){
+
+         std::vector<int> mask;
+         std::vector<double> saturation;
+         statistic.get_mask(mask, saturation);
+
+         for(unsigned int atom=0; atom<mask.size(); ++atom){
+            stats::internal::fused_offsets[atom*stats::internal::fused_num_masks+k] = base + 4*mask[atom];
+         }
+
+         base += statistic.reduction_size();
+
+         return;
+
+      }
+
+      //------------------------------------------------------------------------------------------------------
+      // Function to combine masks of all enabled magnetization statistics into a table of offsets into the
+      // reduction buffer, stored atom by atom in the same order as statistics are packed
+      //------------------------------------------------------------------------------------------------------
+      void initialize_fused_magnetization(const int num_atoms){
+
+         fused_num_masks = 0;
+         if(stats::calculate_system_magnetization)          fused_num_masks++;
+         if(stats::calculate_material_magnetization)        fused_num_masks++;
+         if(stats::calculate_height_magnetization)          fused_num_masks++;
+         if(stats::calculate_material_height_magnetization) fused_num_masks++;
+         if(calculate_grain_magnetization)                  fused_num_masks++;
+
+         fused_num_atoms = num_atoms;
+         fused_offsets.assign(num_atoms*fused_num_masks,0);
+
+         int k = 0;
+         int base = 0;
+         if(stats::calculate_system_magnetization)          add_fused_statistic(stats::system_magnetization, k++, base);
+         if(stats::calculate_material_magnetization)        add_fused_statistic(stats::material_magnetization, k++, base);
+         if(stats::calculate_height_magnetization)          add_fused_statistic(stats::height_magnetization, k++, base);
+         if(stats::calculate_material_height_magnetization) add_fused_statistic(stats::material_height_magnetization, k++, base);
+         if(calculate_grain_magnetization)                  add_fused_statistic(stats::grain_magnetization, k++, base);
+         fused_buffer_size = base;
+
+         // magnetization sums are followed by histogram counts of per-atom quantities
+         atom_histograms.clear();
+         calculate_atom_temperature = false;
+         for(unsigned int h=0; h<stats::histograms.size(); h++){
+            if(stats::histograms[h].get_quantity()==stats::grain_magnetization_length) continue;
+            if(stats::histograms[h].get_quantity()==stats::local_temperature) calculate_atom_temperature = true;
+            atom_histograms.push_back(h);
+         }
+         if(calculate_atom_temperature) atom_temperature.assign(num_atoms,0.0);
+
+         const int num_histograms = atom_histograms.size();
+         histogram_offsets.assign(num_atoms*num_histograms,0);
+         for(int h=0; h<num_histograms; h++){
+            const stats::histogram_statistic_t& histogram = stats::histograms[atom_histograms[h]];
+            const std::vector<int>& mask = histogram.get_mask();
+            for(int atom=0; atom<num_atoms; ++atom) histogram_offsets[atom*num_histograms+h] = base + histogram.get_num_bins()*mask[atom];
+            base += histogram.reduction_size();
+         }
+         histogram_buffer_size = base - fused_buffer_size;
+
+         // followed by total energy of local spins and q-point amplitudes if needed
+         calculate_energy_sample = stats::calculate_specific_heat || stats::calculate_energy_autocorrelation;
+         energy_sample_offset = base;
+         dynamic_structure_factor_offset = base + (calculate_energy_sample ? 1 : 0);
+         const int dsf_size = stats::calculate_dynamic_structure_factor ? stats::dynamic_structure_factor.reduction_size() : 0;
+         reduction_buffer.assign(dynamic_structure_factor_offset + dsf_size,0.0);
+
+         return;
+
+      }
+
+      //------------------------------------------------------------------------------------------------------
+      // Function to calculate unnormalised local magnetisation sums and histogram counts of all enabled
+      // statistics in a single pass over the spins. Results are placed at the start of the reduction buffer.
+      //------------------------------------------------------------------------------------------------------
+      void calculate_fused_magnetization(const std::vector<double>& sx, // spin unit vector
+                                         const std::vector<double>& sy,
+                                         const std::vector<double>& sz,
+                                         const std::vector<double>& mm){
+
+         const int num_elements = fused_buffer_size + histogram_buffer_size;
+         if(num_elements==0) return;
+
+         // initialise sums to zero
+         std::fill(reduction_buffer.begin(),reduction_buffer.begin()+num_elements,0.0);
+
+         const int num_masks = fused_num_masks;
+         const int num_atoms = fused_num_atoms;
+         const int* const offsets = num_masks > 0 ? &fused_offsets[0] : NULL;
+         double* const mag = &reduction_buffer[0];
+
+         // values, range and offsets of each histogram
+         const int num_histograms = atom_histograms.size();
+         std::vector<const double*> values(num_histograms);
+         std::vector<double> minimum(num_histograms);
+         std::vector<double> inverse_width(num_histograms);
+         std::vector<int> last_bin(num_histograms);
+         for(int h=0; h<num_histograms; h++){
+            const stats::histogram_statistic_t& histogram = stats::histograms[atom_histograms[h]];
+            values[h] = histogram.get_quantity()==stats::local_temperature ? &atom_temperature[0] : &sz[0];
+            minimum[h] = histogram.get_minimum();
+            inverse_width[h] = histogram.get_inverse_bin_width();
+            last_bin[h] = histogram.get_num_bins()-1;
+         }
+         const int* const hoffsets = num_histograms > 0 ? &histogram_offsets[0] : NULL;
+
+         // each thread accumulates into a private partial array, merged at the end
+         #pragma omp parallel
+         {
+            std::vector<double> partial(num_elements,0.0);
+            #pragma omp for nowait
+            for(int atom=0; atom<num_atoms; ++atom){
+               const double m = mm[atom];
+               const double mx = sx[atom]*m;
+               const double my = sy[atom]*m;
+               const double mz = sz[atom]*m;
+               for(int k=0; k<num_masks; ++k){
+                  const int offset = offsets[atom*num_masks+k];
+                  partial[offset + 0] += mx;
+                  partial[offset + 1] += my;
+                  partial[offset + 2] += mz;
+                  partial[offset + 3] += m;
+               }
+               for(int h=0; h<num_histograms; ++h){
+                  const int b = int((values[h][atom]-minimum[h])*inverse_width[h]);
+                  partial[hoffsets[atom*num_histograms+h] + std::max(0, std::min(b, last_bin[h]))] += 1.0;
+               }
+            }
+            #pragma omp critical
+            for(int i=0; i<num_elements; ++i) mag[i] += partial[i];
+         }
+
+         return;
+
+      }
+
+      //------------------------------------------------------------------------------------------------------
+      // Function to set local magnetisation sums from known sums of mu_s*S and mu_s for each material,
+      // avoiding a pass over the spins. Only possible if all enabled statistics are functions of material,
+      // otherwise returns false.
+      //------------------------------------------------------------------------------------------------------
+      bool set_fused_magnetization(const std::vector<double>& material_magnetization){
+
+         if(stats::calculate_height_magnetization || stats::calculate_material_height_magnetization ||
+            calculate_grain_magnetization || histogram_buffer_size>0) return false;
+
+         if(fused_buffer_size==0) return true;
+
+         const int num_materials = material_magnetization.size()/4;
+         double* buffer = &reduction_buffer[0];
+
+         // system magnetization is sum over materials
+         if(stats::calculate_system_magnetization){
+            for(int i=0; i<4; ++i) buffer[i] = 0.0;
+            for(int mat=0; mat<num_materials; ++mat){
+               for(int i=0; i<4; ++i) buffer[i] += material_magnetization[4*mat+i];
+            }
+            buffer += stats::system_magnetization.reduction_size();
+         }
+
+         if(stats::calculate_material_magnetization){
+            std::copy(material_magnetization.begin(), material_magnetization.end(), buffer);
+         }
+
+         return true;
+
+      }
+
+      //------------------------------------------------------------------------------------------------------
+      // Function to copy reduced sums from the reduction buffer to each statistic and update averages,
+      // including higher order moments and autocorrelation of the magnetization and energy
+      //------------------------------------------------------------------------------------------------------
+      void finalize_fused_magnetization(){
+
+         // unpack sums in the same order as packed
+         const double* buffer = &reduction_buffer[0];
+         if(stats::calculate_system_magnetization){          stats::system_magnetization.unpack_magnetization(buffer);          buffer += stats::system_magnetization.reduction_size(); }
+         if(stats::calculate_material_magnetization){        stats::material_magnetization.unpack_magnetization(buffer);        buffer += stats::material_magnetization.reduction_size(); }
+         if(stats::calculate_height_magnetization){          stats::height_magnetization.unpack_magnetization(buffer);          buffer += stats::height_magnetization.reduction_size(); }
+         if(stats::calculate_material_height_magnetization){ stats::material_height_magnetization.unpack_magnetization(buffer); buffer += stats::material_height_magnetization.reduction_size(); }
+         if(calculate_grain_magnetization){                  stats::grain_magnetization.unpack_magnetization(buffer);           buffer += stats::grain_magnetization.reduction_size(); }
+
+         if(stats::calculate_system_magnetization)          stats::system_magnetization.finalize_magnetization();
+         if(stats::calculate_material_magnetization)        stats::material_magnetization.finalize_magnetization();
+         if(stats::calculate_height_magnetization)          stats::height_magnetization.finalize_magnetization();
+         if(stats::calculate_material_height_magnetization) stats::material_height_magnetization.finalize_magnetization();
+         if(calculate_grain_magnetization)                  stats::grain_magnetization.finalize_magnetization();
+
+         // add histogram counts in the same order as packed
+         for(unsigned int h=0; h<atom_histograms.size(); h++){
+            stats::histograms[atom_histograms[h]].add_counts(buffer);
+            buffer += stats::histograms[atom_histograms[h]].reduction_size();
+         }
+
+         // histograms of grain magnetization length over all grains
+         for(unsigned int h=0; h<stats::histograms.size(); h++){
+            stats::histogram_statistic_t& histogram = stats::histograms[h];
+            if(histogram.get_quantity()!=stats::grain_magnetization_length) continue;
+            std::vector<double> counts(histogram.reduction_size(),0.0);
+            const std::vector<double>& magnetization = stats::grain_magnetization.get_magnetization();
+            for(unsigned int g=0; g<occupied_grains.size(); g++) counts[histogram.bin(magnetization[4*occupied_grains[g]+3])] += 1.0;
+            histogram.add_counts(&counts[0]);
+         }
+
+         // update susceptibility statistics
+         if(stats::calculate_system_susceptibility)         stats::system_susceptibility.calculate(stats::system_magnetization.get_magnetization());
+
+         // update higher order moments
+         if(stats::calculate_system_moments)   stats::system_moments.calculate(stats::system_magnetization.get_magnetization());
+         if(stats::calculate_material_moments) stats::material_moments.calculate(stats::material_magnetization.get_magnetization());
+         if(stats::calculate_specific_heat)    stats::energy_moments.calculate(reduction_buffer[energy_sample_offset]);
+
+         // update autocorrelation estimates
+         if(stats::calculate_magnetization_autocorrelation) stats::magnetization_autocorrelation.calculate(stats::system_magnetization.get_magnetization()[3]);
+         if(stats::calculate_energy_autocorrelation)        stats::energy_autocorrelation.calculate(reduction_buffer[energy_sample_offset]);
+
+         // add spin amplitudes at each q-point to time window
+         if(stats::calculate_dynamic_structure_factor) stats::dynamic_structure_factor.add_sample(&reduction_buffer[dynamic_structure_factor_offset]);
+
+         return;
+
+      }
+
+   } // end of internal namespace
+} // end of stats namespace
@@ -0,0 +1,181 @@
+//-----------------------------------------------------------------------------
+//
+// This source file is part of the VAMPIRE open source package under the
+// GNU GPL (version 2) licence (see licence file for details).
+//
+// (c) R F L Evans 2014. All rights reserved.
+//
+//-----------------------------------------------------------------------------
+//
+// Histograms of per-atom quantities with a fixed number of bins
+//
+// Counts for each bin and mask id (system, material or grain) are added
+// in the same pass over the spins as the magnetization sums and reduced
+// with them, so that memory is bounded by bins x mask ids rather than the
+// number of atoms. Values outside the histogram range are counted in the
+// first or last bin. Counts are summed over samples until output, when the
+// normalised distributions are written as one row per mask id and reset.
+//
+//-----------------------------------------------------------------------------
+
+// C++ standard library headers
+#include <algorithm>
+#include <iostream>
+#include <sstream>
+
+// Vampire headers
+#include "errors.hpp"
+#include "stats.hpp"
+#include "vio.hpp"
+
+// Statistics module headers
+#include "internal.hpp"
+
+namespace stats{
+
+//------------------------------------------------------------------------------------------------------
+// Function to request a histogram of a quantity, ignoring duplicate requests
+//------------------------------------------------------------------------------------------------------
+void add_histogram(const histogram_quantity_t quantity, const histogram_group_t group){
+
+   for(unsigned int h=0; h<stats::histograms.size(); h++){
+      if(stats::histograms[h].get_quantity()==quantity && stats::histograms[h].get_group()==group) return;
+   }
+
+   stats::histograms.push_back(histogram_statistic_t(quantity, group));
+
+   return;
+
+}
+
+//------------------------------------------------------------------------------------------------------
+// Constructor
+//------------------------------------------------------------------------------------------------------
+histogram_statistic_t::histogram_statistic_t (const histogram_quantity_t in_quantity, const histogram_group_t in_group):
+   quantity(in_quantity), group(in_group), initialized(false), num_bins(0), mask_size(0), minimum(0.0), maximum(0.0), inverse_bin_width(0.0){}
+
+histogram_quantity_t histogram_statistic_t::get_quantity() const { return quantity; }
+histogram_group_t histogram_statistic_t::get_group() const { return group; }
+const std::vector<int>& histogram_statistic_t::get_mask() const { return mask; }
+int histogram_statistic_t::get_num_bins() const { return num_bins; }
+double histogram_statistic_t::get_minimum() const { return minimum; }
+double histogram_statistic_t::get_inverse_bin_width() const { return inverse_bin_width; }
+int histogram_statistic_t::reduction_size() const { return num_bins*mask_size; }
+
+//------------------------------------------------------------------------------------------------------
+// Function to initialize bins and mask
+//------------------------------------------------------------------------------------------------------
+void histogram_statistic_t::initialize(const int in_num_bins, const double in_minimum, const double in_maximum,
+                                       const int in_mask_size, const std::vector<int>& in_mask){
+
+   if(in_maximum<=in_minimum){
+      terminaltextcolor(RED);
+      std::cerr << "Error - " << name() << " histogram maximum " << in_maximum << " must be greater than minimum " << in_minimum << std::endl;
+      terminaltextcolor(WHITE);
+      zlog << zTs() << "Error - " << name() << " histogram maximum " << in_maximum << " must be greater than minimum " << in_minimum << std::endl;
+      err::vexit();
+   }
+
+   num_bins = in_num_bins;
+   minimum = in_minimum;
+   maximum = in_maximum;
+   inverse_bin_width = double(num_bins)/(maximum-minimum);
+   mask_size = in_mask_size;
+   mask = in_mask;
+   counts.assign(num_bins*mask_size,0.0);
+
+   initialized=true;
+
+   return;
+
+}
+
+//------------------------------------------------------------------------------------------------------
+// Function to return bin of value, clamped to histogram range
+//------------------------------------------------------------------------------------------------------
+int histogram_statistic_t::bin(const double value) const {
+   const int b = int((value-minimum)*inverse_bin_width);
+   return std::max(0, std::min(b, num_bins-1));
+}
+
+//------------------------------------------------------------------------------------------------------
+// Function to add reduced counts of a single sample
+//------------------------------------------------------------------------------------------------------
+void histogram_statistic_t::add_counts(const double* buffer){
+
+   const int size = counts.size();
+   for(int i=0; i<size; i++) counts[i] += buffer[i];
+
+   return;
+
+}
+
+//------------------------------------------------------------------------------------------------------
+// Function to reset statistical averages
+//------------------------------------------------------------------------------------------------------
+void histogram_statistic_t::reset_averages(){
+
+   std::fill(counts.begin(),counts.end(),0.0);
+
+   return;
+
+}
+
+//------------------------------------------------------------------------------------------------------
+// Function to return name of histogram for output
+//------------------------------------------------------------------------------------------------------
+std::string histogram_statistic_t::name() const {
+
+   std::string quantity_name = "spin-z";
+   if(quantity==local_temperature) quantity_name = "temperature";
+   else if(quantity==grain_magnetization_length) quantity_name = "grain-magnetisation";
+
+   std::string group_name = "system";
+   if(group==material_group) group_name = "material";
+   else if(group==grain_group) group_name = "grain";
+
+   return quantity_name + "\t" + group_name;
+
+}
+
+//------------------------------------------------------------------------------------------------------
+// Function to write histogram range to file header
+//------------------------------------------------------------------------------------------------------
+void histogram_statistic_t::output_header(std::ostream& ofile){
+
+   if(!initialized) return;
+
+   ofile << "# " << name() << "\t" << num_bins << " bins from " << minimum << " to " << maximum << std::endl;
+
+   return;
+
+}
+
+//------------------------------------------------------------------------------------------------------
+// Function to write normalised distribution of each non-empty mask id as a single row and reset
+//------------------------------------------------------------------------------------------------------
+void histogram_statistic_t::output(std::ostream& ofile, const uint64_t time){
+
+   if(!initialized) return;
+
+   for(int id=0; id<mask_size; id++){
+
+      const double* const c = &counts[id*num_bins];
+      double total = 0.0;
+      for(int b=0; b<num_bins; b++) total += c[b];
+      if(total==0.0) continue;
+
+      const double inv_total = 1.0/total;
+      ofile << time << "\t" << name() << "\t" << id;
+      for(int b=0; b<num_bins; b++) ofile << "\t" << c[b]*inv_total;
+      ofile << "\n";
+
+   }
+
+   reset_averages();
+
+   return;
+
+}
+
+} // end of namespace stats
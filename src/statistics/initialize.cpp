@@ -10,9 +10,16 @@
 // C++ standard library headers
 
 // Vampire headers
+#include "atoms.hpp"
+#include "cells.hpp"
+#include "create.hpp"
+#include "grains.hpp"
 #include "stats.hpp"
 #include "vmpi.hpp"
 
+// Statistics module headers
+#include "internal.hpp"
+
 namespace stats{
 
    void initialize(const int num_atoms,
@@ -49,7 +56,7 @@ namespace stats{
          }
          // Reduce maximum height on all CPUS
          #ifdef MPICF
-            MPI_Allreduce(MPI_IN_PLACE, &max_height, 1, MPI_INT, MPI_MAX, MPI_COMM_WORLD);
+            MPI_Allreduce(MPI_IN_PLACE, &max_height, 1, MPI_INT, MPI_MAX, vmpi::statistics_communicator());
          #endif
          stats::height_magnetization.set_mask(max_height+1,mask,magnetic_moment_array);
       }
@@ -67,7 +74,7 @@ namespace stats{
          }
          // Reduce maximum height on all CPUS
          #ifdef MPICF
-            MPI_Allreduce(MPI_IN_PLACE, &max_height, 1, MPI_INT, MPI_MAX, MPI_COMM_WORLD);
+            MPI_Allreduce(MPI_IN_PLACE, &max_height, 1, MPI_INT, MPI_MAX, vmpi::statistics_communicator());
          #endif
          stats::material_height_magnetization.set_mask(num_materials*(max_height+1),mask,magnetic_moment_array);
       }
@@ -75,6 +82,89 @@ namespace stats{
       // system susceptibility
       if(stats::calculate_system_susceptibility) stats::system_susceptibility.initialize(stats::system_magnetization);
 
+      // higher order moments of magnetization
+      if(stats::calculate_system_moments) stats::system_moments.initialize(stats::system_magnetization);
+      if(stats::calculate_material_moments) stats::material_moments.initialize(stats::material_magnetization);
+
+      // energy fluctuations for specific heat
+      if(stats::calculate_specific_heat){
+         double total_num_atoms = double(stats::num_atoms);
+         #ifdef MPICF
+            MPI_Allreduce(MPI_IN_PLACE, &total_num_atoms, 1, MPI_DOUBLE, MPI_SUM, vmpi::statistics_communicator());
+         #endif
+         stats::energy_moments.initialize(total_num_atoms);
+      }
+
+      // structure factor on macrocell grid
+      if(stats::calculate_structure_factor){
+         double total_moment = 0.0;
+         for(int atom=0; atom < stats::num_atoms; ++atom) total_moment += magnetic_moment_array[atom]*9.27400915e-24;
+         #ifdef MPICF
+            MPI_Allreduce(MPI_IN_PLACE, &total_moment, 1, MPI_DOUBLE, MPI_SUM, vmpi::statistics_communicator());
+         #endif
+         stats::structure_factor.initialize(cells::num_cells_x, cells::num_cells_y, cells::num_cells_z, cells::size, total_moment);
+      }
+
+      // dynamic structure factor along path in reciprocal space
+      if(stats::calculate_dynamic_structure_factor){
+         double total_num_atoms = double(stats::num_atoms);
+         #ifdef MPICF
+            MPI_Allreduce(MPI_IN_PLACE, &total_num_atoms, 1, MPI_DOUBLE, MPI_SUM, vmpi::statistics_communicator());
+         #endif
+         stats::dynamic_structure_factor.initialize(atoms::x_coord_array, atoms::y_coord_array, atoms::z_coord_array, stats::num_atoms, total_num_atoms,
+                                                    cs::unit_cell.dimensions, stats::dynamic_structure_factor_path,
+                                                    stats::dynamic_structure_factor_points, stats::dynamic_structure_factor_window);
+      }
+
+      // histograms of per-atom quantities for system, materials or grains
+      stats::internal::calculate_grain_magnetization = false;
+      for(unsigned int h=0; h<stats::histograms.size(); h++){
+
+         histogram_statistic_t& histogram = stats::histograms[h];
+
+         int mask_size = 1;
+         std::vector<int> histogram_mask(stats::num_atoms,0);
+         if(histogram.get_group()==material_group){
+            mask_size = num_materials;
+            for(int atom=0; atom < stats::num_atoms; ++atom) histogram_mask[atom] = material_type_array[atom];
+         }
+         else if(histogram.get_group()==grain_group){
+            mask_size = grains::num_grains;
+            for(int atom=0; atom < stats::num_atoms; ++atom) histogram_mask[atom] = atoms::grain_array[atom];
+         }
+
+         switch(histogram.get_quantity()){
+            case spin_z:
+               histogram.initialize(stats::histogram_bins, -1.0, 1.0, mask_size, histogram_mask);
+               break;
+            case local_temperature:
+               histogram.initialize(stats::histogram_bins, 0.0, stats::histogram_maximum_temperature, mask_size, histogram_mask);
+               break;
+            case grain_magnetization_length:
+               // one value per grain rather than per atom
+               histogram.initialize(stats::histogram_bins, 0.0, 1.0, 1, std::vector<int>(0));
+               stats::internal::calculate_grain_magnetization = true;
+               break;
+         }
+
+      }
+
+      // grain magnetization for histograms, keeping only grains with magnetic atoms
+      if(stats::internal::calculate_grain_magnetization){
+         for(int atom=0; atom < stats::num_atoms; ++atom) mask[atom] = atoms::grain_array[atom];
+         stats::grain_magnetization.set_mask(grains::num_grains,mask,magnetic_moment_array);
+         std::vector<int> grain_mask;
+         std::vector<double> grain_saturation;
+         stats::grain_magnetization.get_mask(grain_mask, grain_saturation);
+         stats::internal::occupied_grains.clear();
+         for(int grain=0; grain < grains::num_grains; ++grain){
+            if(grain_saturation[grain] > 0.0) stats::internal::occupied_grains.push_back(grain);
+         }
+      }
+
+      // combine masks for calculation of all magnetization statistics in a single pass
+      stats::internal::initialize_fused_magnetization(stats::num_atoms);
+
       return;
    }
 } // end of namespace stats
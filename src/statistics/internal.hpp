@@ -0,0 +1,66 @@
+#ifndef STATS_INTERNAL_H_
+#define STATS_INTERNAL_H_
+//-----------------------------------------------------------------------------
+//
+// This header file is part of the VAMPIRE open source package under the
+// GNU GPL (version 2) licence (see licence file for details).
+//
+// (c) R F L Evans 2014. All rights reserved.
+//
+//-----------------------------------------------------------------------------
+
+//---------------------------------------------------------------------
+// Defines shared internal data structures and functions for the
+// statistics implementation. These functions should
+// not be accessed outside of the statistics code.
+//---------------------------------------------------------------------
+
+// C++ standard library headers
+#include <complex>
+#include <vector>
+
+// Vampire headers
+#include "vmpi.hpp"
+
+namespace stats{
+   namespace internal{
+
+      //-----------------------------------------------------------------------------
+      // Shared variables used for statistics calculation
+      //-----------------------------------------------------------------------------
+      extern bool reduction_pending; /// flag set while a batched reduction is in flight
+      extern std::vector<double> reduction_buffer; /// packed local sums of all statistics
+
+      #ifdef MPICF
+         extern MPI_Request reduction_request; /// request for batched non-blocking reduction
+      #endif
+
+      extern int fused_num_masks; /// number of magnetization statistics calculated in fused pass
+      extern std::vector<int> fused_offsets; /// offsets of each atom into reduction buffer for each statistic
+      extern int fused_num_atoms; /// number of atoms in fused pass
+      extern int fused_buffer_size; /// size of magnetization sums in reduction buffer
+      extern std::vector<int> atom_histograms; /// indices of histograms of per-atom quantities calculated in fused pass
+      extern std::vector<int> histogram_offsets; /// offsets of each atom into reduction buffer for each histogram
+      extern int histogram_buffer_size; /// size of histogram counts following magnetization sums in reduction buffer
+      extern bool calculate_grain_magnetization; /// flag to calculate grain magnetization for histograms
+      extern std::vector<int> occupied_grains; /// list of grains containing magnetic atoms
+      extern bool calculate_atom_temperature; /// flag to calculate local temperature of each atom for histograms
+      extern std::vector<double> atom_temperature; /// local temperature of each atom
+      extern bool calculate_energy_sample; /// flag to add total energy to reduction buffer
+      extern int energy_sample_offset; /// position of total energy in reduction buffer
+      extern int structure_factor_counter; /// number of statistics updates since first structure factor sample
+      extern int dynamic_structure_factor_offset; /// start of q-point amplitudes in reduction buffer
+
+      //-----------------------------------------------------------------------------
+      // Internal functions for statistics calculation
+      //-----------------------------------------------------------------------------
+      void initialize_fused_magnetization(const int num_atoms);
+      void calculate_fused_magnetization(const std::vector<double>& sx, const std::vector<double>& sy, const std::vector<double>& sz, const std::vector<double>& mm);
+      bool set_fused_magnetization(const std::vector<double>& material_magnetization);
+      void finalize_fused_magnetization();
+      void fft_1d(std::complex<double>* a, const int n, const int sign);
+
+   } // end of internal namespace
+} // end of stats namespace
+
+#endif //STATS_INTERNAL_H_
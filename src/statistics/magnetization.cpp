@@ -66,7 +66,7 @@ void magnetization_statistic_t::set_mask(const int in_mask_size, std::vector<int
 
    // Add saturation for all CPUs
    #ifdef MPICF
-      MPI_Allreduce(MPI_IN_PLACE, &saturation[0], mask_size, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
+      MPI_Allreduce(MPI_IN_PLACE, &saturation[0], mask_size, MPI_DOUBLE, MPI_SUM, vmpi::statistics_communicator());
    #endif
 
    // determine mask id's with no atoms
@@ -79,7 +79,7 @@ void magnetization_statistic_t::set_mask(const int in_mask_size, std::vector<int
 
    // Reduce on all CPUs
    #ifdef MPICF
-      MPI_Allreduce(MPI_IN_PLACE, &num_atoms_in_mask[0], mask_size, MPI_INT, MPI_SUM, MPI_COMM_WORLD);
+      MPI_Allreduce(MPI_IN_PLACE, &num_atoms_in_mask[0], mask_size, MPI_INT, MPI_SUM, vmpi::statistics_communicator());
    #endif
 
    // Check for no atoms in mask on any CPU
@@ -125,19 +125,54 @@ void magnetization_statistic_t::calculate_magnetization(const std::vector<double
    std::fill(magnetization.begin(),magnetization.end(),0.0);
 
    // calculate contributions of spins to each magetization category
-   for(int atom=0; atom<num_atoms; ++atom){
-      const int mask_id = mask[atom]; // get mask id
-      magnetization[4*mask_id + 0] += sx[atom]*mm[atom];
-      magnetization[4*mask_id + 1] += sy[atom]*mm[atom];
-      magnetization[4*mask_id + 2] += sz[atom]*mm[atom];
-      magnetization[4*mask_id + 3] += mm[atom];
+   double* const mag = &magnetization[0];
+   const int num_elements = 4*mask_size;
+   // each thread accumulates into a private partial array, merged at the end
+   #pragma omp parallel
+   {
+      std::vector<double> partial(num_elements,0.0);
+      #pragma omp for nowait
+      for(int atom=0; atom<num_atoms; ++atom){
+         const int mask_id = mask[atom]; // get mask id
+         partial[4*mask_id + 0] += sx[atom]*mm[atom];
+         partial[4*mask_id + 1] += sy[atom]*mm[atom];
+         partial[4*mask_id + 2] += sz[atom]*mm[atom];
+         partial[4*mask_id + 3] += mm[atom];
+      }
+      #pragma omp critical
+      for(int i=0; i<num_elements; ++i) mag[i] += partial[i];
    }
 
    // Reduce on all CPUS
    #ifdef MPICF
-      MPI_Allreduce(MPI_IN_PLACE, &magnetization[0], 4*mask_size, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
+      MPI_Allreduce(MPI_IN_PLACE, &magnetization[0], 4*mask_size, MPI_DOUBLE, MPI_SUM, vmpi::statistics_communicator());
    #endif
 
+   // normalise and add to mean
+   finalize_magnetization();
+
+   return;
+
+}
+
+//------------------------------------------------------------------------------------------------------
+// Functions to give the size of the unnormalised magnetisation sums and copy them from a shared
+// reduction buffer
+//------------------------------------------------------------------------------------------------------
+int magnetization_statistic_t::reduction_size(){
+   return 4*mask_size;
+}
+
+void magnetization_statistic_t::unpack_magnetization(const double* buffer){
+   std::copy(buffer, buffer+4*mask_size, magnetization.begin());
+   return;
+}
+
+//------------------------------------------------------------------------------------------------------
+// Function to normalise summed magnetisation and add to mean
+//------------------------------------------------------------------------------------------------------
+void magnetization_statistic_t::finalize_magnetization(){
+
    // Calculate magnetisation length and normalize
    for(int mask_id=0; mask_id<mask_size; ++mask_id){
       double msat = magnetization[4*mask_id + 3];
@@ -169,6 +204,9 @@ void magnetization_statistic_t::calculate_magnetization(const std::vector<double
 //------------------------------------------------------------------------------------------------------
 const std::vector<double>& magnetization_statistic_t::get_magnetization(){
 
+   // complete any outstanding reduction of statistics
+   stats::complete_reduction();
+
    return magnetization;
 
 }
@@ -212,6 +250,9 @@ void magnetization_statistic_t::reset_magnetization_averages(){
 //------------------------------------------------------------------------------------------------------
 std::string magnetization_statistic_t::output_normalized_magnetization(){
 
+   // complete any outstanding reduction of statistics
+   stats::complete_reduction();
+
    // result string stream
    std::ostringstream result;
    result.precision(vout::precision);
@@ -231,6 +272,9 @@ std::string magnetization_statistic_t::output_normalized_magnetization(){
 //------------------------------------------------------------------------------------------------------
 std::string magnetization_statistic_t::output_magnetization(){
 
+   // complete any outstanding reduction of statistics
+   stats::complete_reduction();
+
    // result string stream
    std::ostringstream result;
    result.precision(vout::precision);
@@ -250,6 +294,9 @@ std::string magnetization_statistic_t::output_magnetization(){
 //------------------------------------------------------------------------------------------------------
 std::string magnetization_statistic_t::output_normalized_magnetization_length(){
 
+   // complete any outstanding reduction of statistics
+   stats::complete_reduction();
+
    // result string stream
    std::ostringstream result;
    result.precision(vout::precision);
@@ -269,6 +316,9 @@ std::string magnetization_statistic_t::output_normalized_magnetization_length(){
 //------------------------------------------------------------------------------------------------------
 std::string magnetization_statistic_t::output_normalized_mean_magnetization(){
 
+   // complete any outstanding reduction of statistics
+   stats::complete_reduction();
+
    // result string stream
    std::ostringstream result;
    result.precision(vout::precision);
@@ -291,6 +341,9 @@ std::string magnetization_statistic_t::output_normalized_mean_magnetization(){
 //------------------------------------------------------------------------------------------------------
 std::string magnetization_statistic_t::output_normalized_mean_magnetization_length(){
 
+   // complete any outstanding reduction of statistics
+   stats::complete_reduction();
+
    // result string stream
    std::ostringstream result;
    result.precision(vout::precision);
@@ -313,6 +366,9 @@ std::string magnetization_statistic_t::output_normalized_mean_magnetization_leng
 //------------------------------------------------------------------------------------------------------
 std::string magnetization_statistic_t::output_normalized_magnetization_dot_product(const std::vector<double>& vec){
 
+   // complete any outstanding reduction of statistics
+   stats::complete_reduction();
+
    // result string stream
    std::ostringstream result;
    result.precision(vout::precision);
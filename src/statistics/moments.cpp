@@ -0,0 +1,253 @@
+//-----------------------------------------------------------------------------
+//
+// This source file is part of the VAMPIRE open source package under the
+// GNU GPL (version 2) licence (see licence file for details).
+//
+// (c) R F L Evans 2014. All rights reserved.
+//
+//-----------------------------------------------------------------------------
+
+// C++ standard library headers
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <sstream>
+
+// Vampire headers
+#include "errors.hpp"
+#include "stats.hpp"
+#include "vmpi.hpp"
+#include "vio.hpp"
+
+namespace stats{
+
+//------------------------------------------------------------------------------------------------------
+// Constructor
+//------------------------------------------------------------------------------------------------------
+moments_statistic_t::moments_statistic_t (): initialized(false), num_elements(0), mean_counter(0.0){}
+
+//------------------------------------------------------------------------------------------------------
+// Function to initialize data structures
+//------------------------------------------------------------------------------------------------------
+void moments_statistic_t::initialize(stats::magnetization_statistic_t& mag_stat) {
+
+   // Check that magnetization statistic is properly initialized
+   if(!mag_stat.is_initialized()){
+      terminaltextcolor(RED);
+      std::cerr << "Programmer Error - Uninitialized magnetization statistic passed to moments statistic - please initialize first." << std::endl;
+      terminaltextcolor(WHITE);
+      zlog << zTs() << "Programmer Error - Uninitialized magnetization statistic passed to moments statistic - please initialize first." << std::endl;
+      err::vexit();
+   }
+
+   // Determine number of magnetization statistics
+   num_elements = mag_stat.get_magnetization().size()/4;
+
+   // Now set number of moments to match
+   mean_m2.resize(num_elements,0.0);
+   mean_m4.resize(num_elements,0.0);
+   mean_mvec.resize(3*num_elements,0.0);
+   comoment.resize(num_elements*num_elements,0.0);
+   delta.resize(3*num_elements,0.0);
+
+   // initialize mean counter
+   mean_counter = 0.0;
+
+   // Set flag indicating correct initialization
+   initialized=true;
+
+}
+
+//------------------------------------------------------------------------------------------------------
+// Function to add a magnetization sample to the running moments
+//
+// Means are updated incrementally (Welford) rather than accumulated as raw power sums, so that
+// fluctuations remain accurate for long runs where <m^2> - <m>^2 would lose all significant digits.
+// The co-moment of elements a and b is updated as
+//
+//       C_ab += (m_a - <m_a>_old) . (m_b - <m_b>_new)
+//
+// giving the covariance C_ab/n = <m_a.m_b> - <m_a>.<m_b> of the magnetization vectors.
+//-------------------------------------------------------------------------------------------------------
+void moments_statistic_t::calculate(const std::vector<double>& magnetization){
+
+   mean_counter+=1.0;
+   const double inv_counter = 1.0/mean_counter;
+
+   // update means of powers of magnetization length and vector
+   for(int id=0; id<num_elements; ++id){
+
+      const double mm = magnetization[4*id + 3];
+      const double m2 = mm*mm;
+      const double m4 = m2*m2;
+
+      mean_m2[id] += (m2 - mean_m2[id])*inv_counter;
+      mean_m4[id] += (m4 - mean_m4[id])*inv_counter;
+
+      for(int i=0; i<3; ++i){
+         const double m = magnetization[4*id + i]*mm;
+         delta[3*id + i] = m - mean_mvec[3*id + i];
+         mean_mvec[3*id + i] += delta[3*id + i]*inv_counter;
+      }
+
+   }
+
+   // update co-moments of all pairs of elements
+   for(int a=0; a<num_elements; ++a){
+      for(int b=a; b<num_elements; ++b){
+         double sum = 0.0;
+         for(int i=0; i<3; ++i){
+            const double mb = magnetization[4*b + i]*magnetization[4*b + 3];
+            sum += delta[3*a + i]*(mb - mean_mvec[3*b + i]);
+         }
+         comoment[a*num_elements + b] += sum;
+      }
+   }
+
+   return;
+
+}
+
+//------------------------------------------------------------------------------------------------------
+// Function to reset statistical averages
+//------------------------------------------------------------------------------------------------------
+void moments_statistic_t::reset_averages(){
+
+   std::fill(mean_m2.begin(),mean_m2.end(),0.0);
+   std::fill(mean_m4.begin(),mean_m4.end(),0.0);
+   std::fill(mean_mvec.begin(),mean_mvec.end(),0.0);
+   std::fill(comoment.begin(),comoment.end(),0.0);
+
+   // reset data counter
+   mean_counter = 0.0;
+
+   return;
+
+}
+
+//------------------------------------------------------------------------------------------------------
+// Function to output Binder cumulant of magnetization length as string
+//
+//       U_4 = 1 - <m^4> / ( 3 <m^2>^2 )
+//
+//------------------------------------------------------------------------------------------------------
+std::string moments_statistic_t::output_binder_cumulant(){
+
+   // complete any outstanding reduction of statistics
+   stats::complete_reduction();
+
+   // result string stream
+   std::ostringstream result;
+   result.precision(vout::precision);
+   if(vout::fixed) result.setf( std::ios::fixed, std::ios::floatfield );
+
+   for(int id=0; id<num_elements; ++id){
+      const double binder = mean_m2[id] > 0.0 ? 1.0 - mean_m4[id]/(3.0*mean_m2[id]*mean_m2[id]) : 0.0;
+      result << binder << "\t";
+   }
+
+   return result.str();
+
+}
+
+//------------------------------------------------------------------------------------------------------
+// Function to output covariance of magnetization vectors of all pairs of elements as string, in the
+// order (0,0) (0,1) ... (0,n-1) (1,1) ... (n-1,n-1)
+//------------------------------------------------------------------------------------------------------
+std::string moments_statistic_t::output_correlation(){
+
+   // complete any outstanding reduction of statistics
+   stats::complete_reduction();
+
+   // result string stream
+   std::ostringstream result;
+   result.precision(vout::precision);
+   if(vout::fixed) result.setf( std::ios::fixed, std::ios::floatfield );
+
+   const double inv_counter = mean_counter > 0.0 ? 1.0/mean_counter : 0.0;
+
+   for(int a=0; a<num_elements; ++a){
+      for(int b=a; b<num_elements; ++b){
+         result << comoment[a*num_elements + b]*inv_counter << "\t";
+      }
+   }
+
+   return result.str();
+
+}
+
+//------------------------------------------------------------------------------------------------------
+// Constructor
+//------------------------------------------------------------------------------------------------------
+energy_statistic_t::energy_statistic_t (): num_atoms(0.0), mean_counter(0.0), mean_energy(0.0), energy_m2(0.0){}
+
+//------------------------------------------------------------------------------------------------------
+// Function to initialize data structures
+//------------------------------------------------------------------------------------------------------
+void energy_statistic_t::initialize(const double total_num_atoms){
+
+   num_atoms = total_num_atoms;
+   reset_averages();
+
+   return;
+
+}
+
+//------------------------------------------------------------------------------------------------------
+// Function to add a total energy sample to the running mean and variance (Welford)
+//------------------------------------------------------------------------------------------------------
+void energy_statistic_t::calculate(const double energy){
+
+   mean_counter+=1.0;
+   const double delta = energy - mean_energy;
+   mean_energy += delta/mean_counter;
+   energy_m2 += delta*(energy - mean_energy);
+
+   return;
+
+}
+
+//------------------------------------------------------------------------------------------------------
+// Function to reset statistical averages
+//------------------------------------------------------------------------------------------------------
+void energy_statistic_t::reset_averages(){
+
+   mean_counter = 0.0;
+   mean_energy = 0.0;
+   energy_m2 = 0.0;
+
+   return;
+
+}
+
+//------------------------------------------------------------------------------------------------------
+// Function to output specific heat per spin (in units of k_B) as string
+//
+//       C = <E^2> - <E>^2
+//           -------------
+//            N k_B^2 T^2
+//
+//------------------------------------------------------------------------------------------------------
+std::string energy_statistic_t::output_specific_heat(const double temperature){
+
+   // complete any outstanding reduction of statistics
+   stats::complete_reduction();
+
+   // result string stream
+   std::ostringstream result;
+   result.precision(vout::precision);
+   if(vout::fixed) result.setf( std::ios::fixed, std::ios::floatfield );
+
+   // determine inverse k_B T (flushing to zero for very low temperatures)
+   const double ikBT = temperature < 1.e-300 ? 0.0 : 1.0/(1.3806503e-23*temperature);
+
+   const double variance = mean_counter > 0.0 ? energy_m2/mean_counter : 0.0;
+   const double specific_heat = num_atoms > 0.0 ? variance*ikBT*ikBT/num_atoms : 0.0;
+
+   result << specific_heat << "\t";
+
+   return result.str();
+
+}
+
+} // end of namespace stats
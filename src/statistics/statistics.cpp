@@ -13,40 +13,110 @@
 #include <sstream>
 
 // Vampire headers
+#include "cells.hpp"
 #include "errors.hpp"
 #include "gpu.hpp"
+#include "sim.hpp"
 #include "stats.hpp"
 #include "vmpi.hpp"
 
+// Statistics module headers
+#include "internal.hpp"
+
 namespace stats{
 
    //------------------------------------------------------------------------------------------------------
-   // Function to update required statistics classes
+   // Function to update required statistics classes, optionally with known magnetization of each material
    //------------------------------------------------------------------------------------------------------
-   void update(const std::vector<double>& sx, // spin unit vector
-               const std::vector<double>& sy,
-               const std::vector<double>& sz,
-               const std::vector<double>& mm){
+   void update_statistics(const std::vector<double>& sx, // spin unit vector
+                          const std::vector<double>& sy,
+                          const std::vector<double>& sz,
+                          const std::vector<double>& mm,
+                          const std::vector<double>* material_magnetization){
 
       // Check for GPU acceleration and update statistics on device
       if(gpu::acceleration){
          gpu::stats::update();
       }
       else{
-         // update magnetization statistics
-         if(stats::calculate_system_magnetization)          stats::system_magnetization.calculate_magnetization(sx,sy,sz,mm);
-         if(stats::calculate_material_magnetization)        stats::material_magnetization.calculate_magnetization(sx,sy,sz,mm);
-         if(stats::calculate_height_magnetization)          stats::height_magnetization.calculate_magnetization(sx,sy,sz,mm);
-         if(stats::calculate_material_height_magnetization) stats::material_height_magnetization.calculate_magnetization(sx,sy,sz,mm);
-
-         // update susceptibility statistics
-         if(stats::calculate_system_susceptibility)         stats::system_susceptibility.calculate(stats::system_magnetization.get_magnetization());
+
+         // complete reduction from previous update
+         stats::complete_reduction();
+
+         // calculate local temperature of each atom for histograms
+         if(stats::internal::calculate_atom_temperature) sim::get_local_temperatures(stats::internal::atom_temperature, stats::internal::fused_num_atoms);
+
+         // calculate local contributions to all magnetization statistics in a single pass, unless
+         // they follow from the magnetization of each material
+         if(material_magnetization==NULL || !stats::internal::set_fused_magnetization(*material_magnetization)){
+            stats::internal::calculate_fused_magnetization(sx,sy,sz,mm);
+         }
+
+         // calculate total energy of local spins for specific heat and autocorrelation
+         if(stats::internal::calculate_energy_sample){
+            double energies[9];
+            stats::calculate_local_energy(energies);
+            // exchange energy of single spins counts each bond twice
+            stats::internal::reduction_buffer[stats::internal::energy_sample_offset] = energies[0] - 0.5*energies[1];
+         }
+
+         // calculate local spin amplitudes at each q-point for dynamic structure factor
+         if(stats::calculate_dynamic_structure_factor){
+            stats::dynamic_structure_factor.calculate_local_amplitudes(sx,sy,sz,&stats::internal::reduction_buffer[stats::internal::dynamic_structure_factor_offset]);
+         }
+
+         // sample structure factor from macrocell moments (gathered on all processors)
+         if(stats::calculate_structure_factor){
+            if(stats::internal::structure_factor_counter%stats::structure_factor_sample_rate==0){
+               cells::mag();
+               if(vmpi::my_rank==0) stats::structure_factor.calculate(cells::x_mag_array, cells::y_mag_array, cells::z_mag_array);
+            }
+            stats::internal::structure_factor_counter++;
+         }
+
+         const int buffer_size = stats::internal::reduction_buffer.size();
+         if(buffer_size==0) return;
+
+         #ifdef MPICF
+            // Batch reductions of all statistics into a single non-blocking collective, completed when results are next needed
+            MPI_Iallreduce(MPI_IN_PLACE, &stats::internal::reduction_buffer[0], buffer_size, MPI_DOUBLE, MPI_SUM, vmpi::statistics_communicator(), &stats::internal::reduction_request);
+            stats::internal::reduction_pending = true;
+            return;
+         #endif
+
+         // update magnetization and susceptibility statistics
+         stats::internal::finalize_fused_magnetization();
+
       }
 
       return;
 
    }
 
+   //------------------------------------------------------------------------------------------------------
+   // Function to update required statistics classes
+   //------------------------------------------------------------------------------------------------------
+   void update(const std::vector<double>& sx, // spin unit vector
+               const std::vector<double>& sy,
+               const std::vector<double>& sz,
+               const std::vector<double>& mm){
+      update_statistics(sx, sy, sz, mm, NULL);
+      return;
+   }
+
+   //------------------------------------------------------------------------------------------------------
+   // Function to update required statistics classes using sums of mu_s*S (x,y,z) and mu_s for each
+   // material maintained by the integrator, so that magnetization statistics need no pass over the spins
+   //------------------------------------------------------------------------------------------------------
+   void update(const std::vector<double>& sx, // spin unit vector
+               const std::vector<double>& sy,
+               const std::vector<double>& sz,
+               const std::vector<double>& mm,
+               const std::vector<double>& material_magnetization){
+      update_statistics(sx, sy, sz, mm, &material_magnetization);
+      return;
+   }
+
    //------------------------------------------------------------------------------------------------------
    // Function to reset required statistics classes
    //------------------------------------------------------------------------------------------------------
@@ -57,6 +127,9 @@ namespace stats{
          gpu::stats::reset();
       }
       else{
+         // complete outstanding reduction so that it is not added to new averages
+         stats::complete_reduction();
+
          // reset magnetization statistics
          if(stats::calculate_system_magnetization)          stats::system_magnetization.reset_magnetization_averages();
          if(stats::calculate_material_magnetization)        stats::material_magnetization.reset_magnetization_averages();
@@ -65,10 +138,50 @@ namespace stats{
 
          // reset susceptibility statistics
          if(stats::calculate_system_susceptibility) stats::system_susceptibility.reset_averages();
+
+         // reset higher order moments
+         if(stats::calculate_system_moments)   stats::system_moments.reset_averages();
+         if(stats::calculate_material_moments) stats::material_moments.reset_averages();
+         if(stats::calculate_specific_heat)    stats::energy_moments.reset_averages();
+
+         // reset autocorrelation estimates
+         if(stats::calculate_magnetization_autocorrelation) stats::magnetization_autocorrelation.reset_averages();
+         if(stats::calculate_energy_autocorrelation)        stats::energy_autocorrelation.reset_averages();
+
+         // reset structure factor
+         if(stats::calculate_structure_factor) stats::structure_factor.reset_averages();
+         if(stats::calculate_dynamic_structure_factor) stats::dynamic_structure_factor.reset_averages();
+
+         // reset histograms
+         if(stats::internal::calculate_grain_magnetization) stats::grain_magnetization.reset_magnetization_averages();
+         for(unsigned int h=0; h<stats::histograms.size(); h++) stats::histograms[h].reset_averages();
       }
 
       return;
 
    }
 
+   //------------------------------------------------------------------------------------------------------
+   // Function to complete an outstanding batched reduction of statistics. Called lazily whenever the
+   // reduced data are needed (output, reset, next update) so that communication overlaps the integration.
+   //------------------------------------------------------------------------------------------------------
+   void complete_reduction(){
+
+      #ifdef MPICF
+
+         if(!stats::internal::reduction_pending) return;
+
+         // wait for reduction to finish
+         MPI_Wait(&stats::internal::reduction_request, MPI_STATUS_IGNORE);
+         stats::internal::reduction_pending = false;
+
+         // unpack reduced sums and calculate statistics
+         stats::internal::finalize_fused_magnetization();
+
+      #endif
+
+      return;
+
+   }
+
 }
@@ -0,0 +1,282 @@
+//-----------------------------------------------------------------------------
+//
+// This source file is part of the VAMPIRE open source package under the
+// GNU GPL (version 2) licence (see licence file for details).
+//
+// (c) R F L Evans 2014. All rights reserved.
+//
+//-----------------------------------------------------------------------------
+//
+// Static spin structure factor and spin-spin correlation function
+//
+// The moment of each macrocell m(r), normalised to the mean saturation moment
+// per cell, is Fourier transformed on the cell grid and the structure factor
+//
+//       S(q) = 1/N sum_a | sum_r m_a(r) exp(-i q.r) |^2
+//
+// is averaged over samples. The real space correlation function follows from
+// the averaged S(q) by the Wiener-Khinchin theorem
+//
+//       C(d) = 1/N sum_q S(q) exp(i q.d) = 1/N sum_r < m(r).m(r+d) >
+//
+// with periodic boundaries on the cell grid. Only spherically averaged S(|q|)
+// and C(|d|) are written. Setting the macrocell size to the unit cell size
+// gives the unit cell grid.
+//
+//-----------------------------------------------------------------------------
+
+// C++ standard library headers
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+// Vampire headers
+#include "errors.hpp"
+#include "stats.hpp"
+#include "vio.hpp"
+
+// Statistics module headers
+#include "internal.hpp"
+
+namespace stats{
+
+   namespace internal{
+
+      //------------------------------------------------------------------------------------------------------
+      // Function to perform an in-place unnormalised discrete Fourier transform of arbitrary length by
+      // recursive mixed-radix decomposition (sign = -1 forward, +1 backward)
+      //------------------------------------------------------------------------------------------------------
+      void fft_1d(std::complex<double>* a, const int n, const int sign){
+
+         if(n<=1) return;
+
+         // find smallest factor of n
+         int p=2;
+         while(p*p<=n && n%p!=0) p++;
+         if(n%p!=0) p=n;
+         const int m=n/p;
+
+         // split into p interleaved subsequences and transform each
+         std::vector<std::complex<double> > sub(n);
+         for(int r=0; r<p; r++){
+            for(int j=0; j<m; j++) sub[r*m+j]=a[j*p+r];
+            fft_1d(&sub[r*m], m, sign);
+         }
+
+         // roots of unity
+         std::vector<std::complex<double> > w(n);
+         const double theta = double(sign)*2.0*M_PI/double(n);
+         for(int t=0; t<n; t++) w[t]=std::complex<double>(cos(theta*t),sin(theta*t));
+
+         // combine subsequence transforms
+         for(int k=0; k<m; k++){
+            for(int s=0; s<p; s++){
+               const int kk=k+m*s;
+               std::complex<double> sum=0.0;
+               for(int r=0; r<p; r++) sum+=sub[r*m+k]*w[(r*kk)%n];
+               a[kk]=sum;
+            }
+         }
+
+         return;
+
+      }
+
+      //------------------------------------------------------------------------------------------------------
+      // Function to transform a 3D array stored as (i*ny+j)*nz+k along all three directions
+      //------------------------------------------------------------------------------------------------------
+      void fft_3d(std::vector<std::complex<double> >& data, const int d[3], const int sign){
+
+         const int stride[3]={d[1]*d[2], d[2], 1};
+
+         for(int axis=0; axis<3; axis++){
+
+            const int n=d[axis];
+            const int a1=(axis+1)%3;
+            const int a2=(axis+2)%3;
+
+            #pragma omp parallel
+            {
+               std::vector<std::complex<double> > line(n);
+               #pragma omp for
+               for(int line_id=0; line_id<d[a1]*d[a2]; line_id++){
+                  const int start=(line_id/d[a2])*stride[a1] + (line_id%d[a2])*stride[a2];
+                  for(int i=0; i<n; i++) line[i]=data[start+i*stride[axis]];
+                  fft_1d(&line[0], n, sign);
+                  for(int i=0; i<n; i++) data[start+i*stride[axis]]=line[i];
+               }
+            }
+
+         }
+
+         return;
+
+      }
+
+   } // end of internal namespace
+
+//------------------------------------------------------------------------------------------------------
+// Constructor
+//------------------------------------------------------------------------------------------------------
+structure_factor_statistic_t::structure_factor_statistic_t (): initialized(false), num_cells(0), cell_size(0.0), normalisation(0.0), mean_counter(0.0){
+   dimensions[0]=0;
+   dimensions[1]=0;
+   dimensions[2]=0;
+}
+
+//------------------------------------------------------------------------------------------------------
+// Function to initialize data structures
+//------------------------------------------------------------------------------------------------------
+void structure_factor_statistic_t::initialize(const int nx, const int ny, const int nz, const double size, const double total_moment){
+
+   dimensions[0]=nx;
+   dimensions[1]=ny;
+   dimensions[2]=nz;
+   num_cells=nx*ny*nz;
+   cell_size=size;
+
+   // normalise cell moments to mean saturation moment per cell
+   normalisation = total_moment > 0.0 ? double(num_cells)/total_moment : 0.0;
+
+   mean_structure_factor.assign(num_cells,0.0);
+   transform.assign(num_cells,std::complex<double>(0.0,0.0));
+   mean_counter=0.0;
+
+   initialized=true;
+
+   return;
+
+}
+
+//------------------------------------------------------------------------------------------------------
+// Function to add sample of cell moments to the running average of S(q)
+//------------------------------------------------------------------------------------------------------
+void structure_factor_statistic_t::calculate(const std::vector<double>& x_mag, const std::vector<double>& y_mag, const std::vector<double>& z_mag){
+
+   if(!initialized) return;
+
+   std::vector<double> sample(num_cells,0.0);
+   const std::vector<double>* components[3]={&x_mag, &y_mag, &z_mag};
+
+   for(int c=0; c<3; c++){
+      for(int cell=0; cell<num_cells; cell++) transform[cell]=std::complex<double>((*components[c])[cell]*normalisation,0.0);
+      stats::internal::fft_3d(transform, dimensions, -1);
+      for(int cell=0; cell<num_cells; cell++) sample[cell]+=std::norm(transform[cell]);
+   }
+
+   // update running mean
+   mean_counter+=1.0;
+   const double inv_counter=1.0/mean_counter;
+   const double inv_cells=1.0/double(num_cells);
+   for(int cell=0; cell<num_cells; cell++) mean_structure_factor[cell]+=(sample[cell]*inv_cells-mean_structure_factor[cell])*inv_counter;
+
+   return;
+
+}
+
+//------------------------------------------------------------------------------------------------------
+// Function to reset statistical averages
+//------------------------------------------------------------------------------------------------------
+void structure_factor_statistic_t::reset_averages(){
+
+   std::fill(mean_structure_factor.begin(),mean_structure_factor.end(),0.0);
+   mean_counter=0.0;
+
+   return;
+
+}
+
+//------------------------------------------------------------------------------------------------------
+// Function to write spherically averaged S(q), and optionally C(r), to file
+//------------------------------------------------------------------------------------------------------
+void structure_factor_statistic_t::output(const std::string& filename, const bool correlation){
+
+   if(!initialized) return;
+
+   std::ofstream ofile(filename.c_str());
+   if(!ofile.is_open()){
+      terminaltextcolor(RED);
+      std::cerr << "Error - unable to open structure factor file " << filename << " for writing" << std::endl;
+      terminaltextcolor(WHITE);
+      zlog << zTs() << "Error - unable to open structure factor file " << filename << " for writing" << std::endl;
+      err::vexit();
+   }
+   ofile.precision(vout::precision);
+   if(vout::fixed) ofile.setf( std::ios::fixed, std::ios::floatfield );
+
+   const int nmax=std::max(dimensions[0],std::max(dimensions[1],dimensions[2]));
+   const double dq=2.0*M_PI/(double(nmax)*cell_size);
+   const int num_bins=int(sqrt(3.0)*double(nmax)/2.0)+2;
+
+   // bin S(q) and C(r) by modulus of wave vector and displacement
+   std::vector<double> sq(num_bins,0.0), sq_q(num_bins,0.0), sq_count(num_bins,0.0);
+   std::vector<double> cr(num_bins,0.0), cr_r(num_bins,0.0), cr_count(num_bins,0.0);
+
+   if(correlation){
+      for(int cell=0; cell<num_cells; cell++) transform[cell]=std::complex<double>(mean_structure_factor[cell],0.0);
+      stats::internal::fft_3d(transform, dimensions, +1);
+   }
+
+   for(int i=0; i<dimensions[0]; i++){
+      for(int j=0; j<dimensions[1]; j++){
+         for(int k=0; k<dimensions[2]; k++){
+
+            const int cell=(i*dimensions[1]+j)*dimensions[2]+k;
+
+            // wrap indices into range -n/2 < index <= n/2
+            const int index[3]={i,j,k};
+            double q2=0.0;
+            double r2=0.0;
+            for(int a=0; a<3; a++){
+               const int w = 2*index[a] > dimensions[a] ? index[a]-dimensions[a] : index[a];
+               const double q = 2.0*M_PI*double(w)/(double(dimensions[a])*cell_size);
+               const double r = double(w)*cell_size;
+               q2+=q*q;
+               r2+=r*r;
+            }
+
+            const double q=sqrt(q2);
+            const int qbin=std::min(int(q/dq+0.5),num_bins-1);
+            sq[qbin]+=mean_structure_factor[cell];
+            sq_q[qbin]+=q;
+            sq_count[qbin]+=1.0;
+
+            if(correlation){
+               const double r=sqrt(r2);
+               const int rbin=std::min(int(r/cell_size+0.5),num_bins-1);
+               cr[rbin]+=transform[cell].real()/double(num_cells);
+               cr_r[rbin]+=r;
+               cr_count[rbin]+=1.0;
+            }
+
+         }
+      }
+   }
+
+   ofile << "# Spherically averaged static spin structure factor" << std::endl;
+   ofile << "# Macrocell grid: " << dimensions[0] << " x " << dimensions[1] << " x " << dimensions[2] << " cells of size " << cell_size << " A" << std::endl;
+   ofile << "# Number of samples: " << mean_counter << std::endl;
+   ofile << "# q (1/A)\tS(q)\tnumber of wave vectors" << std::endl;
+   for(int bin=0; bin<num_bins; bin++){
+      if(sq_count[bin]>0.0) ofile << sq_q[bin]/sq_count[bin] << "\t" << sq[bin]/sq_count[bin] << "\t" << sq_count[bin] << std::endl;
+   }
+
+   if(correlation){
+      ofile << std::endl << std::endl;
+      ofile << "# Spherically averaged spin-spin correlation function" << std::endl;
+      ofile << "# r (A)\tC(r)\tnumber of displacements" << std::endl;
+      for(int bin=0; bin<num_bins; bin++){
+         if(cr_count[bin]>0.0) ofile << cr_r[bin]/cr_count[bin] << "\t" << cr[bin]/cr_count[bin] << "\t" << cr_count[bin] << std::endl;
+      }
+   }
+
+   ofile.close();
+
+   return;
+
+}
+
+} // end of namespace stats
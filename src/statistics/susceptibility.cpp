@@ -135,6 +135,9 @@ void susceptibility_statistic_t::reset_averages(){
 //------------------------------------------------------------------------------------------------------
 std::string susceptibility_statistic_t::output_mean_susceptibility(const double temperature){
 
+   // complete any outstanding reduction of statistics
+   stats::complete_reduction();
+
    // result string stream
    std::ostringstream result;
 
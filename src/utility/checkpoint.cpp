@@ -6,12 +6,54 @@
 // (c) R F L Evans 2014. All rights reserved.
 //
 //-----------------------------------------------------------------------------
+//
+// Checkpoint files are independent of the number of processors. All
+// processors write their spins into a single file, keyed by the global atom
+// id, at offsets given by a prefix sum of the local atom counts:
+//
+//    char[8]   "VAMPCHK"
+//    int32     version
+//    int32     number of processors P which wrote the file
+//    uint64    total number of atoms N
+//    int64     time, equilibration time, parity, iH
+//    double    temperature
+//    int64     atoms, cells file counters, output rate counter
+//    uint32    CRC-32 of rng states, atom ids, spins
+//    uint32    CRC-32 of preceding header bytes
+//    P x       { int32 rng position, uint32 rng state[624] }
+//    uint64    global atom id[N]
+//    double    sx,sy,sz [3N]
+//
+// Each processor checksums its own part of a section and the checksums are
+// combined in processor order, so that they do not depend on the number of
+// processors. Files are written with explicit offsets (MPI-IO or pwrite) to a
+// temporary file which is synced to disk and then renamed, so that an
+// interrupted write never replaces the previous checkpoint. On loading each
+// processor reads an even block of the file, all checksums are verified and
+// the spins are redistributed to the processors owning each atom id, so that
+// a simulation can be restarted on a different number of processors. In
+// statistical parallel mode every processor holds the complete system and
+// writes its own checkpoint file. With sim:save-checkpoint-wall-time-interval
+// checkpoints are also written at the first data output after the given
+// number of minutes of wall time since the last checkpoint.
+//
+//-----------------------------------------------------------------------------
 
 // System headers
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
 #include <fstream>
 #include <iostream>
 #include <string>
 #include <sstream>
+#include <vector>
+
+#if !defined(MPICF) && !defined(WIN_COMPILE)
+   #include <fcntl.h>
+   #include <unistd.h>
+#endif
 
 // Program headers
 #include "atoms.hpp"
@@ -19,67 +61,580 @@
 #include "random.hpp"
 #include "sim.hpp"
 #include "vio.hpp"
+#include "vmpi.hpp"
 #include "program.hpp"
 
-//-----------------------------------------------------------------------------
-// Function to save checkpoint file
-//-----------------------------------------------------------------------------
-void save_checkpoint(){
+namespace checkpoint{
 
-   // convert number of atoms, rank and time to standard long int
-   uint64_t natoms64 = uint64_t(atoms::num_atoms-vmpi::num_halo_atoms);
-   int64_t time64 = int64_t(sim::time);
-   int64_t eqtime64 = int64_t(sim::equilibration_time);
-   int64_t parity64 = int64_t(sim::parity);
-   int64_t iH64 = int64_t(sim::iH);
-   double temp = sim::temperature;
-   int64_t output_atoms_file_counter64 = int64_t(sim::output_atoms_file_counter);
-   int64_t output_cells_file_counter64 = int64_t(sim::output_cells_file_counter);
-   int64_t output_rate_counter64 = int64_t(sim::output_rate_counter);
-
-   // determine checkpoint file name
-   std::stringstream chkfilenamess;
-   chkfilenamess << "vampire" << vmpi::my_rank << ".chk";
-   std::string chkfilename = chkfilenamess.str();
-
-   // open checkpoint file
-   std::ofstream chkfile;
-   chkfile.open(chkfilename.c_str(),std::ios::binary);
+   const int32_t version = 2;
+   const int num_rng_words = 624; // 624 is hard coded in mt implementation
+   const uint64_t rng_bytes = sizeof(int32_t)+num_rng_words*sizeof(uint32_t); // size of rng state of one processor
 
-   // check for open file
-   if(!chkfile.is_open()){
+   //-----------------------------------------------------------------------------
+   // Checkpoint header data
+   //-----------------------------------------------------------------------------
+   struct header_t{
+      char id[8];
+      int32_t version;
+      int32_t num_processors;
+      uint64_t natoms;
+      int64_t time;
+      int64_t eqtime;
+      int64_t parity;
+      int64_t iH;
+      double temperature;
+      int64_t output_atoms_file_counter;
+      int64_t output_cells_file_counter;
+      int64_t output_rate_counter;
+      uint32_t crc_rng;
+      uint32_t crc_ids;
+      uint32_t crc_spins;
+      uint32_t crc_header;
+   };
+
+   // size of header in file (fields are written individually to avoid padding)
+   const uint64_t header_bytes = 8+2*sizeof(int32_t)+sizeof(uint64_t)+4*sizeof(int64_t)+sizeof(double)+3*sizeof(int64_t)+4*sizeof(uint32_t);
+
+   // wall time of last checkpoint (or start of program)
+   time_t last_save_time = std::time(NULL);
+
+   //-----------------------------------------------------------------------------
+   // Function to update a CRC-32 (IEEE 802.3 polynomial) with a block of bytes
+   //-----------------------------------------------------------------------------
+   uint32_t crc32(uint32_t crc, const void* data, const uint64_t bytes){
+
+      static uint32_t table[256];
+      static bool table_initialized = false;
+      if(!table_initialized){
+         for(uint32_t n=0; n<256; n++){
+            uint32_t c = n;
+            for(int k=0; k<8; k++) c = (c & 1) ? 0xedb88320u ^ (c >> 1) : c >> 1;
+            table[n] = c;
+         }
+         table_initialized = true;
+      }
+
+      const unsigned char* p = static_cast<const unsigned char*>(data);
+      crc = ~crc;
+      for(uint64_t i=0; i<bytes; i++) crc = table[(crc ^ p[i]) & 0xff] ^ (crc >> 8);
+      return ~crc;
+
+   }
+
+   //-----------------------------------------------------------------------------
+   // Functions to combine CRC-32 of two consecutive blocks, given the checksums
+   // of both blocks and the length of the second block. The first checksum is
+   // advanced over the length of the second block by repeated squaring of the
+   // operator for a single zero bit in GF(2).
+   //-----------------------------------------------------------------------------
+   uint32_t gf2_matrix_times(const uint32_t* mat, uint32_t vec){
+      uint32_t sum = 0;
+      while(vec){
+         if(vec & 1) sum ^= *mat;
+         vec >>= 1;
+         mat++;
+      }
+      return sum;
+   }
+
+   void gf2_matrix_square(uint32_t* square, const uint32_t* mat){
+      for(int n=0; n<32; n++) square[n] = gf2_matrix_times(mat, mat[n]);
+   }
+
+   uint32_t crc32_combine(uint32_t crc1, const uint32_t crc2, uint64_t bytes2){
+
+      if(bytes2==0) return crc1;
+
+      uint32_t even[32]; // operator for even powers of two zero bits
+      uint32_t odd[32];  // operator for odd powers of two zero bits
+
+      // operator for one zero bit
+      odd[0] = 0xedb88320u;
+      uint32_t row = 1;
+      for(int n=1; n<32; n++){
+         odd[n] = row;
+         row <<= 1;
+      }
+
+      gf2_matrix_square(even, odd); // two zero bits
+      gf2_matrix_square(odd, even); // four zero bits
+
+      // apply one zero byte operator for each set bit of length
+      do{
+         gf2_matrix_square(even, odd);
+         if(bytes2 & 1) crc1 = gf2_matrix_times(even, crc1);
+         bytes2 >>= 1;
+         if(bytes2==0) break;
+         gf2_matrix_square(odd, even);
+         if(bytes2 & 1) crc1 = gf2_matrix_times(odd, crc1);
+         bytes2 >>= 1;
+      } while(bytes2!=0);
+
+      return crc1 ^ crc2;
+
+   }
+
+   //-----------------------------------------------------------------------------
+   // Function to pack and unpack header into a byte buffer
+   //-----------------------------------------------------------------------------
+   template <typename T> void pack(std::vector<char>& buffer, const T& value){
+      const char* bytes = reinterpret_cast<const char*>(&value);
+      buffer.insert(buffer.end(), bytes, bytes+sizeof(T));
+   }
+
+   template <typename T> void unpack(const std::vector<char>& buffer, uint64_t& idx, T& value){
+      std::memcpy(&value, &buffer[idx], sizeof(T));
+      idx+=sizeof(T);
+   }
+
+   std::vector<char> pack_header(const header_t& h){
+      std::vector<char> buffer;
+      buffer.insert(buffer.end(), h.id, h.id+8);
+      pack(buffer, h.version);
+      pack(buffer, h.num_processors);
+      pack(buffer, h.natoms);
+      pack(buffer, h.time);
+      pack(buffer, h.eqtime);
+      pack(buffer, h.parity);
+      pack(buffer, h.iH);
+      pack(buffer, h.temperature);
+      pack(buffer, h.output_atoms_file_counter);
+      pack(buffer, h.output_cells_file_counter);
+      pack(buffer, h.output_rate_counter);
+      pack(buffer, h.crc_rng);
+      pack(buffer, h.crc_ids);
+      pack(buffer, h.crc_spins);
+      pack(buffer, crc32(0, &buffer[0], buffer.size()));
+      return buffer;
+   }
+
+   header_t unpack_header(const std::vector<char>& buffer){
+      header_t h;
+      std::memcpy(h.id, &buffer[0], 8);
+      uint64_t idx=8;
+      unpack(buffer, idx, h.version);
+      unpack(buffer, idx, h.num_processors);
+      unpack(buffer, idx, h.natoms);
+      unpack(buffer, idx, h.time);
+      unpack(buffer, idx, h.eqtime);
+      unpack(buffer, idx, h.parity);
+      unpack(buffer, idx, h.iH);
+      unpack(buffer, idx, h.temperature);
+      unpack(buffer, idx, h.output_atoms_file_counter);
+      unpack(buffer, idx, h.output_cells_file_counter);
+      unpack(buffer, idx, h.output_rate_counter);
+      unpack(buffer, idx, h.crc_rng);
+      unpack(buffer, idx, h.crc_ids);
+      unpack(buffer, idx, h.crc_spins);
+      unpack(buffer, idx, h.crc_header);
+      return h;
+   }
+
+   //-----------------------------------------------------------------------------
+   // Function to determine checkpoint file name
+   //-----------------------------------------------------------------------------
+   std::string file_name(){
+      std::stringstream chkfilenamess;
+      chkfilenamess << "vampire";
+      #ifdef MPICF
+         // independent simulations write separate checkpoints
+         if(vmpi::mpi_mode==2) chkfilenamess << vmpi::my_rank;
+      #endif
+      chkfilenamess << ".chk";
+      return chkfilenamess.str();
+   }
+
+   #ifdef MPICF
+   //-----------------------------------------------------------------------------
+   // Function to return communicator sharing a checkpoint file
+   //-----------------------------------------------------------------------------
+   MPI_Comm communicator(){
+      // processors sharing a system share its checkpoint
+      return vmpi::statistics_communicator();
+   }
+   #endif
+
+   //-----------------------------------------------------------------------------
+   // Function to return CRC-32 of a section from the checksums of the local
+   // blocks of all processors sharing the file, combined in processor order
+   //-----------------------------------------------------------------------------
+   uint32_t section_crc(const void* data, const uint64_t bytes){
+
+      const uint32_t crc = crc32(0, data, bytes);
+
+      #ifdef MPICF
+         MPI_Comm comm = communicator();
+         int size;
+         MPI_Comm_size(comm, &size);
+         uint64_t block[2] = {crc, bytes};
+         std::vector<uint64_t> blocks(2*size);
+         MPI_Allgather(block, 2, MPI_UINT64_T, blocks.data(), 2, MPI_UINT64_T, comm);
+         uint32_t total = uint32_t(blocks[0]);
+         for(int p=1; p<size; p++) total = crc32_combine(total, uint32_t(blocks[2*p]), blocks[2*p+1]);
+         return total;
+      #else
+         return crc;
+      #endif
+
+   }
+
+   //-----------------------------------------------------------------------------
+   // Function to report failure to write checkpoint file
+   //-----------------------------------------------------------------------------
+   void write_error(const std::string& chkfilename){
+      terminaltextcolor(RED);
+      std::cerr << "Error: Unable to write checkpoint file " << chkfilename << ". Exiting." << std::endl;
+      terminaltextcolor(WHITE);
+      zlog << zTs() << "Error: Unable to write checkpoint file " << chkfilename << ". Exiting." << std::endl;
+      err::vexit();
+   }
+
+   //-----------------------------------------------------------------------------
+   // Function to report checksum mismatch in checkpoint file
+   //-----------------------------------------------------------------------------
+   void checksum_error(const std::string& chkfilename, const std::string& section){
+      terminaltextcolor(RED);
+      std::cerr << "Error: Checksum of " << section << " in checkpoint file " << chkfilename << " does not match, the file is corrupt or incomplete. Exiting." << std::endl;
+      terminaltextcolor(WHITE);
+      zlog << zTs() << "Error: Checksum of " << section << " in checkpoint file " << chkfilename << " does not match, the file is corrupt or incomplete. Exiting." << std::endl;
+      err::vexit();
+   }
+
+   #ifndef MPICF
+   //-----------------------------------------------------------------------------
+   // Function to write consecutive sections to a new file and sync it to disk,
+   // returning false on failure
+   //-----------------------------------------------------------------------------
+   bool write_sections(const std::string& filename, const char* const data[], const uint64_t bytes[], const int num_sections){
+
+      #ifdef WIN_COMPILE
+         std::ofstream chkfile(filename.c_str(), std::ios::binary | std::ios::trunc);
+         for(int s=0; s<num_sections; s++) chkfile.write(data[s], bytes[s]);
+         chkfile.close();
+         return !chkfile.fail();
+      #else
+         const int fd = open(filename.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+         if(fd<0) return false;
+         bool success = true;
+         uint64_t offset = 0;
+         for(int s=0; s<num_sections && success; s++){
+            const char* p = data[s];
+            uint64_t remaining = bytes[s];
+            while(remaining>0){
+               const ssize_t written = pwrite(fd, p, remaining, offset);
+               if(written<=0){
+                  success = false;
+                  break;
+               }
+               p += written;
+               offset += written;
+               remaining -= written;
+            }
+         }
+         if(fsync(fd)!=0) success = false;
+         if(close(fd)!=0) success = false;
+         return success;
+      #endif
+
+   }
+   #endif
+
+   //-----------------------------------------------------------------------------
+   // Function to replace a file with a new version, returning false on failure
+   //-----------------------------------------------------------------------------
+   bool replace_file(const std::string& new_filename, const std::string& filename){
+      #ifdef WIN_COMPILE
+         std::remove(filename.c_str()); // rename does not replace existing files
+      #endif
+      return std::rename(new_filename.c_str(), filename.c_str())==0;
+   }
+
+   //-----------------------------------------------------------------------------
+   // Function to sort checkpoint entries by global atom id
+   //-----------------------------------------------------------------------------
+   void sort_by_id(std::vector<uint64_t>& ids, std::vector<double>& spins){
+
+      std::vector<std::pair<uint64_t, uint64_t> > order(ids.size());
+      for(uint64_t i=0; i<ids.size(); i++) order[i] = std::make_pair(ids[i], i);
+      std::sort(order.begin(), order.end());
+
+      std::vector<double> sorted_spins(spins.size());
+      for(uint64_t i=0; i<order.size(); i++){
+         ids[i] = order[i].first;
+         sorted_spins[3*i+0] = spins[3*order[i].second+0];
+         sorted_spins[3*i+1] = spins[3*order[i].second+1];
+         sorted_spins[3*i+2] = spins[3*order[i].second+2];
+      }
+      spins.swap(sorted_spins);
+
+      return;
+
+   }
+
+   //-----------------------------------------------------------------------------
+   // Function to find spin with given id in sorted checkpoint entries
+   //-----------------------------------------------------------------------------
+   bool find_spin(const std::vector<uint64_t>& ids, const std::vector<double>& spins, const uint64_t id, double* spin){
+
+      std::vector<uint64_t>::const_iterator it = std::lower_bound(ids.begin(), ids.end(), id);
+      if(it==ids.end() || *it!=id) return false;
+
+      const uint64_t i = it-ids.begin();
+      spin[0] = spins[3*i+0];
+      spin[1] = spins[3*i+1];
+      spin[2] = spins[3*i+2];
+
+      return true;
+
+   }
+
+   //-----------------------------------------------------------------------------
+   // Function to report atoms missing from checkpoint file
+   //-----------------------------------------------------------------------------
+   void missing_atom_error(const std::string& chkfilename){
       terminaltextcolor(RED);
-      std::cerr << "Error: Unable to open checkpoint file " << chkfilename << " for writing. Exiting." << std::endl;
+      std::cerr << "Error: Atoms in the generated system are missing from checkpoint file " << chkfilename << ". Exiting." << std::endl;
       terminaltextcolor(WHITE);
-      zlog << zTs() << "Error: Unable to open checkpoint file " << chkfilename << " for writing. Exiting." << std::endl;
+      zlog << zTs() << "Error: Atoms in the generated system are missing from checkpoint file " << chkfilename << ". Exiting." << std::endl;
       err::vexit();
    }
 
+   #ifdef MPICF
+   //-----------------------------------------------------------------------------
+   // Function to distribute spins read from checkpoint to processors owning
+   // each atom. Entries are first sent to a directory processor (id % P) which
+   // then answers the requests of the processors owning the atoms.
+   //-----------------------------------------------------------------------------
+   void redistribute_spins(std::vector<uint64_t>& ids, std::vector<double>& spins, const uint64_t num_local_atoms, const std::string& chkfilename){
+
+      MPI_Comm comm = communicator();
+      int size;
+      MPI_Comm_size(comm, &size);
+
+      // Stage 1: send checkpoint entries to directory processors
+      std::vector<int> send_counts(size,0);
+      std::vector<int> recv_counts(size,0);
+      for(uint64_t i=0; i<ids.size(); i++) send_counts[ids[i]%size]++;
+
+      std::vector<int> send_displs(size,0);
+      std::vector<int> recv_displs(size,0);
+      MPI_Alltoall(send_counts.data(), 1, MPI_INT, recv_counts.data(), 1, MPI_INT, comm);
+      for(int p=1; p<size; p++){
+         send_displs[p] = send_displs[p-1]+send_counts[p-1];
+         recv_displs[p] = recv_displs[p-1]+recv_counts[p-1];
+      }
+      const int num_recv = recv_displs[size-1]+recv_counts[size-1];
+
+      std::vector<uint64_t> send_ids(ids.size());
+      std::vector<double> send_spins(spins.size());
+      std::vector<int> index(send_displs);
+      for(uint64_t i=0; i<ids.size(); i++){
+         const int p = ids[i]%size;
+         const int j = index[p]++;
+         send_ids[j] = ids[i];
+         send_spins[3*j+0] = spins[3*i+0];
+         send_spins[3*j+1] = spins[3*i+1];
+         send_spins[3*j+2] = spins[3*i+2];
+      }
+
+      std::vector<uint64_t> directory_ids(num_recv);
+      std::vector<double> directory_spins(3*num_recv);
+      MPI_Alltoallv(send_ids.data(), send_counts.data(), send_displs.data(), MPI_UINT64_T,
+                    directory_ids.data(), recv_counts.data(), recv_displs.data(), MPI_UINT64_T, comm);
+
+      std::vector<int> send_counts3(size), send_displs3(size), recv_counts3(size), recv_displs3(size);
+      for(int p=0; p<size; p++){
+         send_counts3[p] = 3*send_counts[p]; send_displs3[p] = 3*send_displs[p];
+         recv_counts3[p] = 3*recv_counts[p]; recv_displs3[p] = 3*recv_displs[p];
+      }
+      MPI_Alltoallv(send_spins.data(), send_counts3.data(), send_displs3.data(), MPI_DOUBLE,
+                    directory_spins.data(), recv_counts3.data(), recv_displs3.data(), MPI_DOUBLE, comm);
+
+      // release memory of file block
+      std::vector<uint64_t>().swap(ids);
+      std::vector<double>().swap(spins);
+
+      sort_by_id(directory_ids, directory_spins);
+
+      // Stage 2: request spins of local atoms from directory processors
+      std::fill(send_counts.begin(), send_counts.end(), 0);
+      for(uint64_t atom=0; atom<num_local_atoms; atom++) send_counts[atoms::global_id_array[atom]%size]++;
+
+      MPI_Alltoall(send_counts.data(), 1, MPI_INT, recv_counts.data(), 1, MPI_INT, comm);
+      send_displs[0]=0; recv_displs[0]=0;
+      for(int p=1; p<size; p++){
+         send_displs[p] = send_displs[p-1]+send_counts[p-1];
+         recv_displs[p] = recv_displs[p-1]+recv_counts[p-1];
+      }
+      const int num_requests = recv_displs[size-1]+recv_counts[size-1];
+
+      std::vector<uint64_t> request_ids(num_local_atoms);
+      std::vector<uint64_t> request_atom(num_local_atoms);
+      index = send_displs;
+      for(uint64_t atom=0; atom<num_local_atoms; atom++){
+         const uint64_t id = atoms::global_id_array[atom];
+         const int j = index[id%size]++;
+         request_ids[j] = id;
+         request_atom[j] = atom;
+      }
+
+      std::vector<uint64_t> requested_ids(num_requests);
+      MPI_Alltoallv(request_ids.data(), send_counts.data(), send_displs.data(), MPI_UINT64_T,
+                    requested_ids.data(), recv_counts.data(), recv_displs.data(), MPI_UINT64_T, comm);
+
+      // answer requests in received order
+      int missing = 0;
+      std::vector<double> answer_spins(3*num_requests);
+      for(int i=0; i<num_requests; i++){
+         if(!find_spin(directory_ids, directory_spins, requested_ids[i], &answer_spins[3*i])) missing++;
+      }
+      MPI_Allreduce(MPI_IN_PLACE, &missing, 1, MPI_INT, MPI_SUM, comm);
+      if(missing>0) missing_atom_error(chkfilename);
+
+      // return answers with reversed counts
+      for(int p=0; p<size; p++){
+         send_counts3[p] = 3*recv_counts[p]; send_displs3[p] = 3*recv_displs[p];
+         recv_counts3[p] = 3*send_counts[p]; recv_displs3[p] = 3*send_displs[p];
+      }
+      std::vector<double> local_spins(3*num_local_atoms);
+      MPI_Alltoallv(answer_spins.data(), send_counts3.data(), send_displs3.data(), MPI_DOUBLE,
+                    local_spins.data(), recv_counts3.data(), recv_displs3.data(), MPI_DOUBLE, comm);
+
+      // unpack spins in requested order
+      for(uint64_t j=0; j<num_local_atoms; j++){
+         const uint64_t atom = request_atom[j];
+         atoms::x_spin_array[atom] = local_spins[3*j+0];
+         atoms::y_spin_array[atom] = local_spins[3*j+1];
+         atoms::z_spin_array[atom] = local_spins[3*j+2];
+      }
+
+      return;
+
+   }
+   #endif
+
+} // end of checkpoint namespace
+
+//-----------------------------------------------------------------------------
+// Function to save checkpoint file
+//-----------------------------------------------------------------------------
+void save_checkpoint(){
+
+   // number of atoms on local processor (excluding halo)
+   const uint64_t natoms64 = uint64_t(atoms::num_atoms-vmpi::num_halo_atoms);
+
+   // set checkpoint variables
+   checkpoint::header_t header;
+   std::memset(header.id, 0, 8);
+   std::memcpy(header.id, "VAMPCHK", 7);
+   header.version = checkpoint::version;
+   header.num_processors = 1;
+   header.natoms = natoms64;
+   header.time = int64_t(sim::time);
+   header.eqtime = int64_t(sim::equilibration_time);
+   header.parity = int64_t(sim::parity);
+   header.iH = int64_t(sim::iH);
+   header.temperature = sim::temperature;
+   header.output_atoms_file_counter = int64_t(sim::output_atoms_file_counter);
+   header.output_cells_file_counter = int64_t(sim::output_cells_file_counter);
+   header.output_rate_counter = int64_t(sim::output_rate_counter);
+
    // get state of random number generator
-   std::vector<uint32_t> mt_state(624); // 624 is hard coded in mt implementation. uint64 assumes same size as unsigned long
+   std::vector<uint32_t> mt_state(checkpoint::num_rng_words);
    int32_t mt_p=0; // position in rng state
    mt_p=mtrandom::grnd.get_state(mt_state);
 
-   // write checkpoint variables to file
-   chkfile.write(reinterpret_cast<const char*>(&natoms64),sizeof(uint64_t));
-   chkfile.write(reinterpret_cast<const char*>(&time64),sizeof(int64_t));
-   chkfile.write(reinterpret_cast<const char*>(&eqtime64),sizeof(int64_t));
-   chkfile.write(reinterpret_cast<const char*>(&parity64),sizeof(int64_t));
-   chkfile.write(reinterpret_cast<const char*>(&iH64),sizeof(int64_t));
-   chkfile.write(reinterpret_cast<const char*>(&temp),sizeof(double));
-   chkfile.write(reinterpret_cast<const char*>(&output_atoms_file_counter64),sizeof(int64_t));
-   chkfile.write(reinterpret_cast<const char*>(&output_cells_file_counter64),sizeof(int64_t));
-   chkfile.write(reinterpret_cast<const char*>(&output_rate_counter64),sizeof(int64_t));
-   chkfile.write(reinterpret_cast<const char*>(&mt_p),sizeof(int32_t));
-   chkfile.write(reinterpret_cast<const char*>(&mt_state[0]),sizeof(uint32_t)*mt_state.size());
-
-   // write spin array to file
-   chkfile.write(reinterpret_cast<const char*>(&atoms::x_spin_array[0]),sizeof(double)*natoms64);
-   chkfile.write(reinterpret_cast<const char*>(&atoms::y_spin_array[0]),sizeof(double)*natoms64);
-   chkfile.write(reinterpret_cast<const char*>(&atoms::z_spin_array[0]),sizeof(double)*natoms64);
-
-   // close checkpoint file
-   chkfile.close();
+   std::vector<char> rng;
+   checkpoint::pack(rng, mt_p);
+   rng.insert(rng.end(), reinterpret_cast<const char*>(&mt_state[0]), reinterpret_cast<const char*>(&mt_state[0])+sizeof(uint32_t)*mt_state.size());
+
+   // pack local atom ids and spins
+   std::vector<uint64_t> ids(natoms64);
+   std::vector<double> spins(3*natoms64);
+   for(uint64_t atom=0; atom<natoms64; atom++){
+      ids[atom] = atoms::global_id_array[atom];
+      spins[3*atom+0] = atoms::x_spin_array[atom];
+      spins[3*atom+1] = atoms::y_spin_array[atom];
+      spins[3*atom+2] = atoms::z_spin_array[atom];
+   }
+
+   const std::string chkfilename = checkpoint::file_name();
+   const std::string tmpfilename = chkfilename + ".tmp";
+
+   #ifdef MPICF
+
+      MPI_Comm comm = checkpoint::communicator();
+      int rank, size;
+      MPI_Comm_rank(comm, &rank);
+      MPI_Comm_size(comm, &size);
+
+      // determine offset of local atoms and total number of atoms
+      uint64_t offset=0;
+      MPI_Exscan(&natoms64, &offset, 1, MPI_UINT64_T, MPI_SUM, comm);
+      if(rank==0) offset=0; // result of exscan is undefined on root
+      MPI_Allreduce(&natoms64, &header.natoms, 1, MPI_UINT64_T, MPI_SUM, comm);
+      header.num_processors = size;
+
+   #endif
+
+   // checksum sections
+   header.crc_rng = checkpoint::section_crc(&rng[0], rng.size());
+   header.crc_ids = checkpoint::section_crc(ids.data(), sizeof(uint64_t)*ids.size());
+   header.crc_spins = checkpoint::section_crc(spins.data(), sizeof(double)*spins.size());
+   const std::vector<char> hbuffer = checkpoint::pack_header(header);
+
+   #ifdef MPICF
+
+      // open temporary checkpoint file
+      MPI_File fh;
+      int err = MPI_File_open(comm, const_cast<char*>(tmpfilename.c_str()), MPI_MODE_CREATE | MPI_MODE_WRONLY, MPI_INFO_NULL, &fh);
+      if(err==MPI_SUCCESS) err = MPI_File_set_size(fh, 0);
+
+      // check for open file
+      if(err!=MPI_SUCCESS){
+         terminaltextcolor(RED);
+         std::cerr << "Error: Unable to open checkpoint file " << tmpfilename << " for writing. Exiting." << std::endl;
+         terminaltextcolor(WHITE);
+         zlog << zTs() << "Error: Unable to open checkpoint file " << tmpfilename << " for writing. Exiting." << std::endl;
+         err::vexit();
+      }
+
+      // write header on root and data blocks from all processors
+      const uint64_t rng_start = checkpoint::header_bytes;
+      const uint64_t id_start = rng_start + uint64_t(size)*checkpoint::rng_bytes;
+      const uint64_t spin_start = id_start + header.natoms*sizeof(uint64_t);
+
+      int failed = 0;
+      if(rank==0) failed |= MPI_File_write_at(fh, 0, const_cast<char*>(&hbuffer[0]), hbuffer.size(), MPI_BYTE, MPI_STATUS_IGNORE);
+      failed |= MPI_File_write_at_all(fh, rng_start + rank*checkpoint::rng_bytes, &rng[0], rng.size(), MPI_BYTE, MPI_STATUS_IGNORE);
+      failed |= MPI_File_write_at_all(fh, id_start + offset*sizeof(uint64_t), ids.data(), ids.size(), MPI_UINT64_T, MPI_STATUS_IGNORE);
+      failed |= MPI_File_write_at_all(fh, spin_start + 3*offset*sizeof(double), spins.data(), spins.size(), MPI_DOUBLE, MPI_STATUS_IGNORE);
+      failed |= MPI_File_sync(fh);
+
+      // close checkpoint file
+      MPI_File_close(&fh);
+
+      MPI_Allreduce(MPI_IN_PLACE, &failed, 1, MPI_INT, MPI_BOR, comm);
+      if(failed!=MPI_SUCCESS) checkpoint::write_error(tmpfilename);
+
+      // replace previous checkpoint once complete file is on disk
+      if(rank==0) failed = checkpoint::replace_file(tmpfilename, chkfilename) ? 0 : 1;
+      MPI_Bcast(&failed, 1, MPI_INT, 0, comm);
+      if(failed!=0) checkpoint::write_error(chkfilename);
+
+   #else
+
+      // write checkpoint variables and spins to temporary file
+      const char* const data[4] = {&hbuffer[0], &rng[0], reinterpret_cast<const char*>(ids.data()), reinterpret_cast<const char*>(spins.data())};
+      const uint64_t bytes[4] = {hbuffer.size(), rng.size(), sizeof(uint64_t)*ids.size(), sizeof(double)*spins.size()};
+      if(!checkpoint::write_sections(tmpfilename, data, bytes, 4)) checkpoint::write_error(tmpfilename);
+
+      // replace previous checkpoint once complete file is on disk
+      if(!checkpoint::replace_file(tmpfilename, chkfilename)) checkpoint::write_error(chkfilename);
+
+   #endif
+
+   checkpoint::last_save_time = std::time(NULL);
 
    // log writing checkpoint file
    zlog << zTs() << "Checkpoint file written to disk." << std::endl;
@@ -89,36 +644,40 @@ void save_checkpoint(){
 }
 
 //-----------------------------------------------------------------------------
-// Function to save checkpoint file
+// Function to load checkpoint file
 //-----------------------------------------------------------------------------
 void load_checkpoint(){
 
-   // convert number of atoms, rank and time to standard long int
-   uint64_t natoms64;
-   int64_t time64;
-   int64_t eqtime64;
-   int64_t parity64;
-   int64_t iH64;
-   double temp;
-   int64_t output_atoms_file_counter64;
-   int64_t output_cells_file_counter64;
-   int64_t output_rate_counter64;
+   // number of atoms on local processor (excluding halo)
+   const uint64_t natoms64 = uint64_t(atoms::num_atoms-vmpi::num_halo_atoms);
+   uint64_t total_atoms = natoms64;
 
    // variables for loading state of random number generator
-   std::vector<uint32_t> mt_state(624); // 624 is hard coded in mt implementation. uint64 assumes same size as unsigned long
+   std::vector<uint32_t> mt_state(checkpoint::num_rng_words);
    int32_t mt_p=0; // position in rng state
 
-   // determine checkpoint file name
-   std::stringstream chkfilenamess;
-   chkfilenamess << "vampire" << vmpi::my_rank << ".chk";
-   std::string chkfilename = chkfilenamess.str();
+   const std::string chkfilename = checkpoint::file_name();
+
+   int rank = 0;
+   int size = 1;
+
+   #ifdef MPICF
+      MPI_Comm comm = checkpoint::communicator();
+      MPI_Comm_rank(comm, &rank);
+      MPI_Comm_size(comm, &size);
+      MPI_Allreduce(&natoms64, &total_atoms, 1, MPI_UINT64_T, MPI_SUM, comm);
 
-   // open checkpoint file
-   std::ifstream chkfile;
-   chkfile.open(chkfilename.c_str(),std::ios::binary);
+      // open checkpoint file
+      MPI_File fh;
+      const bool file_open = MPI_File_open(comm, const_cast<char*>(chkfilename.c_str()), MPI_MODE_RDONLY, MPI_INFO_NULL, &fh) == MPI_SUCCESS;
+   #else
+      std::ifstream chkfile;
+      chkfile.open(chkfilename.c_str(),std::ios::binary);
+      const bool file_open = chkfile.is_open();
+   #endif
 
    // check for open file
-   if(!chkfile.is_open()){
+   if(!file_open){
       terminaltextcolor(RED);
       std::cerr << "Error: Unable to open checkpoint file " << chkfilename << " for reading. Exiting." << std::endl;
       std::cerr << "Info: sim:continue may be specified in the input file which requires a valid checkpoint file." << std::endl;
@@ -129,48 +688,133 @@ void load_checkpoint(){
    }
 
    // read checkpoint variables from file
-   chkfile.read((char*)&natoms64,sizeof(uint64_t));
-   chkfile.read((char*)&time64,sizeof(int64_t));
-   chkfile.read((char*)&eqtime64,sizeof(int64_t));
-   chkfile.read((char*)&parity64,sizeof(int64_t));
-   chkfile.read((char*)&iH64,sizeof(int64_t));
-   chkfile.read((char*)&temp,sizeof(double));
-   chkfile.read((char*)&output_atoms_file_counter64,sizeof(int64_t));
-   chkfile.read((char*)&output_cells_file_counter64,sizeof(int64_t));
-   chkfile.read((char*)&output_rate_counter64,sizeof(int64_t));
-   chkfile.read((char*)&mt_p,sizeof(int32_t));
-   chkfile.read((char*)&mt_state[0],sizeof(uint32_t)*mt_state.size());
+   std::vector<char> hbuffer(checkpoint::header_bytes);
+   #ifdef MPICF
+      MPI_File_read_at_all(fh, 0, &hbuffer[0], hbuffer.size(), MPI_BYTE, MPI_STATUS_IGNORE);
+   #else
+      chkfile.read(&hbuffer[0], hbuffer.size());
+   #endif
+   const checkpoint::header_t header = checkpoint::unpack_header(hbuffer);
 
-   // if continuing set state of rng
-   if(sim::load_checkpoint_continue_flag) mtrandom::grnd.set_state(mt_state, mt_p);
+   // check for valid checkpoint file
+   if(std::strncmp(header.id, "VAMPCHK", 7)!=0 || header.version!=checkpoint::version){
+      terminaltextcolor(RED);
+      std::cerr << "Error: File " << chkfilename << " is not a valid checkpoint file for this version of vampire. Exiting." << std::endl;
+      terminaltextcolor(WHITE);
+      zlog << zTs() << "Error: File " << chkfilename << " is not a valid checkpoint file for this version of vampire. Exiting." << std::endl;
+      err::vexit();
+   }
+
+   // check header is intact
+   if(checkpoint::crc32(0, &hbuffer[0], checkpoint::header_bytes-sizeof(uint32_t))!=header.crc_header) checkpoint::checksum_error(chkfilename, "header");
 
    // check for rational number of atoms
-   if(static_cast<uint64_t>(atoms::num_atoms-vmpi::num_halo_atoms) != natoms64){
+   if(header.natoms != total_atoms){
       terminaltextcolor(RED);
-      std::cerr << "Error: Mismatch between number of atoms in checkpoint file (" << natoms64 << ") and number of generated atoms (" << atoms::num_atoms-vmpi::num_halo_atoms << "). Exiting." << std::endl;
+      std::cerr << "Error: Mismatch between number of atoms in checkpoint file (" << header.natoms << ") and number of generated atoms (" << total_atoms << "). Exiting." << std::endl;
       terminaltextcolor(WHITE);
-      zlog << zTs() << "Error: Mismatch between number of atoms in checkpoint file (" << natoms64 << ") and number of generated atoms (" << atoms::num_atoms-vmpi::num_halo_atoms << "). Exiting." << std::endl;
+      zlog << zTs() << "Error: Mismatch between number of atoms in checkpoint file (" << header.natoms << ") and number of generated atoms (" << total_atoms << "). Exiting." << std::endl;
+      err::vexit();
+   }
+
+   // Check rng states of all processors on root
+   const uint64_t rng_start = checkpoint::header_bytes;
+   int valid = 1;
+   if(rank==0){
+      std::vector<char> section(uint64_t(header.num_processors)*checkpoint::rng_bytes);
+      #ifdef MPICF
+         MPI_File_read_at(fh, rng_start, &section[0], section.size(), MPI_BYTE, MPI_STATUS_IGNORE);
+      #else
+         chkfile.seekg(rng_start);
+         chkfile.read(&section[0], section.size());
+      #endif
+      valid = checkpoint::crc32(0, &section[0], section.size())==header.crc_rng;
+   }
+   #ifdef MPICF
+      MPI_Bcast(&valid, 1, MPI_INT, 0, comm);
+   #endif
+   if(!valid) checkpoint::checksum_error(chkfilename, "random number generator states");
+
+   // Read rng state saved by same processor if it exists
+   const bool rng_saved = rank < header.num_processors;
+   std::vector<char> rng(checkpoint::rng_bytes);
+   #ifdef MPICF
+      MPI_File_read_at_all(fh, rng_start + (rng_saved ? rank : 0)*checkpoint::rng_bytes, &rng[0], rng.size(), MPI_BYTE, MPI_STATUS_IGNORE);
+   #else
+      chkfile.seekg(rng_start);
+      chkfile.read(&rng[0], rng.size());
+   #endif
+   uint64_t idx=0;
+   checkpoint::unpack(rng, idx, mt_p);
+   std::memcpy(&mt_state[0], &rng[idx], sizeof(uint32_t)*mt_state.size());
+
+   // if continuing set state of rng
+   if(sim::load_checkpoint_continue_flag){
+      if(rng_saved) mtrandom::grnd.set_state(mt_state, mt_p);
+      if(header.num_processors!=size){
+         zlog << zTs() << "Warning: Checkpoint file written on " << header.num_processors << " processors and loaded on " << size;
+         zlog << ". Random number sequences will differ from an uninterrupted simulation." << std::endl;
+      }
    }
 
    // Load saved time if simulation continuing
    if(sim::load_checkpoint_continue_flag){
-      sim::parity = parity64;
-      sim::iH = iH64;
-      sim::time = time64;
-      sim::equilibration_time = eqtime64;
-      sim::temperature = temp;
-      sim::output_atoms_file_counter = output_atoms_file_counter64;
-      sim::output_cells_file_counter = output_cells_file_counter64;
-      sim::output_rate_counter = output_rate_counter64;
+      sim::parity = header.parity;
+      sim::iH = header.iH;
+      sim::time = header.time;
+      sim::equilibration_time = header.eqtime;
+      sim::temperature = header.temperature;
+      sim::output_atoms_file_counter = header.output_atoms_file_counter;
+      sim::output_cells_file_counter = header.output_cells_file_counter;
+      sim::output_rate_counter = header.output_rate_counter;
    }
 
-   // Load spin positions
-   chkfile.read((char*)&atoms::x_spin_array[0],sizeof(double)*natoms64);
-   chkfile.read((char*)&atoms::y_spin_array[0],sizeof(double)*natoms64);
-   chkfile.read((char*)&atoms::z_spin_array[0],sizeof(double)*natoms64);
+   // Read an even block of atom ids and spins on each processor
+   const uint64_t id_start = rng_start + uint64_t(header.num_processors)*checkpoint::rng_bytes;
+   const uint64_t spin_start = id_start + header.natoms*sizeof(uint64_t);
+   const uint64_t base = header.natoms/size;
+   const uint64_t spare = header.natoms%size;
+   const uint64_t num_block = base + (uint64_t(rank) < spare ? 1 : 0);
+
+   std::vector<uint64_t> ids(num_block);
+   std::vector<double> spins(3*num_block);
+
+   #ifdef MPICF
+      const uint64_t first = rank*base + (uint64_t(rank) < spare ? rank : spare);
+      MPI_File_read_at_all(fh, id_start + first*sizeof(uint64_t), ids.data(), ids.size(), MPI_UINT64_T, MPI_STATUS_IGNORE);
+      MPI_File_read_at_all(fh, spin_start + 3*first*sizeof(double), spins.data(), spins.size(), MPI_DOUBLE, MPI_STATUS_IGNORE);
+      MPI_File_close(&fh);
+
+      // Check atom ids and spins
+      if(checkpoint::section_crc(ids.data(), sizeof(uint64_t)*ids.size())!=header.crc_ids) checkpoint::checksum_error(chkfilename, "atom ids");
+      if(checkpoint::section_crc(spins.data(), sizeof(double)*spins.size())!=header.crc_spins) checkpoint::checksum_error(chkfilename, "spins");
 
-   // close checkpoint file
-   chkfile.close();
+      // Send spins to processors owning each atom
+      checkpoint::redistribute_spins(ids, spins, natoms64, chkfilename);
+   #else
+      chkfile.seekg(id_start);
+      chkfile.read(reinterpret_cast<char*>(ids.data()), sizeof(uint64_t)*ids.size());
+      chkfile.seekg(spin_start);
+      chkfile.read(reinterpret_cast<char*>(spins.data()), sizeof(double)*spins.size());
+      chkfile.close();
+
+      // Check atom ids and spins
+      if(checkpoint::section_crc(ids.data(), sizeof(uint64_t)*ids.size())!=header.crc_ids) checkpoint::checksum_error(chkfilename, "atom ids");
+      if(checkpoint::section_crc(spins.data(), sizeof(double)*spins.size())!=header.crc_spins) checkpoint::checksum_error(chkfilename, "spins");
+
+      // Load spin positions in order of atom ids
+      checkpoint::sort_by_id(ids, spins);
+      for(uint64_t atom=0; atom<natoms64; atom++){
+         double s[3];
+         if(!checkpoint::find_spin(ids, spins, atoms::global_id_array[atom], s)) checkpoint::missing_atom_error(chkfilename);
+         atoms::x_spin_array[atom] = s[0];
+         atoms::y_spin_array[atom] = s[1];
+         atoms::z_spin_array[atom] = s[2];
+      }
+   #endif
+
+   // spins no longer match magnetisation tracked by Monte Carlo integrator
+   sim::mc_material_magnetization_valid=false;
 
    // log reading checkpoint file
    zlog << zTs() << "Checkpoint file loaded at sim::time " << sim::time << "." << std::endl;
@@ -178,3 +822,27 @@ void load_checkpoint(){
    return;
 
 }
+
+//-----------------------------------------------------------------------------
+// Function to save checkpoint file if the wall time interval has passed since
+// the last checkpoint. The decision is taken on the root process of the
+// processors sharing the checkpoint file so that they write it together, and
+// independently on each processor in statistical parallel mode.
+//-----------------------------------------------------------------------------
+void save_checkpoint_on_wall_time(){
+
+   if(sim::save_checkpoint_wall_time_interval<=0.0) return;
+
+   int due = std::difftime(std::time(NULL), checkpoint::last_save_time) >= 60.0*sim::save_checkpoint_wall_time_interval;
+   #ifdef MPICF
+      MPI_Bcast(&due, 1, MPI_INT, 0, checkpoint::communicator());
+   #endif
+
+   if(due){
+      zlog << zTs() << "Saving checkpoint after " << sim::save_checkpoint_wall_time_interval << " minutes of wall time." << std::endl;
+      save_checkpoint();
+   }
+
+   return;
+
+}
@@ -0,0 +1,180 @@
+#ifndef VOUT_INTERNAL_H_
+#define VOUT_INTERNAL_H_
+//-----------------------------------------------------------------------------
+//
+// This header file is part of the VAMPIRE open source package under the
+// GNU GPL (version 2) licence (see licence file for details).
+//
+// (c) R F L Evans 2016. All rights reserved.
+//
+//-----------------------------------------------------------------------------
+
+//---------------------------------------------------------------------
+// Defines shared internal data structures and functions for the
+// configuration output implementation. These functions should
+// not be accessed outside of the output code.
+//---------------------------------------------------------------------
+
+// C++ standard library headers
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <stdint.h>
+
+// Vampire headers
+#include "errors.hpp"
+#include "vio.hpp"
+#include "vmpi.hpp"
+
+namespace vout{
+
+   //-----------------------------------------------------------------------------
+   // Shared functions for configuration output
+   //-----------------------------------------------------------------------------
+   void set_local_output_atom_list();
+   void reduce_cell_fields();
+
+   namespace internal{
+
+      const int binary_config_version = 2; /// version of binary configuration file formats
+
+      //-----------------------------------------------------------------------------
+      // Internal functions for binary configuration output
+      //-----------------------------------------------------------------------------
+      void append_identifier(std::vector<char>& header, const char* id);
+      std::vector<float> single_precision(const std::vector<double>& data);
+      void write_real_block(std::ofstream& ofs, const std::vector<double>& data);
+      void output_atom_offset(uint64_t& offset, uint64_t& total);
+
+      //------------------------------------------------------------------------------------------------------
+      // Function to append a value to a binary header buffer
+      //------------------------------------------------------------------------------------------------------
+      template <typename T> void append_to_header(std::vector<char>& header, const T value){
+         const char* bytes = reinterpret_cast<const char*>(&value);
+         header.insert(header.end(), bytes, bytes+sizeof(T));
+      }
+
+      //------------------------------------------------------------------------------------------------------
+      // Shared binary file written by all processors at explicit offsets
+      //------------------------------------------------------------------------------------------------------
+      class shared_binary_file_t{
+
+         public:
+
+            //---------------------------------------------------------------------------------------------
+            // Open file on all processors, truncating any existing data unless appending
+            //---------------------------------------------------------------------------------------------
+            void open(const std::string& filename, const bool append=false){
+               #ifdef MPICF
+                  int err = MPI_File_open(MPI_COMM_WORLD, const_cast<char*>(filename.c_str()), MPI_MODE_CREATE | MPI_MODE_WRONLY, MPI_INFO_NULL, &fh);
+                  if(err==MPI_SUCCESS && !append) err = MPI_File_set_size(fh, 0);
+                  if(err!=MPI_SUCCESS) open_error(filename);
+               #else
+                  if(append) ofs.open(filename.c_str(), std::ios::in | std::ios::out | std::ios::binary);
+                  if(!ofs.is_open()) ofs.open(filename.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+                  if(!ofs.is_open()) open_error(filename);
+               #endif
+            }
+
+            //---------------------------------------------------------------------------------------------
+            // Write header on root process
+            //---------------------------------------------------------------------------------------------
+            void write_header(const std::vector<char>& header, const uint64_t offset=0){
+               #ifdef MPICF
+                  if(vmpi::my_rank==0) MPI_File_write_at(fh, offset, const_cast<char*>(&header[0]), header.size(), MPI_BYTE, MPI_STATUS_IGNORE);
+               #else
+                  ofs.seekp(offset);
+                  ofs.write(&header[0], header.size());
+               #endif
+            }
+
+            //---------------------------------------------------------------------------------------------
+            // Collectively write a block of local data at a byte offset in the file
+            //---------------------------------------------------------------------------------------------
+            void write_at(const uint64_t offset, const std::vector<unsigned char>& data){
+               #ifdef MPICF
+                  MPI_File_write_at_all(fh, offset, const_cast<unsigned char*>(data.data()), data.size(), MPI_BYTE, MPI_STATUS_IGNORE);
+               #else
+                  write_bytes(offset, reinterpret_cast<const char*>(data.data()), data.size());
+               #endif
+            }
+
+            void write_at(const uint64_t offset, const std::vector<uint64_t>& data){
+               #ifdef MPICF
+                  MPI_File_write_at_all(fh, offset, const_cast<uint64_t*>(data.data()), data.size(), MPI_UINT64_T, MPI_STATUS_IGNORE);
+               #else
+                  write_bytes(offset, reinterpret_cast<const char*>(data.data()), data.size()*sizeof(uint64_t));
+               #endif
+            }
+
+            void write_at(const uint64_t offset, const std::vector<int>& data){
+               #ifdef MPICF
+                  MPI_File_write_at_all(fh, offset, const_cast<int*>(data.data()), data.size(), MPI_INT, MPI_STATUS_IGNORE);
+               #else
+                  write_bytes(offset, reinterpret_cast<const char*>(data.data()), data.size()*sizeof(int));
+               #endif
+            }
+
+            void write_at(const uint64_t offset, const std::vector<double>& data){
+               #ifdef MPICF
+                  MPI_File_write_at_all(fh, offset, const_cast<double*>(data.data()), data.size(), MPI_DOUBLE, MPI_STATUS_IGNORE);
+               #else
+                  write_bytes(offset, reinterpret_cast<const char*>(data.data()), data.size()*sizeof(double));
+               #endif
+            }
+
+            void write_at(const uint64_t offset, const std::vector<float>& data){
+               #ifdef MPICF
+                  MPI_File_write_at_all(fh, offset, const_cast<float*>(data.data()), data.size(), MPI_FLOAT, MPI_STATUS_IGNORE);
+               #else
+                  write_bytes(offset, reinterpret_cast<const char*>(data.data()), data.size()*sizeof(float));
+               #endif
+            }
+
+            //---------------------------------------------------------------------------------------------
+            // Collectively write a block of local values at the output precision
+            //---------------------------------------------------------------------------------------------
+            void write_real_at(const uint64_t offset, const std::vector<double>& data){
+               if(vout::output_config_precision==4) write_at(offset, single_precision(data));
+               else write_at(offset, data);
+            }
+
+            //---------------------------------------------------------------------------------------------
+            // Close file on all processors
+            //---------------------------------------------------------------------------------------------
+            void close(){
+               #ifdef MPICF
+                  MPI_File_close(&fh);
+               #else
+                  ofs.close();
+               #endif
+            }
+
+         private:
+
+            #ifdef MPICF
+               MPI_File fh;
+            #else
+               std::ofstream ofs;
+               void write_bytes(const uint64_t offset, const char* data, const uint64_t bytes){
+                  ofs.seekp(offset);
+                  ofs.write(data, bytes);
+               }
+            #endif
+
+            void open_error(const std::string& filename){
+               terminaltextcolor(RED);
+               std::cerr << "Error - unable to open binary configuration file " << filename << " for writing" << std::endl;
+               terminaltextcolor(WHITE);
+               zlog << zTs() << "Error - unable to open binary configuration file " << filename << " for writing" << std::endl;
+               err::vexit();
+            }
+
+      };
+
+   } // end of internal namespace
+} // end of vout namespace
+
+#endif //VOUT_INTERNAL_H_
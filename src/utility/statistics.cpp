@@ -57,6 +57,7 @@
 
 #include <cmath>
 #include <iostream>
+#include <vector>
 
 //Function prototypes
 int calculate_spin_fields(const int,const int);
@@ -96,10 +97,10 @@ namespace stats
    double mean_total_magnetostatic_energy      = 0.0;
 
    double energy_data_counter = 0.0;
-   bool calculate_energy = false;
+   schedule_t energy_schedule = never;
 
 	// torque calculation
-	bool calculate_torque=false;
+	schedule_t torque_schedule = never;
 	double total_system_torque[3]={0.0,0.0,0.0};
 	double total_mean_system_torque[3]={0.0,0.0,0.0};
 
@@ -166,7 +167,7 @@ int mag_m(){
 
       // Calculate global moment for all CPUs
       #ifdef MPICF
-         MPI::COMM_WORLD.Allreduce(MPI_IN_PLACE,&stats::max_moment,1,MPI_DOUBLE,MPI_SUM);
+         MPI_Allreduce(MPI_IN_PLACE,&stats::max_moment,1,MPI_DOUBLE,MPI_SUM,vmpi::statistics_communicator());
       #endif
 
       // Resize arrays
@@ -180,13 +181,21 @@ int mag_m(){
    }
 
    // update statistics - need to eventually replace mag_m() with stats::update()...
-   stats::update(atoms::x_spin_array, atoms::y_spin_array, atoms::z_spin_array, atoms::m_spin_array);
+   // using magnetisation of each material tracked by the Monte Carlo integrator if available
+   if(sim::integrator==1 && sim::mc_material_magnetization_valid){
+      stats::update(atoms::x_spin_array, atoms::y_spin_array, atoms::z_spin_array, atoms::m_spin_array, sim::mc_material_magnetization);
+   }
+   else stats::update(atoms::x_spin_array, atoms::y_spin_array, atoms::z_spin_array, atoms::m_spin_array);
+
+   // Instantaneous torque and energy are only needed at steps which are output (identical on all
+   // processors), while their means need every update
+   const bool output_step = (sim::time%vout::output_rate==0);
 
    // optionally calculate system torque
-   if(stats::calculate_torque==true) stats::system_torque();
+   if(stats::torque_schedule==every_update || (stats::torque_schedule==output_steps && output_step)) stats::system_torque();
 
    // optionally calculate energy
-   if(stats::calculate_energy==true) stats::system_energy();
+   if(stats::energy_schedule==every_update || (stats::energy_schedule==output_steps && output_step)) stats::system_energy();
 
    // increment data counter
    stats::data_counter+=1.0;
@@ -294,7 +303,7 @@ double max_torque(){
 
    // find max torque on all nodes
    #ifdef MPICF
-      MPI::COMM_WORLD.Allreduce(MPI_IN_PLACE,&max_torque,1,MPI_DOUBLE,MPI_MAX);
+      MPI_Allreduce(MPI_IN_PLACE,&max_torque,1,MPI_DOUBLE,MPI_MAX,vmpi::statistics_communicator());
    #endif
 
   return max_torque;
@@ -341,10 +350,10 @@ void system_torque(){
 
 	// reduce torque on all nodes
 	#ifdef MPICF
-		MPI::COMM_WORLD.Allreduce(MPI_IN_PLACE,&torque[0],3,MPI_DOUBLE,MPI_SUM);
-		MPI::COMM_WORLD.Allreduce(MPI_IN_PLACE,&stats::sublattice_mean_torque_x_array[0],mp::num_materials,MPI_DOUBLE,MPI_SUM);
-		MPI::COMM_WORLD.Allreduce(MPI_IN_PLACE,&stats::sublattice_mean_torque_y_array[0],mp::num_materials,MPI_DOUBLE,MPI_SUM);
-		MPI::COMM_WORLD.Allreduce(MPI_IN_PLACE,&stats::sublattice_mean_torque_z_array[0],mp::num_materials,MPI_DOUBLE,MPI_SUM);
+		MPI_Allreduce(MPI_IN_PLACE,&torque[0],3,MPI_DOUBLE,MPI_SUM,vmpi::statistics_communicator());
+		MPI_Allreduce(MPI_IN_PLACE,&stats::sublattice_mean_torque_x_array[0],mp::num_materials,MPI_DOUBLE,MPI_SUM,vmpi::statistics_communicator());
+		MPI_Allreduce(MPI_IN_PLACE,&stats::sublattice_mean_torque_y_array[0],mp::num_materials,MPI_DOUBLE,MPI_SUM,vmpi::statistics_communicator());
+		MPI_Allreduce(MPI_IN_PLACE,&stats::sublattice_mean_torque_z_array[0],mp::num_materials,MPI_DOUBLE,MPI_SUM,vmpi::statistics_communicator());
 	#endif
 
 	// Set stats values
@@ -363,191 +372,135 @@ void system_torque(){
 
 ///---------------------------------------------------------------------------
 ///
-///                     Function to calculate system energy
+///             Function to calculate energy terms of local spins
 ///
-///        Wraps the single spin energy functions used for MC calculation
+///        Wraps the single spin energy functions used for MC calculation,
+///        evaluating all energy terms in a single threaded pass over spins.
+///        Energies are returned in the order total, exchange, anisotropy,
+///        second order, lattice, cubic, surface, applied field and
+///        magnetostatic without reduction between processors.
 ///
 ///---------------------------------------------------------------------------
-void system_energy(){
+void calculate_local_energy(double energies[9]){
+
+   // Material moments looked up once rather than for every atom; all energy terms, including the
+   // temperature dependent lattice anisotropy, are still evaluated per atom by the sim:: functions
+   std::vector<double> mu_s(mp::num_materials);
+   for(int imaterial=0; imaterial<mp::num_materials; imaterial++) mu_s[imaterial]=mp::material[imaterial].mu_s_SI;
+
+   const int exchange_type = atoms::exchange_type;
+   const int anisotropy_type = sim::AnisotropyType;
+   const bool cubic_anisotropy = sim::CubicScalarAnisotropy;
+   const bool so_anisotropy = sim::second_order_uniaxial_anisotropy;
+   const bool lattice_anisotropy = sim::lattice_anisotropy_flag;
+   const bool surface_anisotropy = sim::surface_anisotropy;
+
+   double exchange_energy=0.0;
+   double anisotropy_energy=0.0;
+   double cubic_anisotropy_energy=0.0;
+   double so_anisotropy_energy=0.0;
+   double lattice_anisotropy_energy=0.0;
+   double surface_anisotropy_energy=0.0;
+   double applied_field_energy=0.0;
+   double magnetostatic_energy=0.0;
+
+   //----------------------------------------------------------
+   // Calculate all energy terms in a single pass over spins
+   //----------------------------------------------------------
+   #pragma omp parallel for reduction(+:exchange_energy,anisotropy_energy,cubic_anisotropy_energy,so_anisotropy_energy,lattice_anisotropy_energy,surface_anisotropy_energy,applied_field_energy,magnetostatic_energy)
+   for(int atom=0; atom<stats::num_atoms; atom++){
+
+      const double Sx=atoms::x_spin_array[atom];
+      const double Sy=atoms::y_spin_array[atom];
+      const double Sz=atoms::z_spin_array[atom];
+      const int imaterial=atoms::type_array[atom];
+      const double mu=mu_s[imaterial];
+
+      // exchange energy
+      if(exchange_type==0)      exchange_energy+=sim::spin_exchange_energy_isotropic(atom, Sx, Sy, Sz)*mu; // Isotropic
+      else if(exchange_type==1) exchange_energy+=sim::spin_exchange_energy_vector(atom, Sx, Sy, Sz)*mu; // Anisotropic
+      else if(exchange_type==2) exchange_energy+=sim::spin_exchange_energy_tensor(atom, Sx, Sy, Sz)*mu; // Tensor
+
+      // anisotropy energy
+      if(anisotropy_type==0)      anisotropy_energy+=sim::spin_scalar_anisotropy_energy(imaterial, Sz)*mu; // Isotropic
+      else if(anisotropy_type==1) anisotropy_energy+=sim::spin_tensor_anisotropy_energy(imaterial, Sx, Sy, Sz)*mu; // Tensor
+
+      // other energy
+      if(cubic_anisotropy) cubic_anisotropy_energy+=sim::spin_cubic_anisotropy_energy(imaterial, Sx, Sy, Sz)*mu;
+      if(so_anisotropy)    so_anisotropy_energy+=sim::spin_second_order_uniaxial_anisotropy_energy(imaterial, Sx, Sy, Sz)*mu;
+      if(lattice_anisotropy) lattice_anisotropy_energy+=sim::spin_lattice_anisotropy_energy(imaterial, Sx, Sy, Sz)*mu;
+      if(surface_anisotropy) surface_anisotropy_energy+=sim::spin_surface_anisotropy_energy(atom, imaterial, Sx, Sy, Sz)*mu;
+      applied_field_energy+=sim::spin_applied_field_energy(Sx, Sy, Sz)*mu;
+      magnetostatic_energy+=sim::spin_magnetostatic_energy(atom, Sx, Sy, Sz)*mu;
 
-   // Reinitialise stats values
-   stats::total_energy=0.0;
-   stats::total_exchange_energy=0.0;
-   stats::total_anisotropy_energy=0.0;
-   stats::total_lattice_anisotropy_energy=0.0;
-   stats::total_so_anisotropy_energy=0.0;
-   stats::total_cubic_anisotropy_energy=0.0;
-   stats::total_surface_anisotropy_energy=0.0;
-   stats::total_applied_field_energy=0.0;
-   stats::total_magnetostatic_energy=0.0;
-
-   //------------------------------
-   // Calculate exchange energy
-   //------------------------------
-   if(atoms::exchange_type==0){ // Isotropic
-      double energy=0.0;
-      for(int atom=0; atom<stats::num_atoms; atom++){
-         double Sx=atoms::x_spin_array[atom];
-         double Sy=atoms::y_spin_array[atom];
-         double Sz=atoms::z_spin_array[atom];
-         const int imaterial=atoms::type_array[atom];
-         energy+=sim::spin_exchange_energy_isotropic(atom, Sx, Sy, Sz)*mp::material[imaterial].mu_s_SI;
-      }
-      stats::total_exchange_energy=energy;
-   }
-   else if(atoms::exchange_type==1){ // Anisotropic
-      double energy=0.0;
-      for(int atom=0; atom<stats::num_atoms; atom++){
-         double Sx=atoms::x_spin_array[atom];
-         double Sy=atoms::y_spin_array[atom];
-         double Sz=atoms::z_spin_array[atom];
-         const int imaterial=atoms::type_array[atom];
-         energy+=sim::spin_exchange_energy_vector(atom, Sx, Sy, Sz)*mp::material[imaterial].mu_s_SI;
-      }
-      stats::total_exchange_energy=energy;
-   }
-   else if(atoms::exchange_type==2){ // Tensor
-      double energy=0.0;
-      for(int atom=0; atom<stats::num_atoms; atom++){
-         double Sx=atoms::x_spin_array[atom];
-         double Sy=atoms::y_spin_array[atom];
-         double Sz=atoms::z_spin_array[atom];
-         const int imaterial=atoms::type_array[atom];
-         energy+=sim::spin_exchange_energy_tensor(atom, Sx, Sy, Sz)*mp::material[imaterial].mu_s_SI;
-      }
-      stats::total_exchange_energy=energy;
-   }
-   //------------------------------
-   // Calculate anisotropy energy
-   //------------------------------
-   if(sim::AnisotropyType==0){ // Isotropic
-      double energy=0.0;
-      for(int atom=0; atom<stats::num_atoms; atom++){
-         const double Sz=atoms::z_spin_array[atom];
-         const int imaterial=atoms::type_array[atom];
-         energy+=sim::spin_scalar_anisotropy_energy(imaterial, Sz)*mp::material[imaterial].mu_s_SI;
-      }
-      stats::total_anisotropy_energy=energy;
-   }
-   else if(sim::AnisotropyType==1){ // Tensor
-      double energy=0.0;
-      for(int atom=0; atom<stats::num_atoms; atom++){
-         const double Sx=atoms::x_spin_array[atom];
-         const double Sy=atoms::y_spin_array[atom];
-         const double Sz=atoms::z_spin_array[atom];
-         const int imaterial=atoms::type_array[atom];
-         energy+=sim::spin_tensor_anisotropy_energy(imaterial, Sx, Sy, Sz)*mp::material[imaterial].mu_s_SI;
-      }
-      stats::total_anisotropy_energy=energy;
-   }
-   //------------------------------
-   // Calculate other energy
-   //------------------------------
-   if(sim::CubicScalarAnisotropy==true){
-      double energy=0.0;
-      for(int atom=0; atom<stats::num_atoms; atom++){
-         const double Sx=atoms::x_spin_array[atom];
-         const double Sy=atoms::y_spin_array[atom];
-         const double Sz=atoms::z_spin_array[atom];
-         const int imaterial=atoms::type_array[atom];
-         energy+=sim::spin_cubic_anisotropy_energy(imaterial, Sx, Sy, Sz)*mp::material[imaterial].mu_s_SI;
-      }
-      stats::total_cubic_anisotropy_energy=energy;
-   }
-   if(sim::second_order_uniaxial_anisotropy){
-      double energy=0.0;
-      for(int atom=0; atom<stats::num_atoms; atom++){
-         const double Sx=atoms::x_spin_array[atom];
-         const double Sy=atoms::y_spin_array[atom];
-         const double Sz=atoms::z_spin_array[atom];
-         const int imaterial=atoms::type_array[atom];
-         energy+=sim::spin_second_order_uniaxial_anisotropy_energy(imaterial, Sx, Sy, Sz)*mp::material[imaterial].mu_s_SI;
-      }
-      stats::total_so_anisotropy_energy=energy;
-   }
-   if(sim::lattice_anisotropy_flag){
-      double energy=0.0;
-      for(int atom=0; atom<stats::num_atoms; atom++){
-         const double Sx=atoms::x_spin_array[atom];
-         const double Sy=atoms::y_spin_array[atom];
-         const double Sz=atoms::z_spin_array[atom];
-         const int imaterial=atoms::type_array[atom];
-         energy+=sim::spin_lattice_anisotropy_energy(imaterial, Sx, Sy, Sz)*mp::material[imaterial].mu_s_SI;
-      }
-      stats::total_lattice_anisotropy_energy=energy;
-   }
-   if(sim::surface_anisotropy==true){
-      double energy=0.0;
-      for(int atom=0; atom<stats::num_atoms; atom++){
-         const double Sx=atoms::x_spin_array[atom];
-         const double Sy=atoms::y_spin_array[atom];
-         const double Sz=atoms::z_spin_array[atom];
-         const int imaterial=atoms::type_array[atom];
-         energy+=sim::spin_surface_anisotropy_energy(atom, imaterial, Sx, Sy, Sz)*mp::material[imaterial].mu_s_SI;
-      }
-      stats::total_surface_anisotropy_energy=energy;
-   }
-   {
-      double energy=0.0;
-      for(int atom=0; atom<stats::num_atoms; atom++){
-         const double Sx=atoms::x_spin_array[atom];
-         const double Sy=atoms::y_spin_array[atom];
-         const double Sz=atoms::z_spin_array[atom];
-         const int imaterial=atoms::type_array[atom];
-         energy+=sim::spin_applied_field_energy(Sx, Sy, Sz)*mp::material[imaterial].mu_s_SI;
-      }
-      stats::total_applied_field_energy=energy;
-   }
-   {
-      double energy=0.0;
-      for(int atom=0; atom<stats::num_atoms; atom++){
-         const double Sx=atoms::x_spin_array[atom];
-         const double Sy=atoms::y_spin_array[atom];
-         const double Sz=atoms::z_spin_array[atom];
-         const int imaterial=atoms::type_array[atom];
-         energy+=sim::spin_magnetostatic_energy(atom, Sx, Sy, Sz)*mp::material[imaterial].mu_s_SI;
-      }
-      stats::total_magnetostatic_energy=energy;
    }
 
-   // Calculate total energy
-   stats::total_energy = stats::total_exchange_energy +
-                         stats::total_anisotropy_energy +
-                         stats::total_so_anisotropy_energy +
-                         stats::total_lattice_anisotropy_energy +
-                         stats::total_cubic_anisotropy_energy +
-                         stats::total_surface_anisotropy_energy +
-                         stats::total_applied_field_energy +
-                         stats::total_magnetostatic_energy;
+   energies[0] = exchange_energy +
+                 anisotropy_energy +
+                 so_anisotropy_energy +
+                 lattice_anisotropy_energy +
+                 cubic_anisotropy_energy +
+                 surface_anisotropy_energy +
+                 applied_field_energy +
+                 magnetostatic_energy;
+   energies[1] = exchange_energy;
+   energies[2] = anisotropy_energy;
+   energies[3] = so_anisotropy_energy;
+   energies[4] = lattice_anisotropy_energy;
+   energies[5] = cubic_anisotropy_energy;
+   energies[6] = surface_anisotropy_energy;
+   energies[7] = applied_field_energy;
+   energies[8] = magnetostatic_energy;
+
+   return;
+
+}
+
+///---------------------------------------------------------------------------
+///
+///   Functions to register the steps at which torque and energy are needed,
+///   keeping the most frequent requirement of all output items
+///
+///---------------------------------------------------------------------------
+void require_torque(const schedule_t schedule){
+   if(schedule > stats::torque_schedule) stats::torque_schedule = schedule;
+}
+
+void require_energy(const schedule_t schedule){
+   if(schedule > stats::energy_schedule) stats::energy_schedule = schedule;
+}
+
+///---------------------------------------------------------------------------
+///
+///                     Function to calculate system energy
+///
+///---------------------------------------------------------------------------
+void system_energy(){
+
+   // Calculate energy terms of local spins
+   double energies[9];
+   calculate_local_energy(energies);
 
    // reduce energies to root node
    #ifdef MPICF
       // MPI_IN_PLACE is only valid on root process for MPI_Reduce()
-      // MPI_Reduce(const void *sendbuf, void *recvbuf, int count, MPI_Datatype datatype, MPI_Op op, int root, MPI_Comm comm)
-      if(vmpi::my_rank==0){
-         MPI_Reduce(MPI_IN_PLACE, &stats::total_energy, 1, MPI_DOUBLE, MPI_SUM, 0, MPI_COMM_WORLD);
-         MPI_Reduce(MPI_IN_PLACE, &stats::total_exchange_energy, 1, MPI_DOUBLE, MPI_SUM, 0, MPI_COMM_WORLD);
-         MPI_Reduce(MPI_IN_PLACE, &stats::total_anisotropy_energy, 1, MPI_DOUBLE, MPI_SUM, 0, MPI_COMM_WORLD);
-         MPI_Reduce(MPI_IN_PLACE, &stats::total_so_anisotropy_energy, 1, MPI_DOUBLE, MPI_SUM, 0, MPI_COMM_WORLD);
-         MPI_Reduce(MPI_IN_PLACE, &stats::total_lattice_anisotropy_energy, 1, MPI_DOUBLE, MPI_SUM, 0, MPI_COMM_WORLD);
-         MPI_Reduce(MPI_IN_PLACE, &stats::total_cubic_anisotropy_energy, 1, MPI_DOUBLE, MPI_SUM, 0, MPI_COMM_WORLD);
-         MPI_Reduce(MPI_IN_PLACE, &stats::total_surface_anisotropy_energy, 1, MPI_DOUBLE, MPI_SUM, 0, MPI_COMM_WORLD);
-         MPI_Reduce(MPI_IN_PLACE, &stats::total_applied_field_energy, 1, MPI_DOUBLE, MPI_SUM, 0, MPI_COMM_WORLD);
-         MPI_Reduce(MPI_IN_PLACE, &stats::total_magnetostatic_energy, 1, MPI_DOUBLE, MPI_SUM, 0, MPI_COMM_WORLD);
-      }
-      else{
-         MPI_Reduce(&stats::total_energy, &stats::total_energy, 1, MPI_DOUBLE, MPI_SUM, 0, MPI_COMM_WORLD);
-         MPI_Reduce(&stats::total_exchange_energy, &stats::total_exchange_energy, 1, MPI_DOUBLE, MPI_SUM, 0, MPI_COMM_WORLD);
-         MPI_Reduce(&stats::total_anisotropy_energy, &stats::total_anisotropy_energy, 1, MPI_DOUBLE, MPI_SUM, 0, MPI_COMM_WORLD);
-         MPI_Reduce(&stats::total_so_anisotropy_energy, &stats::total_so_anisotropy_energy, 1, MPI_DOUBLE, MPI_SUM, 0, MPI_COMM_WORLD);
-         MPI_Reduce(&stats::total_lattice_anisotropy_energy, &stats::total_lattice_anisotropy_energy, 1, MPI_DOUBLE, MPI_SUM, 0, MPI_COMM_WORLD);
-         MPI_Reduce(&stats::total_cubic_anisotropy_energy, &stats::total_cubic_anisotropy_energy, 1, MPI_DOUBLE, MPI_SUM, 0, MPI_COMM_WORLD);
-         MPI_Reduce(&stats::total_surface_anisotropy_energy, &stats::total_surface_anisotropy_energy, 1, MPI_DOUBLE, MPI_SUM, 0, MPI_COMM_WORLD);
-         MPI_Reduce(&stats::total_applied_field_energy, &stats::total_applied_field_energy, 1, MPI_DOUBLE, MPI_SUM, 0, MPI_COMM_WORLD);
-         MPI_Reduce(&stats::total_magnetostatic_energy, &stats::total_magnetostatic_energy, 1, MPI_DOUBLE, MPI_SUM, 0, MPI_COMM_WORLD);
-      }
+      const MPI_Comm comm = vmpi::statistics_communicator();
+      int rank = 0;
+      MPI_Comm_rank(comm, &rank);
+      if(rank==0) MPI_Reduce(MPI_IN_PLACE, energies, 9, MPI_DOUBLE, MPI_SUM, 0, comm);
+      else        MPI_Reduce(energies, energies, 9, MPI_DOUBLE, MPI_SUM, 0, comm);
    #endif
 
+   stats::total_energy                    = energies[0];
+   stats::total_exchange_energy           = energies[1];
+   stats::total_anisotropy_energy         = energies[2];
+   stats::total_so_anisotropy_energy      = energies[3];
+   stats::total_lattice_anisotropy_energy = energies[4];
+   stats::total_cubic_anisotropy_energy   = energies[5];
+   stats::total_surface_anisotropy_energy = energies[6];
+   stats::total_applied_field_energy      = energies[7];
+   stats::total_magnetostatic_energy      = energies[8];
+
    // Add calculated values to mean
    stats::mean_total_energy                    += stats::total_energy;
    stats::mean_total_exchange_energy           += stats::total_exchange_energy;
@@ -67,6 +67,8 @@ namespace vout{
 
    bool output_atoms_config=false;
    int output_atoms_config_rate=1000;
+   int output_atoms_config_format=0; // 0 = text file per processor, 1 = single binary file, 2 = trajectory
+   int output_config_precision=8; // bytes per value in binary configuration files (4 or 8)
 
    //output_rate_counter_defined globally => not to be redifined here!!
 
@@ -83,6 +85,15 @@ namespace vout{
 
    bool output_cells_config=false;
    int output_cells_config_rate=1000;
+   int output_cells_config_format=0; // 0 = text file, 1 = binary file
+
+   int output_structure_factor_rate=1000;
+   int output_structure_factor_file_counter=0;
+
+   int output_dynamic_structure_factor_rate=1000;
+   int output_dynamic_structure_factor_file_counter=0;
+
+   int output_histogram_rate=1000;
 
    bool output_grains_config=false;
    int output_config_grain_rate=1000;
@@ -91,8 +102,20 @@ namespace vout{
    // function headers
    void atoms();
    void atoms_coords();
+   void atoms_binary();
+   void atoms_coords_binary();
+   void atoms_trajectory();
+   void atoms_snapshot();
+   void set_local_output_atom_list();
    void cells();
    void cells_coords();
+   void cells_binary();
+   void cells_coords_binary();
+   void cells_snapshot();
+   void reduce_cell_fields();
+   void structure_factor();
+   void dynamic_structure_factor();
+   void histograms();
 
 /// @brief Config master output function
 ///
@@ -139,6 +162,16 @@ void config(){
    // check calling of routine if error checking is activated
    if(err::check==true){std::cout << "vout::config has been called" << std::endl;}
 
+   // Configuration output assumes a decomposed system and is not available for independent simulations
+   #ifdef MPICF
+      if(vmpi::mpi_mode==2){
+         static bool warned=false;
+         if(!warned) zlog << zTs() << "Warning - configuration output is not supported in statistical parallel mode and has been disabled" << std::endl;
+         warned=true;
+         return;
+      }
+   #endif
+
    // atoms output
    if((vout::output_atoms_config==true) && (sim::output_rate_counter%output_atoms_config_rate==0)){
 
@@ -146,22 +179,16 @@ void config(){
       gpu::config::synchronise();
 
       if(sim::program!=2){
-         if(vout::output_rate_counter_coords==0) vout::atoms_coords();
-         vout::atoms();
-         vout::output_rate_counter_coords++;
+         vout::atoms_snapshot();
       }
       else if(sim::program==2){
          // output config only in range [minField_1;maxField_1] for decreasing field
          if((sim::H_applied>=maxField_1) && (sim::H_applied<=minField_1) && (sim::parity<0)){
-            if(vout::output_rate_counter_coords==0) vout::atoms_coords();
-            vout::atoms();
-            vout::output_rate_counter_coords++;
+            vout::atoms_snapshot();
          }
 	      // output config only in range [minField_2;maxField_2] for increasing field
          else if((sim::H_applied>=minField_2) && (sim::H_applied<=maxField_2) && (sim::parity>0)){
-            if(vout::output_rate_counter_coords==0) vout::atoms_coords();
-            vout::atoms();
-            vout::output_rate_counter_coords++;
+            vout::atoms_snapshot();
          }
       }
    }
@@ -170,27 +197,154 @@ void config(){
    if((vout::output_cells_config==true) && (sim::output_rate_counter%output_cells_config_rate==0)){
       // if(!program::hysteresis())
       if(sim::program!=2){
-         if(sim::output_cells_file_counter==0) vout::cells_coords();
-         vout::cells();
+         vout::cells_snapshot();
       }
       else if(sim::program==2){
          // output config only in range [minField_1;maxField_1] for decreasing field
          if((sim::H_applied>=maxField_1) && (sim::H_applied<=minField_1) && (sim::parity<0)){
-            if(sim::output_cells_file_counter==0) vout::cells_coords();
-            vout::cells();
+            vout::cells_snapshot();
          }
          // output config only in range [minField_2;maxField_2] for increasing field
          else if((sim::H_applied>=minField_2) && (sim::H_applied<=maxField_2) && (sim::parity>0)){
-            if(sim::output_cells_file_counter==0) vout::cells_coords();
-            vout::cells();
+            vout::cells_snapshot();
          }
       }
    }
 
+   // structure factor output
+   if((stats::calculate_structure_factor==true) && (sim::output_rate_counter%output_structure_factor_rate==0)){
+      vout::structure_factor();
+   }
+
+   // dynamic structure factor output
+   if((stats::calculate_dynamic_structure_factor==true) && (sim::output_rate_counter%output_dynamic_structure_factor_rate==0)){
+      vout::dynamic_structure_factor();
+   }
+
+   // histogram output
+   if((stats::histograms.size()>0) && (sim::output_rate_counter%output_histogram_rate==0)){
+      vout::histograms();
+   }
+
    // increment rate counter
    sim::output_rate_counter++;
 
 }
+//------------------------------------------------------------------------------------------------------
+// Function to output averaged structure factor (and correlation function) from root process
+//------------------------------------------------------------------------------------------------------
+void structure_factor(){
+
+   if(vmpi::my_rank==0){
+
+      // Set output filename
+      std::stringstream file_sstr;
+      file_sstr << "structure-factor-";
+      file_sstr << std::setfill('0') << std::setw(8) << vout::output_structure_factor_file_counter;
+      file_sstr << ".txt";
+
+      zlog << zTs() << "Outputting structure factor " << vout::output_structure_factor_file_counter << " to disk." << std::endl;
+
+      stats::structure_factor.output(file_sstr.str(), stats::calculate_correlation_function);
+
+   }
+
+   vout::output_structure_factor_file_counter++;
+
+}
+//------------------------------------------------------------------------------------------------------
+// Function to output averaged dynamic structure factor from root process
+//------------------------------------------------------------------------------------------------------
+void dynamic_structure_factor(){
+
+   // complete any outstanding reduction of statistics
+   stats::complete_reduction();
+
+   if(vmpi::my_rank==0){
+
+      // Set output filename
+      std::stringstream file_sstr;
+      file_sstr << "dynamic-structure-factor-";
+      file_sstr << std::setfill('0') << std::setw(8) << vout::output_dynamic_structure_factor_file_counter;
+      file_sstr << ".txt";
+
+      zlog << zTs() << "Outputting dynamic structure factor " << vout::output_dynamic_structure_factor_file_counter << " to disk." << std::endl;
+
+      // samples are taken at every statistics update
+      stats::dynamic_structure_factor.output(file_sstr.str(), double(sim::partial_time)*mp::dt_SI);
+
+   }
+
+   vout::output_dynamic_structure_factor_file_counter++;
+
+}
+//------------------------------------------------------------------------------------------------------
+// Function to append distributions accumulated since last output to histogram file from root process
+//------------------------------------------------------------------------------------------------------
+void histograms(){
+
+   // complete any outstanding reduction of statistics
+   stats::complete_reduction();
+
+   if(vmpi::my_rank==0){
+
+      static std::ofstream ofile;
+
+      // open file and write histogram ranges on first call
+      if(!ofile.is_open()){
+         ofile.open("histograms.txt");
+         ofile.precision(vout::precision);
+         if(vout::fixed) ofile.setf( std::ios::fixed, std::ios::floatfield );
+         ofile << "# Histograms of atomic spin z-component, local temperature and grain magnetisation length" << std::endl;
+         for(unsigned int h=0; h<stats::histograms.size(); h++) stats::histograms[h].output_header(ofile);
+         ofile << "# time\tquantity\tgroup\tid\tfraction in each bin" << std::endl;
+      }
+
+      for(unsigned int h=0; h<stats::histograms.size(); h++) stats::histograms[h].output(ofile, sim::time);
+      ofile << std::flush;
+
+   }
+   // keep accumulated counts consistent on all processors
+   else for(unsigned int h=0; h<stats::histograms.size(); h++) stats::histograms[h].reset_averages();
+
+}
+//------------------------------------------------------------------------------------------------------
+// Function to output atomistic configuration in selected format, with coordinates on first call
+//------------------------------------------------------------------------------------------------------
+void atoms_snapshot(){
+
+   if(vout::output_atoms_config_format==1){
+      if(vout::output_rate_counter_coords==0) vout::atoms_coords_binary();
+      vout::atoms_binary();
+   }
+   else if(vout::output_atoms_config_format==2){
+      vout::atoms_trajectory(); // coordinates are stored in trajectory file
+   }
+   else{
+      if(vout::output_rate_counter_coords==0) vout::atoms_coords();
+      vout::atoms();
+   }
+
+   vout::output_rate_counter_coords++;
+
+}
+
+//------------------------------------------------------------------------------------------------------
+// Function to output cell configuration in selected format, with coordinates on first call
+//------------------------------------------------------------------------------------------------------
+void cells_snapshot(){
+
+   if(vout::output_cells_config_format==1){
+      if(sim::output_cells_file_counter==0) vout::cells_coords_binary();
+      vout::cells_binary();
+   }
+   else{
+      if(sim::output_cells_file_counter==0) vout::cells_coords();
+      vout::cells();
+   }
+
+}
+
 /// @brief Atomistic output function
 ///
 /// @details Outputs formatted data snapshot for visualisation
@@ -249,14 +403,12 @@ void config(){
       file_sstr << std::setfill('0') << std::setw(8) << sim::output_atoms_file_counter;
       file_sstr << ".cfg";
       std::string cfg_file = file_sstr.str();
-      const char* cfg_filec = cfg_file.c_str();
 
       // Output informative message to log file
       zlog << zTs() << "Outputting configuration file " << cfg_file << " to disk" << std::endl;
 
-      // Declare and open output file
-      std::ofstream cfg_file_ofstr;
-      cfg_file_ofstr.open (cfg_filec);
+      // Format header in memory
+      std::ostringstream cfg_file_ofstr;
 
       // Output masterfile header on root process
       if(vmpi::my_rank==0){
@@ -264,45 +416,88 @@ void config(){
       time_t rawtime = time(NULL);
       struct tm * timeinfo = localtime(&rawtime);
 
-         cfg_file_ofstr << "#------------------------------------------------------"<< std::endl;
-         cfg_file_ofstr << "# Atomistic spin configuration file for vampire"<< std::endl;
-         cfg_file_ofstr << "#------------------------------------------------------"<< std::endl;
+         cfg_file_ofstr << "#------------------------------------------------------\n";
+         cfg_file_ofstr << "# Atomistic spin configuration file for vampire\n";
+         cfg_file_ofstr << "#------------------------------------------------------\n";
          cfg_file_ofstr << "# Date: "<< asctime(timeinfo);
-         cfg_file_ofstr << "#------------------------------------------------------"<< std::endl;
-         cfg_file_ofstr << "Number of spins: "<< vout::total_output_atoms << std::endl;
-         cfg_file_ofstr << "System dimensions:" << cs::system_dimensions[0] << "\t" << cs::system_dimensions[1] << "\t" << cs::system_dimensions[2] << std::endl;
-         cfg_file_ofstr << "Coordinates-file: atoms-coord.cfg"<< std::endl;
-         cfg_file_ofstr << "Time: " << double(sim::time)*mp::dt_SI << std::endl;
-         cfg_file_ofstr << "Field: " << sim::H_applied << std::endl;
-         cfg_file_ofstr << "Temperature: "<< sim::temperature << std::endl;
-         cfg_file_ofstr << "Magnetisation: " << stats::system_magnetization.output_normalized_magnetization() << std::endl;
-         cfg_file_ofstr << "Number of Materials: " << mp::num_materials << std::endl;
+         cfg_file_ofstr << "#------------------------------------------------------\n";
+         cfg_file_ofstr << "Number of spins: "<< vout::total_output_atoms << "\n";
+         cfg_file_ofstr << "System dimensions:" << cs::system_dimensions[0] << "\t" << cs::system_dimensions[1] << "\t" << cs::system_dimensions[2] << "\n";
+         cfg_file_ofstr << "Coordinates-file: atoms-coord.cfg\n";
+         cfg_file_ofstr << "Time: " << double(sim::time)*mp::dt_SI << "\n";
+         cfg_file_ofstr << "Field: " << sim::H_applied << "\n";
+         cfg_file_ofstr << "Temperature: "<< sim::temperature << "\n";
+         cfg_file_ofstr << "Magnetisation: " << stats::system_magnetization.output_normalized_magnetization() << "\n";
+         cfg_file_ofstr << "Number of Materials: " << mp::num_materials << "\n";
          for(int mat=0;mat<mp::num_materials;mat++){
-            cfg_file_ofstr << mp::material[mat].mu_s_SI << std::endl;
+            cfg_file_ofstr << mp::material[mat].mu_s_SI << "\n";
          }
-         cfg_file_ofstr << "#------------------------------------------------------" << std::endl;
-         cfg_file_ofstr << "Number of spin files: " << vmpi::num_processors-1 << std::endl;
+         cfg_file_ofstr << "#------------------------------------------------------\n";
+         cfg_file_ofstr << "Number of spin files: " << vmpi::num_processors-1 << "\n";
          for(int p=1;p<vmpi::num_processors;p++){
             std::stringstream cfg_sstr;
             cfg_sstr << "atoms-" << std::setfill('0') << std::setw(5) << p << "-" << std::setfill('0') << std::setw(8) << sim::output_atoms_file_counter << ".cfg";
-            cfg_file_ofstr << cfg_sstr.str() << std::endl;
+            cfg_file_ofstr << cfg_sstr.str() << "\n";
          }
-         cfg_file_ofstr << "#------------------------------------------------------"<< std::endl;
+         cfg_file_ofstr << "#------------------------------------------------------\n";
       }
 
-      // Everyone now outputs their atom list
-      cfg_file_ofstr << vout::local_output_atom_list.size() << std::endl;
+      // Everyone now stages their atom list for output
+      cfg_file_ofstr << vout::local_output_atom_list.size() << "\n";
+      std::vector<double> spins(3*vout::local_output_atom_list.size());
       for(unsigned int i=0; i<vout::local_output_atom_list.size(); i++){
          const int atom = vout::local_output_atom_list[i];
-         cfg_file_ofstr << atoms::x_spin_array[atom] << "\t" << atoms::y_spin_array[atom] << "\t" << atoms::z_spin_array[atom] << std::endl;
+         spins[3*i+0] = atoms::x_spin_array[atom];
+         spins[3*i+1] = atoms::y_spin_array[atom];
+         spins[3*i+2] = atoms::z_spin_array[atom];
       }
 
-      cfg_file_ofstr.close();
+      vout::write_snapshot(cfg_file, cfg_file_ofstr.str(), spins, 3, 0);
 
       sim::output_atoms_file_counter++;
 
    }
 
+//------------------------------------------------------------------------------------------------------
+// Function to determine list of local atoms within output bounds
+//------------------------------------------------------------------------------------------------------
+   void set_local_output_atom_list(){
+
+      #ifdef MPICF
+         const int num_atoms = vmpi::num_core_atoms+vmpi::num_bdry_atoms;
+      #else
+         const int num_atoms = atoms::num_atoms;
+      #endif
+
+      // resize atom list to zero
+      local_output_atom_list.resize(0);
+
+      // get output bounds
+      double minB[3]={vout::atoms_output_min[0]*cs::system_dimensions[0],
+                     vout::atoms_output_min[1]*cs::system_dimensions[1],
+                     vout::atoms_output_min[2]*cs::system_dimensions[2]};
+
+      double maxB[3]={vout::atoms_output_max[0]*cs::system_dimensions[0],
+                     vout::atoms_output_max[1]*cs::system_dimensions[1],
+                     vout::atoms_output_max[2]*cs::system_dimensions[2]};
+
+      // loop over all local atoms and record output list
+      for(int atom=0;atom<num_atoms;atom++){
+
+         const double cc[3] = {atoms::x_coord_array[atom],atoms::y_coord_array[atom],atoms::z_coord_array[atom]};
+
+         // check atom within output bounds
+         if((cc[0] >= minB[0]) && (cc[0]<=maxB[0])){
+            if((cc[1] >= minB[1]) && (cc[1]<=maxB[1])){
+               if((cc[2] >= minB[2]) && (cc[2]<=maxB[2])){
+                  local_output_atom_list.push_back(atom);
+               }
+            }
+         }
+      }
+
+   }
+
 /// @brief Atomistic output function
 ///
 /// @details Outputs formatted data snapshot for visualisation
@@ -343,38 +538,8 @@ void config(){
       // check calling of routine if error checking is activated
       if(err::check==true){std::cout << "vout::atoms_coords has been called" << std::endl;}
 
-      #ifdef MPICF
-         const int num_atoms = vmpi::num_core_atoms+vmpi::num_bdry_atoms;
-      #else
-         const int num_atoms = atoms::num_atoms;
-      #endif
-
-      // resize atom list to zero
-      local_output_atom_list.resize(0);
-
-      // get output bounds
-      double minB[3]={vout::atoms_output_min[0]*cs::system_dimensions[0],
-                     vout::atoms_output_min[1]*cs::system_dimensions[1],
-                     vout::atoms_output_min[2]*cs::system_dimensions[2]};
-
-      double maxB[3]={vout::atoms_output_max[0]*cs::system_dimensions[0],
-                     vout::atoms_output_max[1]*cs::system_dimensions[1],
-                     vout::atoms_output_max[2]*cs::system_dimensions[2]};
-
-      // loop over all local atoms and record output list
-      for(int atom=0;atom<num_atoms;atom++){
-
-         const double cc[3] = {atoms::x_coord_array[atom],atoms::y_coord_array[atom],atoms::z_coord_array[atom]};
-
-         // check atom within output bounds
-         if((cc[0] >= minB[0]) && (cc[0]<=maxB[0])){
-            if((cc[1] >= minB[1]) && (cc[1]<=maxB[1])){
-               if((cc[2] >= minB[2]) && (cc[2]<=maxB[2])){
-                  local_output_atom_list.push_back(atom);
-               }
-            }
-         }
-      }
+      // determine atoms to output on local processor
+      vout::set_local_output_atom_list();
 
       // calculate total atoms to output
       #ifdef MPICF
@@ -411,30 +576,30 @@ void config(){
                   time_t rawtime = time(NULL);
       struct tm * timeinfo = localtime(&rawtime);
 
-         cfg_file_ofstr << "#------------------------------------------------------"<< std::endl;
-         cfg_file_ofstr << "# Atomistic coordinates configuration file for vampire"<< std::endl;
-         cfg_file_ofstr << "#------------------------------------------------------"<< std::endl;
+         cfg_file_ofstr << "#------------------------------------------------------\n";
+         cfg_file_ofstr << "# Atomistic coordinates configuration file for vampire\n";
+         cfg_file_ofstr << "#------------------------------------------------------\n";
          cfg_file_ofstr << "# Date: "<< asctime(timeinfo);
-         cfg_file_ofstr << "#------------------------------------------------------"<< std::endl;
-         cfg_file_ofstr << "Number of atoms: "<< vout::total_output_atoms << std::endl;
-         cfg_file_ofstr << "#------------------------------------------------------" << std::endl;
-         cfg_file_ofstr << "Number of spin files: " << vmpi::num_processors-1 << std::endl;
+         cfg_file_ofstr << "#------------------------------------------------------\n";
+         cfg_file_ofstr << "Number of atoms: "<< vout::total_output_atoms << "\n";
+         cfg_file_ofstr << "#------------------------------------------------------\n";
+         cfg_file_ofstr << "Number of spin files: " << vmpi::num_processors-1 << "\n";
          for(int p=1;p<vmpi::num_processors;p++){
             std::stringstream cfg_sstr;
             cfg_sstr << "atoms-coords-" << std::setfill('0') << std::setw(5) << p << ".cfg";
-            cfg_file_ofstr << cfg_sstr.str() << std::endl;
+            cfg_file_ofstr << cfg_sstr.str() << "\n";
          }
-         cfg_file_ofstr << "#------------------------------------------------------"<< std::endl;
+         cfg_file_ofstr << "#------------------------------------------------------\n";
       }
 
       // Everyone now outputs their atom list
-      cfg_file_ofstr << vout::local_output_atom_list.size() << std::endl;
+      cfg_file_ofstr << vout::local_output_atom_list.size() << "\n";
       for(unsigned int i=0; i<vout::local_output_atom_list.size(); i++){
          const int atom = vout::local_output_atom_list[i];
          cfg_file_ofstr << atoms::type_array[atom] << "\t" << atoms::category_array[atom] << "\t" <<
          atoms::x_coord_array[atom] << "\t" << atoms::y_coord_array[atom] << "\t" << atoms::z_coord_array[atom] << "\t";
-         if(sim::identify_surface_atoms==true && atoms::surface_array[atom]==true) cfg_file_ofstr << "O " << std::endl;
-         else cfg_file_ofstr << mp::material[atoms::type_array[atom]].element << std::endl;
+         if(sim::identify_surface_atoms==true && atoms::surface_array[atom]==true) cfg_file_ofstr << "O \n";
+         else cfg_file_ofstr << mp::material[atoms::type_array[atom]].element << "\n";
       }
 
       cfg_file_ofstr.close();
@@ -487,56 +652,48 @@ void cells(){
    file_sstr << std::setfill('0') << std::setw(8) << sim::output_cells_file_counter;
    file_sstr << ".cfg";
    std::string cfg_file = file_sstr.str();
-   const char* cfg_filec = cfg_file.c_str();
 
-   #ifdef MPICF
    // Reduce demagnetisation fields to processor 0
-   if(vmpi::my_rank==0){
-      MPI_Reduce(MPI_IN_PLACE, &cells::x_field_array[0], cells::num_cells, MPI_DOUBLE, MPI_MIN, 0, MPI_COMM_WORLD);
-      MPI_Reduce(MPI_IN_PLACE, &cells::y_field_array[0], cells::num_cells, MPI_DOUBLE, MPI_MIN, 0, MPI_COMM_WORLD);
-      MPI_Reduce(MPI_IN_PLACE, &cells::z_field_array[0], cells::num_cells, MPI_DOUBLE, MPI_MIN, 0, MPI_COMM_WORLD);
-   }
-   else{
-      MPI_Reduce(&cells::x_field_array[0], &cells::x_field_array[0], cells::num_cells, MPI_DOUBLE, MPI_MIN, 0, MPI_COMM_WORLD);
-      MPI_Reduce(&cells::y_field_array[0], &cells::y_field_array[0], cells::num_cells, MPI_DOUBLE, MPI_MIN, 0, MPI_COMM_WORLD);
-      MPI_Reduce(&cells::z_field_array[0], &cells::z_field_array[0], cells::num_cells, MPI_DOUBLE, MPI_MIN, 0, MPI_COMM_WORLD);
-   }
-   #endif
+   vout::reduce_cell_fields();
 
    // Output masterfile header on root process
    if(vmpi::my_rank==0){
 
       zlog << zTs() << "Outputting cell configuration " << sim::output_cells_file_counter << " to disk." << std::endl;
 
-      // Declare and open output file
-      std::ofstream cfg_file_ofstr;
-      cfg_file_ofstr.open (cfg_filec);
+      // Format header in memory
+      std::ostringstream cfg_file_ofstr;
 
       // Get system date
       time_t rawtime = time(NULL);
       struct tm * timeinfo = localtime(&rawtime);
 
-      cfg_file_ofstr << "#------------------------------------------------------"<< std::endl;
-      cfg_file_ofstr << "# Cell configuration file for vampire"<< std::endl;
-      cfg_file_ofstr << "#------------------------------------------------------"<< std::endl;
+      cfg_file_ofstr << "#------------------------------------------------------\n";
+      cfg_file_ofstr << "# Cell configuration file for vampire\n";
+      cfg_file_ofstr << "#------------------------------------------------------\n";
       cfg_file_ofstr << "# Date: "<< asctime(timeinfo);
-      cfg_file_ofstr << "#------------------------------------------------------"<< std::endl;
-      cfg_file_ofstr << "# Number of spins: "<< cells::num_cells << std::endl;
-      cfg_file_ofstr << "# System dimensions:" << cs::system_dimensions[0] << "\t" << cs::system_dimensions[1] << "\t" << cs::system_dimensions[2] << std::endl;
-      cfg_file_ofstr << "# Coordinates-file: cells-coord.cfg"<< std::endl;
-      cfg_file_ofstr << "# Time: " << double(sim::time)*mp::dt_SI << std::endl;
-      cfg_file_ofstr << "# Field: " << sim::H_applied << std::endl;
-      cfg_file_ofstr << "# Temperature: "<< sim::temperature << std::endl;
-      cfg_file_ofstr << "# Magnetisation: " << stats::system_magnetization.output_normalized_magnetization() << std::endl;
-      cfg_file_ofstr << "#------------------------------------------------------"<< std::endl;
-
-      // Root process now outputs the cell magnetisations
+      cfg_file_ofstr << "#------------------------------------------------------\n";
+      cfg_file_ofstr << "# Number of spins: "<< cells::num_cells << "\n";
+      cfg_file_ofstr << "# System dimensions:" << cs::system_dimensions[0] << "\t" << cs::system_dimensions[1] << "\t" << cs::system_dimensions[2] << "\n";
+      cfg_file_ofstr << "# Coordinates-file: cells-coord.cfg\n";
+      cfg_file_ofstr << "# Time: " << double(sim::time)*mp::dt_SI << "\n";
+      cfg_file_ofstr << "# Field: " << sim::H_applied << "\n";
+      cfg_file_ofstr << "# Temperature: "<< sim::temperature << "\n";
+      cfg_file_ofstr << "# Magnetisation: " << stats::system_magnetization.output_normalized_magnetization() << "\n";
+      cfg_file_ofstr << "#------------------------------------------------------\n";
+
+      // Root process now stages the cell magnetisations and fields for output
+      std::vector<double> cell_data(6*cells::num_cells);
       for(int cell=0; cell < cells::num_cells; cell++){
-         cfg_file_ofstr << cells::x_mag_array[cell] << "\t" << cells::y_mag_array[cell] << "\t" << cells::z_mag_array[cell]<< "\t";
-         cfg_file_ofstr << cells::x_field_array[cell] << "\t" << cells::y_field_array[cell] << "\t" << cells::z_field_array[cell] << std::endl;
+         cell_data[6*cell+0] = cells::x_mag_array[cell];
+         cell_data[6*cell+1] = cells::y_mag_array[cell];
+         cell_data[6*cell+2] = cells::z_mag_array[cell];
+         cell_data[6*cell+3] = cells::x_field_array[cell];
+         cell_data[6*cell+4] = cells::y_field_array[cell];
+         cell_data[6*cell+5] = cells::z_field_array[cell];
       }
 
-      cfg_file_ofstr.close();
+      vout::write_snapshot(cfg_file, cfg_file_ofstr.str(), cell_data, 6, 0);
 
    }
 
@@ -546,6 +703,26 @@ void cells(){
 
 }
 
+//------------------------------------------------------------------------------------------------------
+// Function to reduce cell demagnetisation fields to root process for output
+//------------------------------------------------------------------------------------------------------
+void reduce_cell_fields(){
+
+   #ifdef MPICF
+   if(vmpi::my_rank==0){
+      MPI_Reduce(MPI_IN_PLACE, &cells::x_field_array[0], cells::num_cells, MPI_DOUBLE, MPI_MIN, 0, MPI_COMM_WORLD);
+      MPI_Reduce(MPI_IN_PLACE, &cells::y_field_array[0], cells::num_cells, MPI_DOUBLE, MPI_MIN, 0, MPI_COMM_WORLD);
+      MPI_Reduce(MPI_IN_PLACE, &cells::z_field_array[0], cells::num_cells, MPI_DOUBLE, MPI_MIN, 0, MPI_COMM_WORLD);
+   }
+   else{
+      MPI_Reduce(&cells::x_field_array[0], &cells::x_field_array[0], cells::num_cells, MPI_DOUBLE, MPI_MIN, 0, MPI_COMM_WORLD);
+      MPI_Reduce(&cells::y_field_array[0], &cells::y_field_array[0], cells::num_cells, MPI_DOUBLE, MPI_MIN, 0, MPI_COMM_WORLD);
+      MPI_Reduce(&cells::z_field_array[0], &cells::z_field_array[0], cells::num_cells, MPI_DOUBLE, MPI_MIN, 0, MPI_COMM_WORLD);
+   }
+   #endif
+
+}
+
 /// @brief Cells output function
 ///
 /// @details Outputs formatted data snapshot for visualisation
@@ -607,22 +784,22 @@ void cells_coords(){
       time_t rawtime = time(NULL);
       struct tm * timeinfo = localtime(&rawtime);
 
-      cfg_file_ofstr << "#------------------------------------------------------"<< std::endl;
-      cfg_file_ofstr << "# Cell coordinates configuration file for vampire"<< std::endl;
-      cfg_file_ofstr << "#------------------------------------------------------"<< std::endl;
+      cfg_file_ofstr << "#------------------------------------------------------\n";
+      cfg_file_ofstr << "# Cell coordinates configuration file for vampire\n";
+      cfg_file_ofstr << "#------------------------------------------------------\n";
       cfg_file_ofstr << "# Date: "<< asctime(timeinfo);
-      cfg_file_ofstr << "#------------------------------------------------------"<< std::endl;
-      cfg_file_ofstr << "# Number of cells: "<< cells::num_cells << std::endl;
-      cfg_file_ofstr << "#------------------------------------------------------" << std::endl;
-      cfg_file_ofstr << "#" << std::endl;
-      cfg_file_ofstr << "#" << std::endl;
-      cfg_file_ofstr << "#" << std::endl;
-      cfg_file_ofstr << "#" << std::endl;
-      cfg_file_ofstr << "#" << std::endl;
-      cfg_file_ofstr << "#------------------------------------------------------"<< std::endl;
+      cfg_file_ofstr << "#------------------------------------------------------\n";
+      cfg_file_ofstr << "# Number of cells: "<< cells::num_cells << "\n";
+      cfg_file_ofstr << "#------------------------------------------------------\n";
+      cfg_file_ofstr << "#\n";
+      cfg_file_ofstr << "#\n";
+      cfg_file_ofstr << "#\n";
+      cfg_file_ofstr << "#\n";
+      cfg_file_ofstr << "#\n";
+      cfg_file_ofstr << "#------------------------------------------------------\n";
 
       for(int cell=0; cell<cells::num_cells; cell++){
-         cfg_file_ofstr << cells::x_coord_array[cell] << "\t" << cells::y_coord_array[cell] << "\t" << cells::z_coord_array[cell] << std::endl;
+         cfg_file_ofstr << cells::x_coord_array[cell] << "\t" << cells::y_coord_array[cell] << "\t" << cells::z_coord_array[cell] << "\n";
       }
 
       cfg_file_ofstr.close();
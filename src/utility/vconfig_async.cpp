@@ -0,0 +1,256 @@
+//-----------------------------------------------------------------------------
+//
+// This source file is part of the VAMPIRE open source package under the
+// GNU GPL (version 2) licence (see licence file for details).
+//
+// (c) R F L Evans 2016. All rights reserved.
+//
+//-----------------------------------------------------------------------------
+//
+// Snapshot file writer with optional background thread (config:asynchronous-output)
+//
+// Snapshot writers stage a copy of the data to be written at the output step
+// and pass it here together with a preformatted header. Synchronously the file
+// is written immediately. Asynchronously the snapshot is queued and formatted
+// and written by a single background thread while the simulation continues.
+// At most config:asynchronous-output-queue-depth snapshots (including the one
+// being written) are held in memory, and the simulation waits for the writer
+// when the queue is full, so memory use is bounded if the disk is slower than
+// the simulation. The writer thread makes no MPI calls. Write errors in the
+// background are reported on the next call from the main thread. Windows
+// builds always write synchronously.
+//
+//-----------------------------------------------------------------------------
+
+// C++ standard library headers
+#include <deque>
+#include <fstream>
+#include <iostream>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+#ifndef WIN_COMPILE
+   #include <pthread.h>
+#endif
+
+// Vampire headers
+#include "errors.hpp"
+#include "vio.hpp"
+
+namespace vout{
+
+   bool asynchronous_output=false;
+   int asynchronous_output_queue_depth=2;
+
+   namespace internal{
+
+      //------------------------------------------------------------------------------------------------------
+      // Staged snapshot file
+      //------------------------------------------------------------------------------------------------------
+      struct snapshot_file_t{
+         std::string filename;
+         std::string preamble;      // header text or bytes written before data
+         std::vector<double> data;  // values written in rows of columns
+         int columns;
+         int format;                // 0 = tab separated text, 1 = binary
+         int precision;             // bytes per value in binary files (4 or 8)
+      };
+
+      //------------------------------------------------------------------------------------------------------
+      // Function to write a staged snapshot to disk, returning false if file could not be written
+      //------------------------------------------------------------------------------------------------------
+      bool write_snapshot_file(const snapshot_file_t& snapshot){
+
+         std::ofstream ofile;
+         if(snapshot.format==1) ofile.open(snapshot.filename.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+         else ofile.open(snapshot.filename.c_str());
+         if(!ofile.is_open()) return false;
+
+         ofile.write(snapshot.preamble.data(), snapshot.preamble.size());
+
+         const std::vector<double>& data = snapshot.data;
+         if(snapshot.format==1){
+            if(snapshot.precision==4){
+               std::vector<float> sp(data.size());
+               for(unsigned int i=0; i<data.size(); i++) sp[i] = float(data[i]);
+               ofile.write(reinterpret_cast<const char*>(sp.data()), sp.size()*sizeof(float));
+            }
+            else ofile.write(reinterpret_cast<const char*>(data.data()), data.size()*sizeof(double));
+         }
+         else{
+            const unsigned int columns = snapshot.columns;
+            for(unsigned int i=0; i+columns<=data.size(); i+=columns){
+               ofile << data[i];
+               for(unsigned int c=1; c<columns; c++) ofile << "\t" << data[i+c];
+               ofile << "\n";
+            }
+         }
+
+         ofile.close();
+
+         return !ofile.fail();
+
+      }
+
+      //------------------------------------------------------------------------------------------------------
+      // Function to report a failed write and exit
+      //------------------------------------------------------------------------------------------------------
+      void write_error(const std::string& filename){
+         terminaltextcolor(RED);
+         std::cerr << "Error - unable to write configuration file " << filename << std::endl;
+         terminaltextcolor(WHITE);
+         zlog << zTs() << "Error - unable to write configuration file " << filename << std::endl;
+         err::vexit();
+      }
+
+      #ifndef WIN_COMPILE
+
+      //------------------------------------------------------------------------------------------------------
+      // Background writer state, shared between main and writer threads under mutex
+      //------------------------------------------------------------------------------------------------------
+      std::deque<snapshot_file_t*> snapshot_queue; // snapshots waiting or being written
+      pthread_t writer_thread;
+      pthread_mutex_t queue_mutex = PTHREAD_MUTEX_INITIALIZER;
+      pthread_cond_t queue_not_empty = PTHREAD_COND_INITIALIZER;
+      pthread_cond_t queue_not_full = PTHREAD_COND_INITIALIZER;
+      bool writer_running=false;
+      bool writer_shutdown=false;
+      std::string failed_filename;
+      uint64_t num_snapshots_written=0;
+      uint64_t num_writer_waits=0;
+
+      //------------------------------------------------------------------------------------------------------
+      // Writer thread main loop, writing queued snapshots in order until shutdown
+      //------------------------------------------------------------------------------------------------------
+      void* snapshot_writer(void*){
+
+         while(true){
+
+            pthread_mutex_lock(&queue_mutex);
+            while(snapshot_queue.empty() && !writer_shutdown) pthread_cond_wait(&queue_not_empty, &queue_mutex);
+            if(snapshot_queue.empty()){
+               pthread_mutex_unlock(&queue_mutex);
+               break;
+            }
+            snapshot_file_t* snapshot = snapshot_queue.front();
+            pthread_mutex_unlock(&queue_mutex);
+
+            // format and write outside of lock
+            const bool success = write_snapshot_file(*snapshot);
+
+            pthread_mutex_lock(&queue_mutex);
+            snapshot_queue.pop_front();
+            if(!success && failed_filename.empty()) failed_filename = snapshot->filename;
+            num_snapshots_written++;
+            pthread_cond_signal(&queue_not_full);
+            pthread_mutex_unlock(&queue_mutex);
+
+            delete snapshot;
+
+         }
+
+         return NULL;
+
+      }
+
+      //------------------------------------------------------------------------------------------------------
+      // Function to check for errors in background writer and report them from main thread
+      //------------------------------------------------------------------------------------------------------
+      void check_writer_errors(){
+         pthread_mutex_lock(&queue_mutex);
+         const std::string filename = failed_filename;
+         pthread_mutex_unlock(&queue_mutex);
+         if(!filename.empty()) write_error(filename);
+      }
+
+      #endif
+
+   } // end of internal namespace
+
+   //------------------------------------------------------------------------------------------------------
+   // Function to write a snapshot file, either immediately or in the background. The data vector is
+   // taken over by the writer and left empty.
+   //------------------------------------------------------------------------------------------------------
+   void write_snapshot(const std::string& filename, const std::string& preamble, std::vector<double>& data,
+                       const int columns, const int format){
+
+      internal::snapshot_file_t* snapshot = new internal::snapshot_file_t;
+      snapshot->filename = filename;
+      snapshot->preamble = preamble;
+      snapshot->data.swap(data);
+      snapshot->columns = columns;
+      snapshot->format = format;
+      snapshot->precision = vout::output_config_precision;
+
+      #ifndef WIN_COMPILE
+      if(vout::asynchronous_output){
+
+         internal::check_writer_errors();
+
+         // start writer thread on first use
+         if(!internal::writer_running){
+            if(pthread_create(&internal::writer_thread, NULL, internal::snapshot_writer, NULL)!=0){
+               terminaltextcolor(RED);
+               std::cerr << "Error - unable to start asynchronous output thread" << std::endl;
+               terminaltextcolor(WHITE);
+               zlog << zTs() << "Error - unable to start asynchronous output thread" << std::endl;
+               err::vexit();
+            }
+            internal::writer_running=true;
+         }
+
+         // wait for space in queue if writer is behind
+         pthread_mutex_lock(&internal::queue_mutex);
+         if(int(internal::snapshot_queue.size()) >= vout::asynchronous_output_queue_depth){
+            internal::num_writer_waits++;
+            while(int(internal::snapshot_queue.size()) >= vout::asynchronous_output_queue_depth){
+               pthread_cond_wait(&internal::queue_not_full, &internal::queue_mutex);
+            }
+         }
+         internal::snapshot_queue.push_back(snapshot);
+         pthread_cond_signal(&internal::queue_not_empty);
+         pthread_mutex_unlock(&internal::queue_mutex);
+
+         return;
+
+      }
+      #endif
+
+      const bool success = internal::write_snapshot_file(*snapshot);
+      const std::string failed = snapshot->filename;
+      delete snapshot;
+      if(!success) internal::write_error(failed);
+
+      return;
+
+   }
+
+   //------------------------------------------------------------------------------------------------------
+   // Function to write all queued snapshots and stop background writer
+   //------------------------------------------------------------------------------------------------------
+   void finalize_asynchronous_output(){
+
+      #ifndef WIN_COMPILE
+      if(!internal::writer_running) return;
+
+      pthread_mutex_lock(&internal::queue_mutex);
+      internal::writer_shutdown=true;
+      pthread_cond_signal(&internal::queue_not_empty);
+      pthread_mutex_unlock(&internal::queue_mutex);
+
+      pthread_join(internal::writer_thread, NULL);
+      internal::writer_running=false;
+      internal::writer_shutdown=false;
+
+      zlog << zTs() << "Asynchronous output wrote " << internal::num_snapshots_written << " snapshot files, simulation waited for writer "
+           << internal::num_writer_waits << " times" << std::endl;
+
+      internal::check_writer_errors();
+      #endif
+
+      return;
+
+   }
+
+} // end of namespace vout
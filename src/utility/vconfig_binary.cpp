@@ -0,0 +1,353 @@
+//-----------------------------------------------------------------------------
+//
+// This source file is part of the VAMPIRE open source package under the
+// GNU GPL (version 2) licence (see licence file for details).
+//
+// (c) R F L Evans 2016. All rights reserved.
+//
+//-----------------------------------------------------------------------------
+//
+// Single file binary configuration output (config:atoms-output-format = binary
+// and config:cells-output-format = binary)
+//
+// All processors write their spins collectively into one file per snapshot at
+// offsets computed from a prefix sum of the local atom counts, so the number of
+// files is independent of the number of processors. The header is written once
+// by the root process and the data blocks are preceded by the global atom ids
+// (unit cell based) of every entry so that readers can reassemble the system in
+// its original order. Coordinates, spins and cell data are stored as float or
+// double (config:binary-output-precision) as given by the bytes per value
+// field, header values are always double. All values are stored in native byte
+// order. Files can be converted to the text format with util/bin2cfg.
+//
+//    atoms-coords.bin                   atoms-00000042.bin
+//    ----------------                   ------------------
+//    char[8]  "VAMPCRD"                 char[8]  "VAMPSPN"
+//    int32    version                   int32    version
+//    int32    bytes per value (4|8)     int32    bytes per value (4|8)
+//    uint64   number of atoms N         uint64   number of spins N
+//    double   system dimensions[3]      uint64   snapshot number
+//    int32    number of materials       double   time, field, temperature
+//    uint64   global atom id[N]         double   magnetisation mx, my, mz, |m|
+//    int32    material[N]               int32    number of materials
+//    int32    height category[N]        double   mu_s[number of materials]
+//    real     x,y,z [3N]                uint64   global atom id[N]
+//                                       real     sx,sy,sz [3N]
+//
+//    cells-coords.bin                   cells-00000042.bin
+//    ----------------                   ------------------
+//    char[8]  "VAMPCCD"                 char[8]  "VAMPCEL"
+//    int32    version                   int32    version
+//    int32    bytes per value (4|8)     int32    bytes per value (4|8)
+//    uint64   number of cells N         uint64   number of cells N
+//    double   system dimensions[3]      uint64   snapshot number
+//    double   cell size                 double   time, field, temperature
+//    real     x,y,z [3N]                double   magnetisation mx, my, mz, |m|
+//                                       real     mx,my,mz [3N]
+//                                       real     Hx,Hy,Hz [3N]
+//
+//-----------------------------------------------------------------------------
+
+// C++ standard library headers
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// Vampire headers
+#include "atoms.hpp"
+#include "cells.hpp"
+#include "create.hpp"
+#include "errors.hpp"
+#include "material.hpp"
+#include "sim.hpp"
+#include "stats.hpp"
+#include "vio.hpp"
+#include "vmpi.hpp"
+
+// vout module headers
+#include "internal.hpp"
+
+namespace vout{
+
+   namespace internal{
+
+      //------------------------------------------------------------------------------------------------------
+      // Function to append an 8 character file identifier to a binary header buffer
+      //------------------------------------------------------------------------------------------------------
+      void append_identifier(std::vector<char>& header, const char* id){
+         char bytes[8];
+         std::memset(bytes, 0, 8);
+         std::strncpy(bytes, id, 7);
+         header.insert(header.end(), bytes, bytes+8);
+      }
+
+      //------------------------------------------------------------------------------------------------------
+      // Function to convert a block of values to the output precision
+      //------------------------------------------------------------------------------------------------------
+      std::vector<float> single_precision(const std::vector<double>& data){
+         std::vector<float> sp(data.size());
+         for(unsigned int i=0; i<data.size(); i++) sp[i] = float(data[i]);
+         return sp;
+      }
+
+      //------------------------------------------------------------------------------------------------------
+      // Function to write a block of values at the output precision to a root process file
+      //------------------------------------------------------------------------------------------------------
+      void write_real_block(std::ofstream& ofs, const std::vector<double>& data){
+         if(vout::output_config_precision==4){
+            const std::vector<float> sp = single_precision(data);
+            ofs.write(reinterpret_cast<const char*>(sp.data()), sp.size()*sizeof(float));
+         }
+         else ofs.write(reinterpret_cast<const char*>(data.data()), data.size()*sizeof(double));
+      }
+
+      //------------------------------------------------------------------------------------------------------
+      // Function to determine offset of local atoms in global output list and total number of output atoms
+      //------------------------------------------------------------------------------------------------------
+      void output_atom_offset(uint64_t& offset, uint64_t& total){
+
+         uint64_t local = vout::local_output_atom_list.size();
+         offset = 0;
+         total = local;
+
+         #ifdef MPICF
+            MPI_Exscan(&local, &offset, 1, MPI_UINT64_T, MPI_SUM, MPI_COMM_WORLD);
+            if(vmpi::my_rank==0) offset = 0; // result of exscan is undefined on root
+            MPI_Allreduce(&local, &total, 1, MPI_UINT64_T, MPI_SUM, MPI_COMM_WORLD);
+         #endif
+
+         return;
+
+      }
+
+   } // end of internal namespace
+
+   //------------------------------------------------------------------------------------------------------
+   // Function to output atomic coordinates, materials and categories into a single binary file
+   //------------------------------------------------------------------------------------------------------
+   void atoms_coords_binary(){
+
+      // check calling of routine if error checking is activated
+      if(err::check==true){std::cout << "vout::atoms_coords_binary has been called" << std::endl;}
+
+      // determine atoms to output on local processor
+      vout::set_local_output_atom_list();
+
+      uint64_t offset, total;
+      internal::output_atom_offset(offset, total);
+      vout::total_output_atoms = total;
+
+      const std::string filename = "atoms-coords.bin";
+      zlog << zTs() << "Outputting binary coordinate file " << filename << " to disk" << std::endl;
+
+      // pack header
+      std::vector<char> header;
+      internal::append_identifier(header, "VAMPCRD");
+      internal::append_to_header<int32_t>(header, internal::binary_config_version);
+      internal::append_to_header<int32_t>(header, vout::output_config_precision);
+      internal::append_to_header<uint64_t>(header, total);
+      for(int i=0; i<3; i++) internal::append_to_header<double>(header, cs::system_dimensions[i]);
+      internal::append_to_header<int32_t>(header, mp::num_materials);
+
+      // pack local data
+      const unsigned int num_local = vout::local_output_atom_list.size();
+      std::vector<uint64_t> ids(num_local);
+      std::vector<int> types(num_local);
+      std::vector<int> categories(num_local);
+      std::vector<double> coords(3*num_local);
+      for(unsigned int i=0; i<num_local; i++){
+         const int atom = vout::local_output_atom_list[i];
+         ids[i] = atoms::global_id_array[atom];
+         types[i] = atoms::type_array[atom];
+         categories[i] = atoms::category_array[atom];
+         coords[3*i+0] = atoms::x_coord_array[atom];
+         coords[3*i+1] = atoms::y_coord_array[atom];
+         coords[3*i+2] = atoms::z_coord_array[atom];
+      }
+
+      // write header and data blocks at global offsets
+      const uint64_t hs = header.size();
+      internal::shared_binary_file_t file;
+      file.open(filename);
+      file.write_header(header);
+      file.write_at(hs + offset*sizeof(uint64_t), ids);
+      file.write_at(hs + total*sizeof(uint64_t) + offset*sizeof(int), types);
+      file.write_at(hs + total*(sizeof(uint64_t)+sizeof(int)) + offset*sizeof(int), categories);
+      file.write_real_at(hs + total*(sizeof(uint64_t)+2*sizeof(int)) + 3*offset*vout::output_config_precision, coords);
+      file.close();
+
+      return;
+
+   }
+
+   //------------------------------------------------------------------------------------------------------
+   // Function to output a spin configuration snapshot from all processors into a single binary file
+   //------------------------------------------------------------------------------------------------------
+   void atoms_binary(){
+
+      // check calling of routine if error checking is activated
+      if(err::check==true){std::cout << "vout::atoms_binary has been called" << std::endl;}
+
+      uint64_t offset, total;
+      internal::output_atom_offset(offset, total);
+
+      // Set output filename
+      std::stringstream file_sstr;
+      file_sstr << "atoms-" << std::setfill('0') << std::setw(8) << sim::output_atoms_file_counter << ".bin";
+      const std::string filename = file_sstr.str();
+
+      zlog << zTs() << "Outputting binary configuration file " << filename << " to disk" << std::endl;
+
+      // get normalised system magnetisation if calculated
+      double m[4] = {0.0, 0.0, 0.0, 0.0};
+      if(stats::calculate_system_magnetization){
+         const std::vector<double>& mag = stats::system_magnetization.get_magnetization();
+         for(int i=0; i<4; i++) m[i] = mag[i];
+      }
+
+      // pack header
+      std::vector<char> header;
+      internal::append_identifier(header, "VAMPSPN");
+      internal::append_to_header<int32_t>(header, internal::binary_config_version);
+      internal::append_to_header<int32_t>(header, vout::output_config_precision);
+      internal::append_to_header<uint64_t>(header, total);
+      internal::append_to_header<uint64_t>(header, sim::output_atoms_file_counter);
+      internal::append_to_header<double>(header, double(sim::time)*mp::dt_SI);
+      internal::append_to_header<double>(header, sim::H_applied);
+      internal::append_to_header<double>(header, sim::temperature);
+      for(int i=0; i<4; i++) internal::append_to_header<double>(header, m[i]);
+      internal::append_to_header<int32_t>(header, mp::num_materials);
+      for(int mat=0; mat<mp::num_materials; mat++) internal::append_to_header<double>(header, mp::material[mat].mu_s_SI);
+
+      // pack local data
+      const unsigned int num_local = vout::local_output_atom_list.size();
+      std::vector<uint64_t> ids(num_local);
+      std::vector<double> spins(3*num_local);
+      for(unsigned int i=0; i<num_local; i++){
+         const int atom = vout::local_output_atom_list[i];
+         ids[i] = atoms::global_id_array[atom];
+         spins[3*i+0] = atoms::x_spin_array[atom];
+         spins[3*i+1] = atoms::y_spin_array[atom];
+         spins[3*i+2] = atoms::z_spin_array[atom];
+      }
+
+      // write header and data blocks at global offsets
+      const uint64_t hs = header.size();
+      internal::shared_binary_file_t file;
+      file.open(filename);
+      file.write_header(header);
+      file.write_at(hs + offset*sizeof(uint64_t), ids);
+      file.write_real_at(hs + total*sizeof(uint64_t) + 3*offset*vout::output_config_precision, spins);
+      file.close();
+
+      sim::output_atoms_file_counter++;
+
+      return;
+
+   }
+
+   //------------------------------------------------------------------------------------------------------
+   // Function to output cell coordinates into a binary file on the root process
+   //------------------------------------------------------------------------------------------------------
+   void cells_coords_binary(){
+
+      // check calling of routine if error checking is activated
+      if(err::check==true){std::cout << "vout::cells_coords_binary has been called" << std::endl;}
+
+      if(vmpi::my_rank!=0) return;
+
+      const std::string filename = "cells-coords.bin";
+      zlog << zTs() << "Outputting binary cell coordinate file " << filename << " to disk" << std::endl;
+
+      // pack header
+      std::vector<char> header;
+      internal::append_identifier(header, "VAMPCCD");
+      internal::append_to_header<int32_t>(header, internal::binary_config_version);
+      internal::append_to_header<int32_t>(header, vout::output_config_precision);
+      internal::append_to_header<uint64_t>(header, cells::num_cells);
+      for(int i=0; i<3; i++) internal::append_to_header<double>(header, cs::system_dimensions[i]);
+      internal::append_to_header<double>(header, cells::size);
+
+      // pack cell coordinates
+      std::vector<double> coords(3*cells::num_cells);
+      for(int cell=0; cell<cells::num_cells; cell++){
+         coords[3*cell+0] = cells::x_coord_array[cell];
+         coords[3*cell+1] = cells::y_coord_array[cell];
+         coords[3*cell+2] = cells::z_coord_array[cell];
+      }
+
+      std::ofstream ofs(filename.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+      ofs.write(&header[0], header.size());
+      internal::write_real_block(ofs, coords);
+      ofs.close();
+
+      return;
+
+   }
+
+   //------------------------------------------------------------------------------------------------------
+   // Function to output a cell magnetisation and demagnetisation field snapshot into a binary file
+   //------------------------------------------------------------------------------------------------------
+   void cells_binary(){
+
+      // check calling of routine if error checking is activated
+      if(err::check==true){std::cout << "vout::cells_binary has been called" << std::endl;}
+
+      // Reduce demagnetisation fields to processor 0
+      vout::reduce_cell_fields();
+
+      if(vmpi::my_rank==0){
+
+         // Set output filename
+         std::stringstream file_sstr;
+         file_sstr << "cells-" << std::setfill('0') << std::setw(8) << sim::output_cells_file_counter << ".bin";
+         const std::string filename = file_sstr.str();
+
+         zlog << zTs() << "Outputting binary cell configuration " << sim::output_cells_file_counter << " to disk." << std::endl;
+
+         // get normalised system magnetisation if calculated
+         double m[4] = {0.0, 0.0, 0.0, 0.0};
+         if(stats::calculate_system_magnetization){
+            const std::vector<double>& mag = stats::system_magnetization.get_magnetization();
+            for(int i=0; i<4; i++) m[i] = mag[i];
+         }
+
+         // pack header
+         std::vector<char> header;
+         internal::append_identifier(header, "VAMPCEL");
+         internal::append_to_header<int32_t>(header, internal::binary_config_version);
+         internal::append_to_header<int32_t>(header, vout::output_config_precision);
+         internal::append_to_header<uint64_t>(header, cells::num_cells);
+         internal::append_to_header<uint64_t>(header, sim::output_cells_file_counter);
+         internal::append_to_header<double>(header, double(sim::time)*mp::dt_SI);
+         internal::append_to_header<double>(header, sim::H_applied);
+         internal::append_to_header<double>(header, sim::temperature);
+         for(int i=0; i<4; i++) internal::append_to_header<double>(header, m[i]);
+
+         // pack cell magnetisations followed by fields
+         const int n = cells::num_cells;
+         std::vector<double> cell_data(6*n);
+         for(int cell=0; cell<n; cell++){
+            cell_data[3*cell+0] = cells::x_mag_array[cell];
+            cell_data[3*cell+1] = cells::y_mag_array[cell];
+            cell_data[3*cell+2] = cells::z_mag_array[cell];
+            cell_data[3*(n+cell)+0] = cells::x_field_array[cell];
+            cell_data[3*(n+cell)+1] = cells::y_field_array[cell];
+            cell_data[3*(n+cell)+2] = cells::z_field_array[cell];
+         }
+
+         vout::write_snapshot(filename, std::string(header.begin(), header.end()), cell_data, 3, 1);
+
+      }
+
+      sim::output_cells_file_counter++;
+
+      return;
+
+   }
+
+} // end of namespace vout
@@ -0,0 +1,653 @@
+//-----------------------------------------------------------------------------
+//
+// This source file is part of the VAMPIRE open source package under the
+// GNU GPL (version 2) licence (see licence file for details).
+//
+// (c) R F L Evans 2016. All rights reserved.
+//
+//-----------------------------------------------------------------------------
+//
+// Single file spin trajectory container (config:atoms-output-format = trajectory)
+//
+// All spin configurations of a run are written to one file together with the
+// atomic coordinates, materials and height categories, which are written once
+// after the header as static datasets instead of a separate coordinate file.
+// Each frame holds one chunk per processor, written collectively in processor
+// order, in the same order as the static datasets.
+//
+// By default (config:trajectory-encoding = quantised) spin directions are
+// stored in octahedral encoding, two unsigned integers of
+// config:trajectory-precision-bits bits per spin. Key frames store the
+// quantised values directly. Other frames store the difference to the previous
+// frame, which is small for dynamics, zigzag mapped and Rice coded in chunks of
+// 1024 values with the parameter of each chunk chosen from its mean. Key frames
+// are written every config:trajectory-keyframe-interval frames to bound the
+// decoding cost of random access. With config:trajectory-encoding = raw spins
+// are stored as float or double (config:binary-output-precision). Spin lengths
+// are not stored.
+//
+// An index of all frames is appended after the last frame at the end of the
+// simulation and its offset stored in the header. If the run stops before
+// then, the index offset is zero and readers rebuild the index by reading the
+// frame headers in sequence. After loading a checkpoint with sim:continue,
+// frames written after the checkpoint are discarded and new frames appended,
+// provided the number and order of atoms are unchanged. Frames are decoded
+// with util/trj2cfg.
+//
+//    atoms-trajectory.trj                 frame
+//    --------------------                 -----
+//    char[8]  "VAMPTRJ"                   uint64   snapshot number
+//    int32    version                     double   time, field, temperature
+//    uint64   number of spins N           double   magnetisation mx, my, mz, |m|
+//    uint64   index offset (0 if absent)  int32    bits per value
+//    uint64   number of indexed frames    int32    encoding (0 = key, 1 = delta,
+//    int32    number of materials                           2 = raw)
+//    double   mu_s[number of materials]   int32    number of chunks B
+//    double   system dimensions[3]        uint64   spins, bytes [B]
+//    uint64   global atom id[N]           uchar    encoded chunk data [B]
+//    int32    material[N]
+//    int32    height category[N]          index entry
+//    double   x,y,z [3N]                  -----------
+//    frame[number of frames]              uint64   frame offset
+//    index entry[number of frames]        uint64   snapshot number
+//                                         int32    encoding, bits per value
+//
+//-----------------------------------------------------------------------------
+
+// C++ standard library headers
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#if !defined(MPICF) && !defined(WIN_COMPILE)
+   #include <unistd.h>
+#endif
+
+// Vampire headers
+#include "atoms.hpp"
+#include "create.hpp"
+#include "errors.hpp"
+#include "material.hpp"
+#include "sim.hpp"
+#include "stats.hpp"
+#include "vio.hpp"
+#include "vmpi.hpp"
+
+// vout module headers
+#include "internal.hpp"
+
+namespace vout{
+
+   int output_trajectory_bits=16;
+   int output_trajectory_keyframe_interval=10;
+   bool output_trajectory_quantised=true;
+
+   namespace internal{
+
+      const int trajectory_version = 2;
+      const int rice_chunk_size = 1024; // number of values sharing a Rice parameter
+      const int rice_escape = 24; // unary length after which values are stored directly
+      const uint64_t trajectory_index_field = 20; // position of index offset in file header
+      const uint64_t trajectory_frame_header_size = 76; // size of frame header without chunk sizes
+
+      //------------------------------------------------------------------------------------------------------
+      // Entry of trajectory index
+      //------------------------------------------------------------------------------------------------------
+      struct trajectory_index_entry_t{
+         uint64_t offset;
+         uint64_t snapshot;
+         int32_t encoding;
+         int32_t bits;
+      };
+
+      bool trajectory_initialized=false; // trajectory file created or opened for appending
+      std::vector<uint16_t> trajectory_previous; // quantised spins of previous frame on local processor
+      uint64_t trajectory_file_size=0; // end of last frame in trajectory file
+      uint64_t trajectory_num_frames=0; // number of frames in trajectory file
+      std::vector<trajectory_index_entry_t> trajectory_index; // index of frames on root process
+
+      //------------------------------------------------------------------------------------------------------
+      // Class to pack values with a given number of bits into a byte stream, least significant bit first
+      //------------------------------------------------------------------------------------------------------
+      class bit_writer_t{
+
+         public:
+
+            bit_writer_t(std::vector<unsigned char>& in_bytes): bytes(in_bytes), buffer(0), count(0){}
+
+            void write(const uint32_t value, const int num_bits){
+               buffer |= uint64_t(value) << count;
+               count += num_bits;
+               while(count>=8){
+                  bytes.push_back(buffer & 0xff);
+                  buffer >>= 8;
+                  count -= 8;
+               }
+            }
+
+            void flush(){
+               if(count>0) bytes.push_back(buffer & 0xff);
+               buffer = 0;
+               count = 0;
+            }
+
+         private:
+
+            std::vector<unsigned char>& bytes;
+            uint64_t buffer;
+            int count;
+
+      };
+
+      //------------------------------------------------------------------------------------------------------
+      // Function to quantise a spin direction in octahedral encoding
+      //------------------------------------------------------------------------------------------------------
+      void octahedral_quantise(const double sx, const double sy, const double sz, const int bits, uint16_t& qu, uint16_t& qv){
+
+         const double norm = fabs(sx)+fabs(sy)+fabs(sz);
+         double u = 0.0;
+         double v = 0.0;
+         if(norm>0.0){
+            u = sx/norm;
+            v = sy/norm;
+            // fold lower hemisphere over the diagonals
+            if(sz<0.0){
+               const double fu = (1.0-fabs(v))*(u>=0.0 ? 1.0 : -1.0);
+               const double fv = (1.0-fabs(u))*(v>=0.0 ? 1.0 : -1.0);
+               u = fu;
+               v = fv;
+            }
+         }
+
+         const double scale = 0.5*double((1<<bits)-1);
+         qu = uint16_t(floor((u+1.0)*scale+0.5));
+         qv = uint16_t(floor((v+1.0)*scale+0.5));
+
+      }
+
+      //------------------------------------------------------------------------------------------------------
+      // Function to encode quantised values directly
+      //------------------------------------------------------------------------------------------------------
+      void encode_key_frame(const std::vector<uint16_t>& q, const int bits, std::vector<unsigned char>& bytes){
+
+         bit_writer_t writer(bytes);
+         for(unsigned int i=0; i<q.size(); i++) writer.write(q[i], bits);
+         writer.flush();
+
+      }
+
+      //------------------------------------------------------------------------------------------------------
+      // Function to encode differences of quantised values to previous frame with Rice coding
+      //------------------------------------------------------------------------------------------------------
+      void encode_delta_frame(const std::vector<uint16_t>& q, const std::vector<uint16_t>& previous, const int bits,
+                              std::vector<unsigned char>& bytes){
+
+         bit_writer_t writer(bytes);
+         std::vector<uint32_t> residual(rice_chunk_size);
+
+         for(unsigned int start=0; start<q.size(); start+=rice_chunk_size){
+
+            const unsigned int end = std::min<unsigned int>(start+rice_chunk_size, q.size());
+
+            // zigzag map differences to unsigned integers
+            uint64_t sum = 0;
+            for(unsigned int i=start; i<end; i++){
+               const int d = int(q[i])-int(previous[i]);
+               residual[i-start] = d>=0 ? 2*d : -2*d-1;
+               sum += residual[i-start];
+            }
+
+            // choose Rice parameter from mean residual
+            const uint64_t mean = sum/(end-start);
+            int k = 0;
+            while(k<bits && (uint64_t(2)<<k)<=mean) k++;
+            writer.write(k, 5);
+
+            for(unsigned int i=start; i<end; i++){
+               const uint32_t r = residual[i-start];
+               const uint32_t quotient = r >> k;
+               if(quotient<uint32_t(rice_escape)){
+                  writer.write((1u<<quotient)-1, quotient+1); // unary quotient terminated by zero
+                  writer.write(r & ((1u<<k)-1), k);
+               }
+               else{
+                  writer.write((1u<<rice_escape)-1, rice_escape);
+                  writer.write(r, bits+1);
+               }
+            }
+
+         }
+
+         writer.flush();
+
+      }
+
+
+      //------------------------------------------------------------------------------------------------------
+      // Function to read a value from a binary file
+      //------------------------------------------------------------------------------------------------------
+      template <typename T> T read_value(std::ifstream& ifile){
+         T value = 0;
+         ifile.read(reinterpret_cast<char*>(&value), sizeof(T));
+         return value;
+      }
+
+      //------------------------------------------------------------------------------------------------------
+      // Function to return size of trajectory file header
+      //------------------------------------------------------------------------------------------------------
+      uint64_t trajectory_header_size(){
+         return 8 + 4 + 3*sizeof(uint64_t) + 4 + mp::num_materials*sizeof(double) + 3*sizeof(double);
+      }
+
+      //------------------------------------------------------------------------------------------------------
+      // Function to report an error with the trajectory file and exit
+      //------------------------------------------------------------------------------------------------------
+      void trajectory_error(const std::string& message){
+         terminaltextcolor(RED);
+         std::cerr << "Error - " << message << std::endl;
+         terminaltextcolor(WHITE);
+         zlog << zTs() << "Error - " << message << std::endl;
+         err::vexit();
+      }
+
+      //------------------------------------------------------------------------------------------------------
+      // Function to read the index of an existing trajectory file on the root process, rebuilding it from
+      // the frame headers if the file has no index. Returns 0 if the file does not exist, 1 if frames can be
+      // appended and 2 if the file does not match the current system.
+      //------------------------------------------------------------------------------------------------------
+      int read_trajectory_index(const std::string& filename, const uint64_t total, uint64_t& frames_end){
+
+         std::ifstream ifile(filename.c_str(), std::ios::in | std::ios::binary);
+         if(!ifile.is_open()) return 0;
+
+         ifile.seekg(0, std::ios::end);
+         const uint64_t length = ifile.tellg();
+         ifile.seekg(0);
+
+         char id[8];
+         ifile.read(id, 8);
+         const int32_t version = read_value<int32_t>(ifile);
+         const uint64_t num_spins = read_value<uint64_t>(ifile);
+         const uint64_t index_offset = read_value<uint64_t>(ifile);
+         const uint64_t num_indexed = read_value<uint64_t>(ifile);
+         const int32_t num_materials = read_value<int32_t>(ifile);
+
+         const uint64_t frames_start = trajectory_header_size() + total*(sizeof(uint64_t)+2*sizeof(int32_t)+3*sizeof(double));
+         if(!ifile || std::strncmp(id, "VAMPTRJ", 8)!=0 || version!=trajectory_version || num_spins!=total ||
+            num_materials!=mp::num_materials || length<frames_start) return 2;
+
+         trajectory_index.clear();
+         frames_end = frames_start;
+
+         // read stored index
+         if(index_offset>=frames_start && index_offset+num_indexed*24<=length){
+            ifile.seekg(index_offset);
+            for(uint64_t f=0; f<num_indexed; f++){
+               trajectory_index_entry_t entry;
+               entry.offset = read_value<uint64_t>(ifile);
+               entry.snapshot = read_value<uint64_t>(ifile);
+               entry.encoding = read_value<int32_t>(ifile);
+               entry.bits = read_value<int32_t>(ifile);
+               trajectory_index.push_back(entry);
+            }
+            frames_end = index_offset;
+         }
+         // otherwise read frame headers until end of last complete frame
+         else{
+            while(frames_end+trajectory_frame_header_size<=length){
+               trajectory_index_entry_t entry;
+               entry.offset = frames_end;
+               ifile.seekg(frames_end);
+               entry.snapshot = read_value<uint64_t>(ifile);
+               ifile.seekg(7*sizeof(double), std::ios::cur);
+               entry.bits = read_value<int32_t>(ifile);
+               entry.encoding = read_value<int32_t>(ifile);
+               const int32_t num_chunks = read_value<int32_t>(ifile);
+               if(!ifile || num_chunks<1 || entry.encoding<0 || entry.encoding>2) break;
+               if(trajectory_index.size()>0 && entry.snapshot<=trajectory_index.back().snapshot) break;
+               uint64_t size = trajectory_frame_header_size + 2*num_chunks*sizeof(uint64_t);
+               uint64_t spins = 0;
+               for(int c=0; c<num_chunks; c++){
+                  spins += read_value<uint64_t>(ifile);
+                  size += read_value<uint64_t>(ifile);
+               }
+               if(!ifile || spins!=total || frames_end+size>length) break;
+               trajectory_index.push_back(entry);
+               frames_end += size;
+            }
+         }
+
+         // discard frames written after the checkpoint
+         for(uint64_t f=0; f<trajectory_index.size(); f++){
+            if(trajectory_index[f].snapshot>=sim::output_atoms_file_counter){
+               frames_end = trajectory_index[f].offset;
+               trajectory_index.resize(f);
+               break;
+            }
+         }
+
+         return 1;
+
+      }
+
+      //------------------------------------------------------------------------------------------------------
+      // Function to check that the local atoms are stored in the same order in an existing trajectory file
+      //------------------------------------------------------------------------------------------------------
+      bool trajectory_atom_order_matches(const std::string& filename, const uint64_t position, const std::vector<uint64_t>& ids){
+
+         std::vector<uint64_t> file_ids(ids.size());
+         int matches = 1;
+
+         #ifdef MPICF
+            MPI_File fh;
+            if(MPI_File_open(MPI_COMM_WORLD, const_cast<char*>(filename.c_str()), MPI_MODE_RDONLY, MPI_INFO_NULL, &fh)==MPI_SUCCESS){
+               MPI_File_read_at_all(fh, position, file_ids.data(), file_ids.size(), MPI_UINT64_T, MPI_STATUS_IGNORE);
+               MPI_File_close(&fh);
+            }
+            else matches = 0;
+         #else
+            std::ifstream ifile(filename.c_str(), std::ios::in | std::ios::binary);
+            ifile.seekg(position);
+            if(ids.size()>0) ifile.read(reinterpret_cast<char*>(&file_ids[0]), ids.size()*sizeof(uint64_t));
+            if(!ifile) matches = 0;
+         #endif
+
+         if(file_ids!=ids) matches = 0;
+
+         #ifdef MPICF
+            MPI_Allreduce(MPI_IN_PLACE, &matches, 1, MPI_INT, MPI_MIN, MPI_COMM_WORLD);
+         #endif
+
+         return matches==1;
+
+      }
+
+      //------------------------------------------------------------------------------------------------------
+      // Function to create trajectory file with header and static datasets, or to open an existing file for
+      // appending when continuing from a checkpoint
+      //------------------------------------------------------------------------------------------------------
+      void initialize_trajectory(const std::string& filename){
+
+         // determine atoms to output on local processor
+         vout::set_local_output_atom_list();
+
+         uint64_t offset, total;
+         internal::output_atom_offset(offset, total);
+         vout::total_output_atoms = total;
+
+         // pack local static data
+         const unsigned int num_local = vout::local_output_atom_list.size();
+         std::vector<uint64_t> ids(num_local);
+         std::vector<int> types(num_local);
+         std::vector<int> categories(num_local);
+         std::vector<double> coords(3*num_local);
+         for(unsigned int i=0; i<num_local; i++){
+            const int atom = vout::local_output_atom_list[i];
+            ids[i] = atoms::global_id_array[atom];
+            types[i] = atoms::type_array[atom];
+            categories[i] = atoms::category_array[atom];
+            coords[3*i+0] = atoms::x_coord_array[atom];
+            coords[3*i+1] = atoms::y_coord_array[atom];
+            coords[3*i+2] = atoms::z_coord_array[atom];
+         }
+
+         const uint64_t hs = trajectory_header_size();
+         trajectory_initialized = true;
+
+         // continue existing trajectory after loading checkpoint
+         if(sim::load_checkpoint_flag && sim::load_checkpoint_continue_flag){
+
+            int status = 0;
+            uint64_t frames[2] = {0, 0}; // end of frames, number of frames
+            if(vmpi::my_rank==0){
+               status = read_trajectory_index(filename, total, frames[0]);
+               frames[1] = trajectory_index.size();
+            }
+            #ifdef MPICF
+               MPI_Bcast(&status, 1, MPI_INT, 0, MPI_COMM_WORLD);
+               MPI_Bcast(frames, 2, MPI_UINT64_T, 0, MPI_COMM_WORLD);
+            #endif
+
+            if(status==1 && !trajectory_atom_order_matches(filename, hs + offset*sizeof(uint64_t), ids)) status = 2;
+            if(status==2) trajectory_error("existing trajectory file " + filename + " does not match the atoms or decomposition of the"
+                                           " simulation and cannot be continued, remove or rename it to start a new trajectory");
+
+            if(status==1){
+
+               trajectory_file_size = frames[0];
+               trajectory_num_frames = frames[1];
+
+               // discard frames after checkpoint and index, which are overwritten by new frames
+               #ifdef MPICF
+                  MPI_File fh;
+                  MPI_File_open(MPI_COMM_WORLD, const_cast<char*>(filename.c_str()), MPI_MODE_WRONLY, MPI_INFO_NULL, &fh);
+                  MPI_File_set_size(fh, trajectory_file_size);
+                  MPI_File_close(&fh);
+               #elif !defined(WIN_COMPILE)
+                  if(truncate(filename.c_str(), trajectory_file_size)!=0) trajectory_error("unable to truncate trajectory file " + filename);
+               #endif
+
+               std::vector<char> header;
+               internal::append_to_header<uint64_t>(header, 0);
+               internal::append_to_header<uint64_t>(header, 0);
+               internal::shared_binary_file_t file;
+               file.open(filename, true);
+               file.write_header(header, trajectory_index_field);
+               file.close();
+
+               zlog << zTs() << "Appending to trajectory file " << filename << " after " << trajectory_num_frames << " frames" << std::endl;
+
+               return;
+
+            }
+
+         }
+
+         zlog << zTs() << "Outputting trajectory file " << filename << " with static datasets to disk" << std::endl;
+
+         // pack header
+         std::vector<char> header;
+         internal::append_identifier(header, "VAMPTRJ");
+         internal::append_to_header<int32_t>(header, trajectory_version);
+         internal::append_to_header<uint64_t>(header, total);
+         internal::append_to_header<uint64_t>(header, 0); // index offset
+         internal::append_to_header<uint64_t>(header, 0); // number of indexed frames
+         internal::append_to_header<int32_t>(header, mp::num_materials);
+         for(int mat=0; mat<mp::num_materials; mat++) internal::append_to_header<double>(header, mp::material[mat].mu_s_SI);
+         for(int i=0; i<3; i++) internal::append_to_header<double>(header, cs::system_dimensions[i]);
+
+         // write header and static datasets at global offsets
+         internal::shared_binary_file_t file;
+         file.open(filename);
+         file.write_header(header);
+         file.write_at(hs + offset*sizeof(uint64_t), ids);
+         file.write_at(hs + total*sizeof(uint64_t) + offset*sizeof(int), types);
+         file.write_at(hs + total*(sizeof(uint64_t)+sizeof(int)) + offset*sizeof(int), categories);
+         file.write_at(hs + total*(sizeof(uint64_t)+2*sizeof(int)) + 3*offset*sizeof(double), coords);
+         file.close();
+
+         trajectory_file_size = hs + total*(sizeof(uint64_t)+2*sizeof(int)+3*sizeof(double));
+         trajectory_num_frames = 0;
+         trajectory_index.clear();
+
+         return;
+
+      }
+
+   } // end of internal namespace
+
+   //------------------------------------------------------------------------------------------------------
+   // Function to append a spin configuration frame to the trajectory file
+   //------------------------------------------------------------------------------------------------------
+   void atoms_trajectory(){
+
+      // check calling of routine if error checking is activated
+      if(err::check==true){std::cout << "vout::atoms_trajectory has been called" << std::endl;}
+
+      const std::string filename = "atoms-trajectory.trj";
+
+      if(!internal::trajectory_initialized) internal::initialize_trajectory(filename);
+
+      uint64_t offset, total;
+      internal::output_atom_offset(offset, total);
+
+      const unsigned int num_local = vout::local_output_atom_list.size();
+      std::vector<unsigned char> bytes;
+      int bits, encoding;
+
+      if(vout::output_trajectory_quantised){
+
+         // quantise local spins
+         bits = vout::output_trajectory_bits;
+         std::vector<uint16_t> q(2*num_local);
+         for(unsigned int i=0; i<num_local; i++){
+            const int atom = vout::local_output_atom_list[i];
+            internal::octahedral_quantise(atoms::x_spin_array[atom], atoms::y_spin_array[atom], atoms::z_spin_array[atom], bits, q[2*i+0], q[2*i+1]);
+         }
+
+         // encode as key frame or differences to previous frame
+         const bool key_frame = (internal::trajectory_num_frames % vout::output_trajectory_keyframe_interval == 0) ||
+                                (internal::trajectory_previous.size() != q.size());
+         encoding = key_frame ? 0 : 1;
+         if(key_frame) internal::encode_key_frame(q, bits, bytes);
+         else internal::encode_delta_frame(q, internal::trajectory_previous, bits, bytes);
+         internal::trajectory_previous.swap(q);
+
+      }
+      else{
+
+         // copy local spins at output precision
+         bits = 8*vout::output_config_precision;
+         encoding = 2;
+         std::vector<double> spins(3*num_local);
+         for(unsigned int i=0; i<num_local; i++){
+            const int atom = vout::local_output_atom_list[i];
+            spins[3*i+0] = atoms::x_spin_array[atom];
+            spins[3*i+1] = atoms::y_spin_array[atom];
+            spins[3*i+2] = atoms::z_spin_array[atom];
+         }
+         if(vout::output_config_precision==4){
+            const std::vector<float> sp = internal::single_precision(spins);
+            const unsigned char* data = reinterpret_cast<const unsigned char*>(sp.data());
+            bytes.assign(data, data+sp.size()*sizeof(float));
+         }
+         else{
+            const unsigned char* data = reinterpret_cast<const unsigned char*>(spins.data());
+            bytes.assign(data, data+spins.size()*sizeof(double));
+         }
+
+      }
+
+      // determine chunk sizes on all processors and offset of local chunk
+      uint64_t chunk[2] = {num_local, bytes.size()};
+      std::vector<uint64_t> chunks(chunk, chunk+2);
+      uint64_t byte_offset = 0;
+      uint64_t total_bytes = bytes.size();
+      #ifdef MPICF
+         chunks.resize(2*vmpi::num_processors);
+         MPI_Gather(chunk, 2, MPI_UINT64_T, &chunks[0], 2, MPI_UINT64_T, 0, MPI_COMM_WORLD);
+         MPI_Exscan(&chunk[1], &byte_offset, 1, MPI_UINT64_T, MPI_SUM, MPI_COMM_WORLD);
+         if(vmpi::my_rank==0) byte_offset = 0; // result of exscan is undefined on root
+         MPI_Allreduce(&chunk[1], &total_bytes, 1, MPI_UINT64_T, MPI_SUM, MPI_COMM_WORLD);
+      #endif
+      const int num_chunks = chunks.size()/2;
+
+      // get normalised system magnetisation if calculated
+      double m[4] = {0.0, 0.0, 0.0, 0.0};
+      if(stats::calculate_system_magnetization){
+         const std::vector<double>& mag = stats::system_magnetization.get_magnetization();
+         for(int i=0; i<4; i++) m[i] = mag[i];
+      }
+
+      // pack frame header
+      std::vector<char> frame_header;
+      internal::append_to_header<uint64_t>(frame_header, sim::output_atoms_file_counter);
+      internal::append_to_header<double>(frame_header, double(sim::time)*mp::dt_SI);
+      internal::append_to_header<double>(frame_header, sim::H_applied);
+      internal::append_to_header<double>(frame_header, sim::temperature);
+      for(int i=0; i<4; i++) internal::append_to_header<double>(frame_header, m[i]);
+      internal::append_to_header<int32_t>(frame_header, bits);
+      internal::append_to_header<int32_t>(frame_header, encoding);
+      internal::append_to_header<int32_t>(frame_header, num_chunks);
+      for(int c=0; c<2*num_chunks; c++) internal::append_to_header<uint64_t>(frame_header, chunks[c]);
+
+      const uint64_t frame_offset = internal::trajectory_file_size;
+
+      zlog << zTs() << "Outputting trajectory frame " << sim::output_atoms_file_counter << " to " << filename << " ("
+           << double(total_bytes)/double(total > 0 ? total : 1) << " bytes per spin)" << std::endl;
+
+      // append frame to file
+      internal::shared_binary_file_t file;
+      file.open(filename, true);
+      file.write_header(frame_header, frame_offset);
+      file.write_at(frame_offset + frame_header.size() + byte_offset, bytes);
+      file.close();
+
+      // add frame to index on root process
+      if(vmpi::my_rank==0){
+         internal::trajectory_index_entry_t entry;
+         entry.offset = frame_offset;
+         entry.snapshot = sim::output_atoms_file_counter;
+         entry.encoding = encoding;
+         entry.bits = bits;
+         internal::trajectory_index.push_back(entry);
+      }
+
+      internal::trajectory_file_size += frame_header.size() + total_bytes;
+      internal::trajectory_num_frames++;
+
+      sim::output_atoms_file_counter++;
+
+      return;
+
+   }
+
+   //------------------------------------------------------------------------------------------------------
+   // Function to append index of all frames to trajectory file at end of simulation
+   //------------------------------------------------------------------------------------------------------
+   void finalize_trajectory(){
+
+      if(!internal::trajectory_initialized) return;
+
+      const std::string filename = "atoms-trajectory.trj";
+
+      if(vmpi::my_rank==0){
+
+         std::vector<char> index;
+         for(unsigned int f=0; f<internal::trajectory_index.size(); f++){
+            internal::append_to_header<uint64_t>(index, internal::trajectory_index[f].offset);
+            internal::append_to_header<uint64_t>(index, internal::trajectory_index[f].snapshot);
+            internal::append_to_header<int32_t>(index, internal::trajectory_index[f].encoding);
+            internal::append_to_header<int32_t>(index, internal::trajectory_index[f].bits);
+         }
+
+         std::vector<char> header;
+         internal::append_to_header<uint64_t>(header, internal::trajectory_file_size);
+         internal::append_to_header<uint64_t>(header, internal::trajectory_index.size());
+
+         std::fstream file(filename.c_str(), std::ios::in | std::ios::out | std::ios::binary);
+         if(index.size()>0){
+            file.seekp(internal::trajectory_file_size);
+            file.write(&index[0], index.size());
+         }
+         file.seekp(internal::trajectory_index_field);
+         file.write(&header[0], header.size());
+         file.close();
+
+         if(file.fail()) internal::trajectory_error("unable to write index of trajectory file " + filename);
+
+         zlog << zTs() << "Written index of " << internal::trajectory_index.size() << " frames to trajectory file " << filename << std::endl;
+
+      }
+
+      internal::trajectory_initialized = false;
+
+      return;
+
+   }
+
+} // end of namespace vout
@@ -1652,6 +1652,18 @@ int match_sim(string const word, string const value, string const unit, int cons
       return EXIT_SUCCESS;
    }
    //--------------------------------------------------------------------
+   test="hysteresis-loop-time-steps";
+   if(word==test){
+      // loop time steps at each field point for each sweep rate of the hysteresis program
+      std::vector<double> t=DoublesFromString(value);
+      for(unsigned int i=0; i<t.size(); i++){
+         int tt=int(t[i]);
+         check_for_valid_int(tt, word, line, prefix, 1, 2000000000,"input","1 - 2,000,000,000");
+         sim::hysteresis_loop_times.push_back(tt);
+      }
+      return EXIT_SUCCESS;
+   }
+   //--------------------------------------------------------------------
    test="partial-time-steps";
    if(word==test){
       int tt=int(atof(value.c_str()));
@@ -1671,6 +1683,24 @@ int match_sim(string const word, string const value, string const unit, int cons
       return EXIT_SUCCESS;
    }
    //--------------------------------------------------------------------
+   test="target-magnetisation-error";
+   if(word==test){
+      double e=atof(value.c_str());
+      check_for_valid_value(e, word, line, prefix, unit, "none", 1.0e-9, 1.0,"input","1.0e-9 - 1.0");
+      stats::target_magnetization_error=e;
+      stats::calculate_magnetization_autocorrelation=true;
+      stats::calculate_system_magnetization=true;
+      return EXIT_SUCCESS;
+   }
+   //--------------------------------------------------------------------
+   test="adaptive-time-steps-increment";
+   if(word==test){
+      stats::adaptive_partial_time=true;
+      stats::calculate_magnetization_autocorrelation=true;
+      stats::calculate_system_magnetization=true;
+      return EXIT_SUCCESS;
+   }
+   //--------------------------------------------------------------------
    test="equilibration-time-steps";
    if(word==test){
       int tt=int(atof(value.c_str()));
@@ -1986,13 +2016,25 @@ int match_sim(string const word, string const value, string const unit, int cons
       test="replicated-data";
       if(value==test){
          vmpi::mpi_mode=1;
-         vmpi::replicated_data_staged=false;
          return EXIT_SUCCESS;
       }
       test="replicated-data-staged";
       if(value==test){
          vmpi::mpi_mode=1;
-         vmpi::replicated_data_staged=true;
+         terminaltextcolor(YELLOW);
+         std::cerr << "Warning: Value 'replicated-data-staged' for 'sim:" << word << "' is deprecated and may be removed in a future release. Please use 'replicated-data' instead." << std::endl;
+         terminaltextcolor(WHITE);
+         zlog << zTs() << "Warning: Value 'replicated-data-staged' for 'sim:" << word << "' is deprecated, using 'replicated-data'" << std::endl;
+         return EXIT_SUCCESS;
+      }
+      test="statistical-parallelism";
+      if(value==test){
+         vmpi::mpi_mode=2;
+         return EXIT_SUCCESS;
+      }
+      test="recursive-bisection";
+      if(value==test){
+         vmpi::mpi_mode=3;
          return EXIT_SUCCESS;
       }
       else{
@@ -2000,12 +2042,80 @@ int match_sim(string const word, string const value, string const unit, int cons
          std::cerr << "Error - value for \'sim:" << word << "\' must be one of:" << std::endl;
          std::cerr << "\t\"geometric-decomposition\"" << std::endl;
          std::cerr << "\t\"replicated-data\"" << std::endl;
-         std::cerr << "\t\"replicated-data-staged\"" << std::endl;
+         std::cerr << "\t\"statistical-parallelism\"" << std::endl;
+         std::cerr << "\t\"recursive-bisection\"" << std::endl;
 		 terminaltextcolor(WHITE);
          err::vexit();
       }
    }
    //--------------------------------------------------------------------
+   test="mpi-load-balance";
+   if(word==test){
+      test="";
+      std::string test2="atoms-and-bonds";
+      if(value==test || value==test2){
+         vmpi::load_balance=true;
+         vmpi::load_balance_measured=false;
+         return EXIT_SUCCESS;
+      }
+      test="measured";
+      if(value==test){
+         vmpi::load_balance=true;
+         vmpi::load_balance_measured=true;
+         return EXIT_SUCCESS;
+      }
+      else{
+         terminaltextcolor(RED);
+         std::cerr << "Error - value for \'sim:" << word << "\' must be one of:" << std::endl;
+         std::cerr << "\t\"atoms-and-bonds\"\t(static partition from atom and bond counts)" << std::endl;
+         std::cerr << "\t\"measured\"\t\t(static partition from costs measured in a previous run)" << std::endl;
+         terminaltextcolor(WHITE);
+         err::vexit();
+      }
+   }
+   //--------------------------------------------------------------------
+   test="mpi-load-balance-threshold";
+   if(word==test){
+      double lbt=atof(value.c_str());
+      check_for_valid_value(lbt, word, line, prefix, unit, "none", 1.0, 100.0,"input","1.0 - 100.0");
+      vmpi::load_balance_threshold=lbt;
+      return EXIT_SUCCESS;
+   }
+   //--------------------------------------------------------------------
+   test="mpi-halo-encoding";
+   if(word==test){
+      test="double";
+      if(value==test){
+         vmpi::halo_encoding=0;
+         return EXIT_SUCCESS;
+      }
+      test="single";
+      if(value==test){
+         vmpi::halo_encoding=1;
+         return EXIT_SUCCESS;
+      }
+      test="angles-16";
+      if(value==test){
+         vmpi::halo_encoding=2;
+         return EXIT_SUCCESS;
+      }
+      test="angles-32";
+      if(value==test){
+         vmpi::halo_encoding=3;
+         return EXIT_SUCCESS;
+      }
+      else{
+         terminaltextcolor(RED);
+         std::cerr << "Error - value for \'sim:" << word << "\' must be one of:" << std::endl;
+         std::cerr << "\t\"double\"" << std::endl;
+         std::cerr << "\t\"single\"" << std::endl;
+         std::cerr << "\t\"angles-16\"" << std::endl;
+         std::cerr << "\t\"angles-32\"" << std::endl;
+         terminaltextcolor(WHITE);
+         err::vexit();
+      }
+   }
+   //--------------------------------------------------------------------
    test="mpi-ppn";
    if(word==test){
       int ppn=atoi(value.c_str());
@@ -2128,6 +2238,14 @@ int match_sim(string const word, string const value, string const unit, int cons
       }
    }
    //-------------------------------------------------------------------
+   test="monte-carlo-magnetisation-recalculation-rate";
+   if(word==test){
+      int i=atoi(value.c_str());
+      check_for_valid_int(i, word, line, prefix, 0, 1000000000,"input","0 - 1,000,000,000");
+      sim::mc_magnetization_recalculation_rate=i;
+      return EXIT_SUCCESS;
+   }
+   //-------------------------------------------------------------------
    test="save-checkpoint";
    if(word==test){
       test="end";
@@ -2159,6 +2277,15 @@ int match_sim(string const word, string const value, string const unit, int cons
       sim::save_checkpoint_rate=scr;
       return EXIT_SUCCESS;
    }
+   //--------------------------------------------------------------------
+   test="save-checkpoint-wall-time-interval";
+   if(word==test){
+      double t=atof(value.c_str());
+      check_for_valid_value(t, word, line, prefix, "", "none", 0.0, 1.0e6,"input","0 - 1,000,000 minutes");
+      sim::save_checkpoint_flag=true; // Save checkpoint
+      sim::save_checkpoint_wall_time_interval=t;
+      return EXIT_SUCCESS;
+   }
    //-------------------------------------------------------------------
    test="load-checkpoint";
    if(word==test){
@@ -2219,6 +2346,28 @@ int match_sim(string const word, string const value, string const unit, int cons
 
    return EXIT_SUCCESS;
 }
+//-----------------------------------------------------------------------------
+// Function to determine group of atoms for histogram keywords (default system)
+//-----------------------------------------------------------------------------
+stats::histogram_group_t histogram_group(string const word, string const value, int const line, string const prefix){
+
+   if(value=="" || value=="system") return stats::system_group;
+   if(value=="material") return stats::material_group;
+   if(value=="grain") return stats::grain_group;
+
+   terminaltextcolor(RED);
+   std::cerr << "Error - value for \'" << prefix << word << "\' on line " << line << " of input file must be one of:" << std::endl;
+   std::cerr << "\t\"system\"" << std::endl;
+   std::cerr << "\t\"material\"" << std::endl;
+   std::cerr << "\t\"grain\"" << std::endl;
+   terminaltextcolor(WHITE);
+   zlog << zTs() << "Error - value for \'" << prefix << word << "\' on line " << line << " of input file must be one of system, material or grain" << std::endl;
+   err::vexit();
+
+   return stats::system_group;
+
+}
+
 int match_config(string const word, string const value, string const unit, int const line){
 
    std::string prefix="config:";
@@ -2239,6 +2388,108 @@ int match_config(string const word, string const value, string const unit, int c
       return EXIT_SUCCESS;
    }
    //--------------------------------------------------------------------
+   test="atoms-output-format";
+   if(word==test){
+      test="text";
+      if(value==test){
+         vout::output_atoms_config_format=0;
+         return EXIT_SUCCESS;
+      }
+      test="binary";
+      if(value==test){
+         vout::output_atoms_config_format=1;
+         return EXIT_SUCCESS;
+      }
+      test="trajectory";
+      if(value==test){
+         vout::output_atoms_config_format=2;
+         return EXIT_SUCCESS;
+      }
+      else{
+         terminaltextcolor(RED);
+         std::cerr << "Error - value for \'config:" << word << "\' must be one of:" << std::endl;
+         std::cerr << "\t\"text\"" << std::endl;
+         std::cerr << "\t\"binary\"" << std::endl;
+         std::cerr << "\t\"trajectory\"" << std::endl;
+         terminaltextcolor(WHITE);
+         err::vexit();
+      }
+   }
+   //--------------------------------------------------------------------
+   test="binary-output-precision";
+   if(word==test){
+      test="single";
+      if(value==test){
+         vout::output_config_precision=4;
+         return EXIT_SUCCESS;
+      }
+      test="double";
+      if(value==test){
+         vout::output_config_precision=8;
+         return EXIT_SUCCESS;
+      }
+      else{
+         terminaltextcolor(RED);
+         std::cerr << "Error - value for \'config:" << word << "\' must be one of:" << std::endl;
+         std::cerr << "\t\"single\"" << std::endl;
+         std::cerr << "\t\"double\"" << std::endl;
+         terminaltextcolor(WHITE);
+         err::vexit();
+      }
+   }
+   //--------------------------------------------------------------------
+   test="trajectory-precision-bits";
+   if(word==test){
+      int i=atoi(value.c_str());
+      check_for_valid_int(i, word, line, prefix, 8, 16,"input","8 - 16");
+      vout::output_trajectory_bits=i;
+      return EXIT_SUCCESS;
+   }
+   //--------------------------------------------------------------------
+   test="trajectory-keyframe-interval";
+   if(word==test){
+      int i=atoi(value.c_str());
+      check_for_valid_int(i, word, line, prefix, 1, 1000000,"input","1 - 1,000,000");
+      vout::output_trajectory_keyframe_interval=i;
+      return EXIT_SUCCESS;
+   }
+   //--------------------------------------------------------------------
+   test="trajectory-encoding";
+   if(word==test){
+      test="quantised";
+      if(value==test){
+         vout::output_trajectory_quantised=true;
+         return EXIT_SUCCESS;
+      }
+      test="raw";
+      if(value==test){
+         vout::output_trajectory_quantised=false;
+         return EXIT_SUCCESS;
+      }
+      else{
+         terminaltextcolor(RED);
+         std::cerr << "Error - value for \'config:" << word << "\' must be one of:" << std::endl;
+         std::cerr << "\t\"quantised\"" << std::endl;
+         std::cerr << "\t\"raw\"" << std::endl;
+         terminaltextcolor(WHITE);
+         err::vexit();
+      }
+   }
+   //--------------------------------------------------------------------
+   test="asynchronous-output";
+   if(word==test){
+      vout::asynchronous_output=true;
+      return EXIT_SUCCESS;
+   }
+   //--------------------------------------------------------------------
+   test="asynchronous-output-queue-depth";
+   if(word==test){
+      int i=atoi(value.c_str());
+      check_for_valid_int(i, word, line, prefix, 1, 100,"input","1 - 100");
+      vout::asynchronous_output_queue_depth=i;
+      return EXIT_SUCCESS;
+   }
+   //--------------------------------------------------------------------
    test="atoms-minimum-x";
    if(word==test){
       double x=atof(value.c_str());
@@ -2300,6 +2551,138 @@ int match_config(string const word, string const value, string const unit, int c
       vout::output_cells_config_rate=i;
       return EXIT_SUCCESS;
    }
+   //--------------------------------------------------------------------
+   test="macro-cells-output-format";
+   if(word==test){
+      test="text";
+      if(value==test){
+         vout::output_cells_config_format=0;
+         return EXIT_SUCCESS;
+      }
+      test="binary";
+      if(value==test){
+         vout::output_cells_config_format=1;
+         return EXIT_SUCCESS;
+      }
+      else{
+         terminaltextcolor(RED);
+         std::cerr << "Error - value for \'config:" << word << "\' must be one of:" << std::endl;
+         std::cerr << "\t\"text\"" << std::endl;
+         std::cerr << "\t\"binary\"" << std::endl;
+         terminaltextcolor(WHITE);
+         err::vexit();
+      }
+   }
+   //--------------------------------------------------------------------
+   test="structure-factor";
+   if(word==test){
+      stats::calculate_structure_factor=true;
+      return EXIT_SUCCESS;
+   }
+   //--------------------------------------------------------------------
+   test="spin-correlation-function";
+   if(word==test){
+      stats::calculate_structure_factor=true;
+      stats::calculate_correlation_function=true;
+      return EXIT_SUCCESS;
+   }
+   //--------------------------------------------------------------------
+   test="structure-factor-sample-rate";
+   if(word==test){
+      int i=int(atof(value.c_str()));
+      check_for_valid_int(i, word, line, prefix, 1, 1000000,"input","1 - 1,000,000");
+      stats::structure_factor_sample_rate=i;
+      return EXIT_SUCCESS;
+   }
+   //--------------------------------------------------------------------
+   test="structure-factor-output-rate";
+   if(word==test){
+      int i=int(atof(value.c_str()));
+      check_for_valid_int(i, word, line, prefix, 1, 1000000,"input","1 - 1,000,000");
+      vout::output_structure_factor_rate=i;
+      return EXIT_SUCCESS;
+   }
+   //--------------------------------------------------------------------
+   test="dynamic-structure-factor-q-point";
+   if(word==test){
+      std::vector<double> q=DoublesFromString(value);
+      if(q.size()!=3){
+         terminaltextcolor(RED);
+         std::cerr << "Error: " << prefix << word << " on line " << line << " of input file must have three values (h,k,l)." << std::endl;
+         terminaltextcolor(WHITE);
+         zlog << zTs() << "Error: " << prefix << word << " on line " << line << " of input file must have three values (h,k,l)." << std::endl;
+         err::vexit();
+      }
+      stats::dynamic_structure_factor_path.insert(stats::dynamic_structure_factor_path.end(),q.begin(),q.end());
+      stats::calculate_dynamic_structure_factor=true;
+      return EXIT_SUCCESS;
+   }
+   //--------------------------------------------------------------------
+   test="dynamic-structure-factor-q-points-per-segment";
+   if(word==test){
+      int i=int(atof(value.c_str()));
+      check_for_valid_int(i, word, line, prefix, 1, 100000,"input","1 - 100,000");
+      stats::dynamic_structure_factor_points=i;
+      return EXIT_SUCCESS;
+   }
+   //--------------------------------------------------------------------
+   test="dynamic-structure-factor-window";
+   if(word==test){
+      int i=int(atof(value.c_str()));
+      check_for_valid_int(i, word, line, prefix, 2, 1000000,"input","2 - 1,000,000");
+      stats::dynamic_structure_factor_window=i;
+      return EXIT_SUCCESS;
+   }
+   //--------------------------------------------------------------------
+   test="dynamic-structure-factor-output-rate";
+   if(word==test){
+      int i=int(atof(value.c_str()));
+      check_for_valid_int(i, word, line, prefix, 1, 1000000,"input","1 - 1,000,000");
+      vout::output_dynamic_structure_factor_rate=i;
+      return EXIT_SUCCESS;
+   }
+   //--------------------------------------------------------------------
+   test="spin-z-histogram";
+   if(word==test){
+      stats::add_histogram(stats::spin_z, histogram_group(word, value, line, prefix));
+      return EXIT_SUCCESS;
+   }
+   //--------------------------------------------------------------------
+   test="temperature-histogram";
+   if(word==test){
+      stats::add_histogram(stats::local_temperature, histogram_group(word, value, line, prefix));
+      return EXIT_SUCCESS;
+   }
+   //--------------------------------------------------------------------
+   test="grain-magnetisation-histogram";
+   if(word==test){
+      stats::add_histogram(stats::grain_magnetization_length, stats::system_group);
+      return EXIT_SUCCESS;
+   }
+   //--------------------------------------------------------------------
+   test="histogram-bins";
+   if(word==test){
+      int i=int(atof(value.c_str()));
+      check_for_valid_int(i, word, line, prefix, 1, 100000,"input","1 - 100,000");
+      stats::histogram_bins=i;
+      return EXIT_SUCCESS;
+   }
+   //--------------------------------------------------------------------
+   test="histogram-maximum-temperature";
+   if(word==test){
+      double T=atof(value.c_str());
+      check_for_valid_value(T, word, line, prefix, unit, "none", 1.0e-10, 1.0e6,"input","0 - 1,000,000 K");
+      stats::histogram_maximum_temperature=T;
+      return EXIT_SUCCESS;
+   }
+   //--------------------------------------------------------------------
+   test="histogram-output-rate";
+   if(word==test){
+      int i=int(atof(value.c_str()));
+      check_for_valid_int(i, word, line, prefix, 1, 1000000,"input","1 - 1,000,000");
+      vout::output_histogram_rate=i;
+      return EXIT_SUCCESS;
+   }
    //-------------------------------------------------------------------
    test="identify-surface-atoms";
    if(word==test){
@@ -2436,7 +2819,7 @@ int match_vout_list(string const word, string const value, int const line, std::
    //--------------------------------------------------------------------
    test="total-torque";
    if(word==test){
-      stats::calculate_torque=true;
+      stats::require_torque(stats::output_steps);
       output_list.push_back(14);
       return EXIT_SUCCESS;
    }
@@ -2444,7 +2827,7 @@ int match_vout_list(string const word, string const value, int const line, std::
    //--------------------------------------------------------------------
    test="mean-total-torque";
    if(word==test){
-      stats::calculate_torque=true;
+      stats::require_torque(stats::every_update);
       output_list.push_back(15);
       return EXIT_SUCCESS;
    }
@@ -2452,7 +2835,6 @@ int match_vout_list(string const word, string const value, int const line, std::
    //--------------------------------------------------------------------
    test="constraint-phi";
    if(word==test){
-      stats::calculate_torque=true;
       output_list.push_back(16);
       return EXIT_SUCCESS;
    }
@@ -2460,7 +2842,6 @@ int match_vout_list(string const word, string const value, int const line, std::
    //--------------------------------------------------------------------
    test="constraint-theta";
    if(word==test){
-      stats::calculate_torque=true;
       output_list.push_back(17);
       return EXIT_SUCCESS;
    }
@@ -2468,7 +2849,6 @@ int match_vout_list(string const word, string const value, int const line, std::
    //--------------------------------------------------------------------
    test="material-constraint-phi";
    if(word==test){
-      stats::calculate_torque=true;
       output_list.push_back(18);
       return EXIT_SUCCESS;
    }
@@ -2476,7 +2856,6 @@ int match_vout_list(string const word, string const value, int const line, std::
    //--------------------------------------------------------------------
    test="material-constraint-theta";
    if(word==test){
-      stats::calculate_torque=true;
       output_list.push_back(19);
       return EXIT_SUCCESS;
    }
@@ -2484,7 +2863,7 @@ int match_vout_list(string const word, string const value, int const line, std::
    //--------------------------------------------------------------------
    test="material-mean-torque";
    if(word==test){
-      stats::calculate_torque=true;
+      stats::require_torque(stats::every_update);
       output_list.push_back(20);
       return EXIT_SUCCESS;
    }
@@ -2538,112 +2917,112 @@ int match_vout_list(string const word, string const value, int const line, std::
    test="total-energy";
    if(word==test){
       output_list.push_back(27);
-      stats::calculate_energy=true;
+      stats::require_energy(stats::output_steps);
       return EXIT_SUCCESS;
    }
    //-------------------------------------------------------------------
    test="mean-total-energy";
    if(word==test){
       output_list.push_back(28);
-      stats::calculate_energy=true;
+      stats::require_energy(stats::every_update);
       return EXIT_SUCCESS;
    }
    //-------------------------------------------------------------------
    test="anisotropy-energy";
    if(word==test){
       output_list.push_back(29);
-      stats::calculate_energy=true;
+      stats::require_energy(stats::output_steps);
       return EXIT_SUCCESS;
    }
    //-------------------------------------------------------------------
    test="mean-anisotropy-energy";
    if(word==test){
       output_list.push_back(30);
-      stats::calculate_energy=true;
+      stats::require_energy(stats::every_update);
       return EXIT_SUCCESS;
    }
    //-------------------------------------------------------------------
    test="cubic-anisotropy-energy";
    if(word==test){
       output_list.push_back(31);
-      stats::calculate_energy=true;
+      stats::require_energy(stats::output_steps);
       return EXIT_SUCCESS;
    }
    //-------------------------------------------------------------------
    test="mean-cubic-anisotropy-energy";
    if(word==test){
       output_list.push_back(32);
-      stats::calculate_energy=true;
+      stats::require_energy(stats::every_update);
       return EXIT_SUCCESS;
    }
    //-------------------------------------------------------------------
    test="surface-anisotropy-energy";
    if(word==test){
       output_list.push_back(33);
-      stats::calculate_energy=true;
+      stats::require_energy(stats::output_steps);
       return EXIT_SUCCESS;
    }
    //-------------------------------------------------------------------
    test="mean-surface-anisotropy-energy";
    if(word==test){
       output_list.push_back(34);
-      stats::calculate_energy=true;
+      stats::require_energy(stats::every_update);
       return EXIT_SUCCESS;
    }
    //-------------------------------------------------------------------
    test="exchange-energy";
    if(word==test){
       output_list.push_back(35);
-      stats::calculate_energy=true;
+      stats::require_energy(stats::output_steps);
       return EXIT_SUCCESS;
    }
    //-------------------------------------------------------------------
    test="mean-exchange-energy";
    if(word==test){
       output_list.push_back(36);
-      stats::calculate_energy=true;
+      stats::require_energy(stats::every_update);
       return EXIT_SUCCESS;
    }
    //-------------------------------------------------------------------
    test="applied-field-energy";
    if(word==test){
       output_list.push_back(37);
-      stats::calculate_energy=true;
+      stats::require_energy(stats::output_steps);
       return EXIT_SUCCESS;
    }
    //-------------------------------------------------------------------
    test="mean-applied-field-energy";
    if(word==test){
       output_list.push_back(38);
-      stats::calculate_energy=true;
+      stats::require_energy(stats::every_update);
       return EXIT_SUCCESS;
    }
    //-------------------------------------------------------------------
    test="magnetostatic-energy";
    if(word==test){
       output_list.push_back(39);
-      stats::calculate_energy=true;
+      stats::require_energy(stats::output_steps);
       return EXIT_SUCCESS;
    }
    //-------------------------------------------------------------------
    test="mean-magnetostatic-energy";
    if(word==test){
       output_list.push_back(40);
-      stats::calculate_energy=true;
+      stats::require_energy(stats::every_update);
       return EXIT_SUCCESS;
    }
    //-------------------------------------------------------------------
    test="second-order-uniaxial-anisotropy-energy";
    if(word==test){
       output_list.push_back(41);
-      stats::calculate_energy=true;
+      stats::require_energy(stats::output_steps);
       return EXIT_SUCCESS;
    }
    //-------------------------------------------------------------------
    test="mean-second-order-uniaxial-anisotropy-energy";
    if(word==test){
       output_list.push_back(42);
-      stats::calculate_energy=true;
+      stats::require_energy(stats::every_update);
       return EXIT_SUCCESS;
    }
    //--------------------------------------------------------------------
@@ -2680,6 +3059,52 @@ int match_vout_list(string const word, string const value, int const line, std::
       output_list.push_back(47);
       return EXIT_SUCCESS;
    }
+   //--------------------------------------------------------------------
+   test="binder-cumulant";
+   if(word==test){
+      stats::calculate_system_moments=true;
+      stats::calculate_system_magnetization=true;
+      output_list.push_back(48);
+      return EXIT_SUCCESS;
+   }
+   //--------------------------------------------------------------------
+   test="material-magnetisation-correlation";
+   if(word==test){
+      stats::calculate_material_moments=true;
+      stats::calculate_material_magnetization=true;
+      output_list.push_back(49);
+      return EXIT_SUCCESS;
+   }
+   //--------------------------------------------------------------------
+   test="specific-heat";
+   if(word==test){
+      stats::calculate_specific_heat=true;
+      output_list.push_back(50);
+      return EXIT_SUCCESS;
+   }
+   //--------------------------------------------------------------------
+   test="magnetisation-autocorrelation-time";
+   if(word==test){
+      stats::calculate_magnetization_autocorrelation=true;
+      stats::calculate_system_magnetization=true;
+      output_list.push_back(51);
+      return EXIT_SUCCESS;
+   }
+   //--------------------------------------------------------------------
+   test="energy-autocorrelation-time";
+   if(word==test){
+      stats::calculate_energy_autocorrelation=true;
+      output_list.push_back(52);
+      return EXIT_SUCCESS;
+   }
+   //--------------------------------------------------------------------
+   test="mean-magnetisation-length-error";
+   if(word==test){
+      stats::calculate_magnetization_autocorrelation=true;
+      stats::calculate_system_magnetization=true;
+      output_list.push_back(53);
+      return EXIT_SUCCESS;
+   }
    //-------------------------------------------------------------------
    test="mpi-timings";
    if(word==test){
@@ -2781,6 +3206,7 @@ int match_vout_grain_list(string const word, string const value, int const line,
    //--------------------------------------------------------------------
    test="material-magnetisation";
    if(word==test){
+      grains::calculate_material_magnetisation=true;
       output_list.push_back(13);
       return EXIT_SUCCESS;
    }
@@ -4249,6 +4675,36 @@ namespace vout{
       stream << sim::fmr_field << "\t";
    }
 
+   // Output Function 48
+   void binder_cumulant(std::ostream& stream){
+      stream << stats::system_moments.output_binder_cumulant();
+   }
+
+   // Output Function 49
+   void material_magnetisation_correlation(std::ostream& stream){
+      stream << stats::material_moments.output_correlation();
+   }
+
+   // Output Function 50
+   void specific_heat(std::ostream& stream){
+      stream << stats::energy_moments.output_specific_heat(sim::temperature);
+   }
+
+   // Output Function 51
+   void magnetisation_autocorrelation_time(std::ostream& stream){
+      stream << stats::magnetization_autocorrelation.output_autocorrelation_time(sim::partial_time);
+   }
+
+   // Output Function 52
+   void energy_autocorrelation_time(std::ostream& stream){
+      stream << stats::energy_autocorrelation.output_autocorrelation_time(sim::partial_time);
+   }
+
+   // Output Function 53
+   void mean_magnetisation_length_error(std::ostream& stream){
+      stream << stats::magnetization_autocorrelation.output_standard_error();
+   }
+
    // Output Function 60
 	void MPITimings(std::ostream& stream){
 
@@ -4266,15 +4722,20 @@ namespace vout{
 		#ifdef MPICF
 		if(vmpi::DetailedMPITiming){
 
+			// times are reduced over processors simulating the same system
+			const MPI_Comm comm = vmpi::statistics_communicator();
+			int comm_size = 1;
+			MPI_Comm_size(comm, &comm_size);
+
 			// Calculate Average times
-			MPI_Reduce (&vmpi::TotalComputeTime,&vmpi::AverageComputeTime,1,MPI_DOUBLE,MPI_SUM,0,MPI_COMM_WORLD);
-			MPI_Reduce (&vmpi::TotalWaitTime,&vmpi::AverageWaitTime,1,MPI_DOUBLE,MPI_SUM,0,MPI_COMM_WORLD);
-			vmpi::AverageComputeTime/=double(vmpi::num_processors);
-			vmpi::AverageWaitTime/=double(vmpi::num_processors);
+			MPI_Reduce (&vmpi::TotalComputeTime,&vmpi::AverageComputeTime,1,MPI_DOUBLE,MPI_SUM,0,comm);
+			MPI_Reduce (&vmpi::TotalWaitTime,&vmpi::AverageWaitTime,1,MPI_DOUBLE,MPI_SUM,0,comm);
+			vmpi::AverageComputeTime/=double(comm_size);
+			vmpi::AverageWaitTime/=double(comm_size);
 
 			// Calculate Maximum times
-			MPI_Reduce (&vmpi::TotalComputeTime,&vmpi::MaximumComputeTime,1,MPI_DOUBLE,MPI_MAX,0,MPI_COMM_WORLD);
-			MPI_Reduce (&vmpi::TotalWaitTime,&vmpi::MaximumWaitTime,1,MPI_DOUBLE,MPI_MAX,0,MPI_COMM_WORLD);
+			MPI_Reduce (&vmpi::TotalComputeTime,&vmpi::MaximumComputeTime,1,MPI_DOUBLE,MPI_MAX,0,comm);
+			MPI_Reduce (&vmpi::TotalWaitTime,&vmpi::MaximumWaitTime,1,MPI_DOUBLE,MPI_MAX,0,comm);
 
 			// Save times for timing matrix
 			vmpi::ComputeTimeArray.push_back(vmpi::TotalComputeTime);
@@ -4289,10 +4750,10 @@ namespace vout{
       // check for open ofstream
       if(!zmag.is_open()){
          // check for checkpoint continue and append data
-         if(sim::load_checkpoint_flag && sim::load_checkpoint_continue_flag) zmag.open("output",std::ofstream::app);
+         if(sim::load_checkpoint_flag && sim::load_checkpoint_continue_flag) zmag.open(vmpi::output_file_name().c_str(),std::ofstream::app);
          // otherwise overwrite file
          else{
-            zmag.open("output",std::ofstream::trunc);
+            zmag.open(vmpi::output_file_name().c_str(),std::ofstream::trunc);
             // write file header information
             if(vmpi::my_rank==0) write_output_file_header(zmag, file_output_list);
          }
@@ -4301,8 +4762,8 @@ namespace vout{
 		// Only output 1/output_rate time steps
       if(sim::time%vout::output_rate==0){
 
-		// Output data to output
-      if(vmpi::my_rank==0){
+		// Output data to output (from all processors in statistical parallel mode)
+      if(vmpi::my_rank==0 || vmpi::mpi_mode==2){
 
       // For gpu acceleration get statistics from device
       if(gpu::acceleration) gpu::stats::get();
@@ -4444,6 +4905,24 @@ namespace vout{
             case 47:
                vout::fmr_field_strength(zmag);
                break;
+            case 48:
+               vout::binder_cumulant(zmag);
+               break;
+            case 49:
+               vout::material_magnetisation_correlation(zmag);
+               break;
+            case 50:
+               vout::specific_heat(zmag);
+               break;
+            case 51:
+               vout::magnetisation_autocorrelation_time(zmag);
+               break;
+            case 52:
+               vout::energy_autocorrelation_time(zmag);
+               break;
+            case 53:
+               vout::mean_magnetisation_length_error(zmag);
+               break;
             case 60:
 					vout::MPITimings(zmag);
 					break;
@@ -4584,6 +5063,24 @@ namespace vout{
             case 47:
                vout::fmr_field_strength(std::cout);
                break;
+            case 48:
+               vout::binder_cumulant(std::cout);
+               break;
+            case 49:
+               vout::material_magnetisation_correlation(std::cout);
+               break;
+            case 50:
+               vout::specific_heat(std::cout);
+               break;
+            case 51:
+               vout::magnetisation_autocorrelation_time(std::cout);
+               break;
+            case 52:
+               vout::energy_autocorrelation_time(std::cout);
+               break;
+            case 53:
+               vout::mean_magnetisation_length_error(std::cout);
+               break;
             case 60:
 					vout::MPITimings(std::cout);
 					break;
@@ -4653,6 +5150,7 @@ namespace vout{
 
       // optionally save checkpoint file
       if(sim::save_checkpoint_flag==true && sim::save_checkpoint_continuous_flag==true && sim::time%sim::save_checkpoint_rate==0) save_checkpoint();
+      else if(sim::save_checkpoint_flag==true) save_checkpoint_on_wall_time();
 
 	} // end of data
 
@@ -0,0 +1,33 @@
+#!/bin/sh
+#------------------------------------------
+# Runs the input in this directory with a
+# serial and an MPI build of vampire and
+# checks that statistical parallel mode
+# gives the same output as the serial run.
+#
+# usage: check.sh serial-binary mpi-binary [processors]
+#------------------------------------------
+serial=$(readlink -f "$1")
+parallel=$(readlink -f "$2")
+np=${3:-3}
+here=$(cd "$(dirname "$0")" && pwd)
+work=$(mktemp -d)
+
+mkdir "$work/serial" "$work/parallel"
+cp "$here/input" "$here/Co.mat" "$work/serial"
+cp "$here/input" "$here/Co.mat" "$work/parallel"
+
+(cd "$work/serial" && "$serial" > screen.txt 2>&1) || { echo "serial run failed"; exit 1; }
+(cd "$work/parallel" && mpirun -np "$np" "$parallel" > screen.txt 2>&1) || { echo "parallel run failed"; exit 1; }
+
+# compare data, ignoring the file header
+grep -v "^#" "$work/serial/output" > "$work/serial.dat"
+grep -v "^#" "$work/parallel/output" > "$work/parallel.dat"
+if [ -s "$work/serial.dat" ] && cmp -s "$work/serial.dat" "$work/parallel.dat"; then
+   echo "statistical parallelism: output identical to serial run"
+   rm -rf "$work"
+   exit 0
+else
+   echo "statistical parallelism: output differs from serial run (see $work)"
+   exit 1
+fi
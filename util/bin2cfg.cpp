@@ -0,0 +1,266 @@
+//-----------------------------------------------------------------------------
+//
+// This source file is part of the VAMPIRE open source package under the
+// GNU GPL (version 2) licence (see licence file for details).
+//
+// (c) R F L Evans 2016. All rights reserved.
+//
+//-----------------------------------------------------------------------------
+//
+// Program to convert vampire binary configuration files (config:atoms-output-format
+// = binary and config:cells-output-format = binary) to the text cfg format, so
+// that cfg2povray, cfg2vtk and cfg2rasmol can be used on binary output
+//
+// ./bin2cfg atoms-coords.bin atoms-00000000.bin cells-coords.bin ...
+//
+// Each file X.bin is converted to X.cfg. System dimensions of snapshots are read
+// from the coordinate file in the same directory if present. Atomic coordinate
+// files do not store element names, so the material number is written in the
+// element column.
+//
+
+// Standard Libraries
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <stdint.h>
+
+const int max_version = 2;
+
+//-----------------------------------------------------------------------------
+// Function to read a value from a binary file
+//-----------------------------------------------------------------------------
+template <typename T> T read_value(std::ifstream& ifile){
+	T value;
+	ifile.read(reinterpret_cast<char*>(&value), sizeof(T));
+	return value;
+}
+
+//-----------------------------------------------------------------------------
+// Function to read a block of values stored as float or double
+//-----------------------------------------------------------------------------
+std::vector<double> read_real_block(std::ifstream& ifile, const uint64_t size, const int bytes){
+	std::vector<double> data(size);
+	if(bytes==4){
+		std::vector<float> sp(size);
+		ifile.read(reinterpret_cast<char*>(&sp[0]), size*sizeof(float));
+		for(uint64_t i=0; i<size; i++) data[i] = sp[i];
+	}
+	else ifile.read(reinterpret_cast<char*>(&data[0]), size*sizeof(double));
+	return data;
+}
+
+//-----------------------------------------------------------------------------
+// Function to read system dimensions from coordinate file in same directory
+//-----------------------------------------------------------------------------
+void read_dimensions(const std::string& filename, const std::string& coord_file, double dimensions[3]){
+	dimensions[0] = dimensions[1] = dimensions[2] = 0.0;
+	const std::string::size_type slash = filename.rfind('/');
+	const std::string path = (slash==std::string::npos) ? coord_file : filename.substr(0, slash+1) + coord_file;
+	std::ifstream cfile(path.c_str(), std::ios::in | std::ios::binary);
+	if(!cfile.is_open()) return;
+	cfile.seekg(8+2*sizeof(int32_t)+sizeof(uint64_t));
+	for(int i=0; i<3; i++) dimensions[i] = read_value<double>(cfile);
+	if(!cfile) dimensions[0] = dimensions[1] = dimensions[2] = 0.0;
+}
+
+//-----------------------------------------------------------------------------
+// Function to write standard file header
+//-----------------------------------------------------------------------------
+void write_header(std::ofstream& ofile, const std::string& title){
+	time_t rawtime = time(NULL);
+	struct tm * timeinfo = localtime(&rawtime);
+	ofile << "#------------------------------------------------------\n";
+	ofile << "# " << title << "\n";
+	ofile << "#------------------------------------------------------\n";
+	ofile << "# Date: " << asctime(timeinfo);
+	ofile << "#------------------------------------------------------\n";
+}
+
+//-----------------------------------------------------------------------------
+// Atomic coordinates
+//-----------------------------------------------------------------------------
+void convert_atoms_coords(std::ifstream& ifile, std::ofstream& ofile, const int bytes){
+
+	const uint64_t n = read_value<uint64_t>(ifile);
+	for(int i=0; i<3; i++) read_value<double>(ifile);
+	read_value<int32_t>(ifile); // number of materials
+
+	std::vector<uint64_t> ids(n);
+	std::vector<int32_t> mat(n), cat(n);
+	if(n>0){
+		ifile.read(reinterpret_cast<char*>(&ids[0]), n*sizeof(uint64_t));
+		ifile.read(reinterpret_cast<char*>(&mat[0]), n*sizeof(int32_t));
+		ifile.read(reinterpret_cast<char*>(&cat[0]), n*sizeof(int32_t));
+	}
+	const std::vector<double> coords = read_real_block(ifile, 3*n, bytes);
+
+	write_header(ofile, "Atomistic coordinates configuration file for vampire");
+	ofile << "Number of atoms: " << n << "\n";
+	ofile << "#------------------------------------------------------\n";
+	ofile << "Number of spin files: 0\n";
+	ofile << "#------------------------------------------------------\n";
+	ofile << n << "\n";
+	for(uint64_t i=0; i<n; i++){
+		ofile << mat[i] << "\t" << cat[i] << "\t" << coords[3*i+0] << "\t" << coords[3*i+1] << "\t" << coords[3*i+2] << "\t" << mat[i] << "\n";
+	}
+
+}
+
+//-----------------------------------------------------------------------------
+// Atomic spin snapshot
+//-----------------------------------------------------------------------------
+void convert_atoms(std::ifstream& ifile, std::ofstream& ofile, const int bytes, const double dimensions[3]){
+
+	const uint64_t n = read_value<uint64_t>(ifile);
+	read_value<uint64_t>(ifile); // snapshot number
+	const double time = read_value<double>(ifile);
+	const double field = read_value<double>(ifile);
+	const double temperature = read_value<double>(ifile);
+	double m[4];
+	for(int i=0; i<4; i++) m[i] = read_value<double>(ifile);
+	const int32_t num_materials = read_value<int32_t>(ifile);
+	std::vector<double> mu_s(num_materials);
+	for(int mat=0; mat<num_materials; mat++) mu_s[mat] = read_value<double>(ifile);
+
+	ifile.seekg(n*sizeof(uint64_t), std::ios::cur); // global atom ids
+	const std::vector<double> spins = read_real_block(ifile, 3*n, bytes);
+
+	write_header(ofile, "Atomistic spin configuration file for vampire");
+	ofile << "Number of spins: " << n << "\n";
+	ofile << "System dimensions:" << dimensions[0] << "\t" << dimensions[1] << "\t" << dimensions[2] << "\n";
+	ofile << "Coordinates-file: atoms-coord.cfg\n";
+	ofile << "Time: " << time << "\n";
+	ofile << "Field: " << field << "\n";
+	ofile << "Temperature: " << temperature << "\n";
+	ofile << "Magnetisation: " << m[0] << "\t" << m[1] << "\t" << m[2] << "\t" << m[3] << "\t\n";
+	ofile << "Number of Materials: " << num_materials << "\n";
+	for(int mat=0; mat<num_materials; mat++) ofile << mu_s[mat] << "\n";
+	ofile << "#------------------------------------------------------\n";
+	ofile << "Number of spin files: 0\n";
+	ofile << "#------------------------------------------------------\n";
+	ofile << n << "\n";
+	for(uint64_t i=0; i<n; i++){
+		ofile << spins[3*i+0] << "\t" << spins[3*i+1] << "\t" << spins[3*i+2] << "\n";
+	}
+
+}
+
+//-----------------------------------------------------------------------------
+// Cell coordinates
+//-----------------------------------------------------------------------------
+void convert_cells_coords(std::ifstream& ifile, std::ofstream& ofile, const int bytes){
+
+	const uint64_t n = read_value<uint64_t>(ifile);
+	for(int i=0; i<3; i++) read_value<double>(ifile);
+	read_value<double>(ifile); // cell size
+	const std::vector<double> coords = read_real_block(ifile, 3*n, bytes);
+
+	write_header(ofile, "Cell coordinates configuration file for vampire");
+	ofile << "# Number of cells: " << n << "\n";
+	ofile << "#------------------------------------------------------\n";
+	for(int i=0; i<5; i++) ofile << "#\n";
+	ofile << "#------------------------------------------------------\n";
+	for(uint64_t i=0; i<n; i++){
+		ofile << coords[3*i+0] << "\t" << coords[3*i+1] << "\t" << coords[3*i+2] << "\n";
+	}
+
+}
+
+//-----------------------------------------------------------------------------
+// Cell magnetisation and field snapshot
+//-----------------------------------------------------------------------------
+void convert_cells(std::ifstream& ifile, std::ofstream& ofile, const int bytes, const double dimensions[3]){
+
+	const uint64_t n = read_value<uint64_t>(ifile);
+	read_value<uint64_t>(ifile); // snapshot number
+	const double time = read_value<double>(ifile);
+	const double field = read_value<double>(ifile);
+	const double temperature = read_value<double>(ifile);
+	double m[4];
+	for(int i=0; i<4; i++) m[i] = read_value<double>(ifile);
+
+	const std::vector<double> mag = read_real_block(ifile, 3*n, bytes);
+	const std::vector<double> hd = read_real_block(ifile, 3*n, bytes);
+
+	write_header(ofile, "Cell configuration file for vampire");
+	ofile << "# Number of spins: " << n << "\n";
+	ofile << "# System dimensions:" << dimensions[0] << "\t" << dimensions[1] << "\t" << dimensions[2] << "\n";
+	ofile << "# Coordinates-file: cells-coord.cfg\n";
+	ofile << "# Time: " << time << "\n";
+	ofile << "# Field: " << field << "\n";
+	ofile << "# Temperature: " << temperature << "\n";
+	ofile << "# Magnetisation: " << m[0] << "\t" << m[1] << "\t" << m[2] << "\t" << m[3] << "\t\n";
+	ofile << "#------------------------------------------------------\n";
+	for(uint64_t i=0; i<n; i++){
+		ofile << mag[3*i+0] << "\t" << mag[3*i+1] << "\t" << mag[3*i+2] << "\t";
+		ofile << hd[3*i+0] << "\t" << hd[3*i+1] << "\t" << hd[3*i+2] << "\n";
+	}
+
+}
+
+int main(int argc, char* argv[]){
+
+	if(argc<2){
+		std::cerr << "Usage: bin2cfg file.bin [file.bin ...]" << std::endl;
+		return EXIT_FAILURE;
+	}
+
+	for(int f=1; f<argc; f++){
+
+		const std::string filename = argv[f];
+		std::ifstream ifile(filename.c_str(), std::ios::in | std::ios::binary);
+		if(!ifile.is_open()){
+			std::cerr << "Error - unable to open file " << filename << std::endl;
+			return EXIT_FAILURE;
+		}
+
+		char id[8];
+		ifile.read(id, 8);
+		const int version = read_value<int32_t>(ifile);
+		const int bytes = read_value<int32_t>(ifile);
+
+		if(version<1 || version>max_version || (bytes!=4 && bytes!=8)){
+			std::cerr << "Error - " << filename << " has unsupported version " << version << " or precision " << bytes << std::endl;
+			return EXIT_FAILURE;
+		}
+
+		std::string outname = filename;
+		if(outname.size()>4 && outname.substr(outname.size()-4)==".bin") outname = outname.substr(0, outname.size()-4);
+		outname += ".cfg";
+		std::ofstream ofile(outname.c_str());
+
+		if(std::strncmp(id, "VAMPCRD", 8)==0) convert_atoms_coords(ifile, ofile, bytes);
+		else if(std::strncmp(id, "VAMPSPN", 8)==0){
+			double dimensions[3];
+			read_dimensions(filename, "atoms-coords.bin", dimensions);
+			convert_atoms(ifile, ofile, bytes, dimensions);
+		}
+		else if(std::strncmp(id, "VAMPCCD", 8)==0) convert_cells_coords(ifile, ofile, bytes);
+		else if(std::strncmp(id, "VAMPCEL", 8)==0){
+			double dimensions[3];
+			read_dimensions(filename, "cells-coords.bin", dimensions);
+			convert_cells(ifile, ofile, bytes, dimensions);
+		}
+		else{
+			std::cerr << "Error - " << filename << " is not a vampire binary configuration file" << std::endl;
+			return EXIT_FAILURE;
+		}
+
+		if(!ifile){
+			std::cerr << "Error - " << filename << " is truncated" << std::endl;
+			return EXIT_FAILURE;
+		}
+
+		std::cout << "Converted " << filename << " to " << outname << std::endl;
+
+	}
+
+	return EXIT_SUCCESS;
+
+}
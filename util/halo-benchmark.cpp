@@ -0,0 +1,132 @@
+//-----------------------------------------------------------------------------
+//
+// This source file is part of the VAMPIRE open source package under the
+// GNU GPL (version 2) licence (see licence file for details).
+//
+// (c) R F L Evans 2016. All rights reserved.
+//
+//-----------------------------------------------------------------------------
+//
+// Microbenchmark of halo swap latency against message size
+//
+// Each rank exchanges a block of spins (3 doubles per spin) with its left and
+// right neighbours on a ring, mimicking the vampire halo swap. Two variants
+// are timed for every message size:
+//
+//    fresh      - Isend/Irecv posted every swap (old behaviour)
+//    persistent - Send_init/Recv_init created once and restarted
+//
+// Compile and run with, for example:
+//
+//    mpicxx -O3 -o halo-benchmark halo-benchmark.cpp
+//    for n in 2 4 8 16; do mpirun -np $n ./halo-benchmark; done
+//
+// Output columns: ranks, spins per message, bytes per message, mean time per
+// swap for fresh and persistent requests in microseconds.
+//
+
+// Standard Libraries
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+// MPI header
+#include <mpi.h>
+
+//------------------------------------------------------------------------------
+// Time a number of swaps with requests posted on every iteration
+//------------------------------------------------------------------------------
+double time_fresh(std::vector<double>& send, std::vector<double>& recv, int left, int right, int num_pts, int num_swaps){
+
+   MPI_Request requests[4];
+   MPI_Status stati[4];
+
+   MPI_Barrier(MPI_COMM_WORLD);
+   double start = MPI_Wtime();
+
+   for(int swap=0; swap<num_swaps; swap++){
+      MPI_Irecv(&recv[0],       num_pts, MPI_DOUBLE, left,  48, MPI_COMM_WORLD, &requests[0]);
+      MPI_Irecv(&recv[num_pts], num_pts, MPI_DOUBLE, right, 48, MPI_COMM_WORLD, &requests[1]);
+      MPI_Isend(&send[0],       num_pts, MPI_DOUBLE, right, 48, MPI_COMM_WORLD, &requests[2]);
+      MPI_Isend(&send[num_pts], num_pts, MPI_DOUBLE, left,  48, MPI_COMM_WORLD, &requests[3]);
+      MPI_Waitall(4, requests, stati);
+   }
+
+   return (MPI_Wtime()-start)/double(num_swaps);
+
+}
+
+//------------------------------------------------------------------------------
+// Time a number of swaps with persistent requests
+//------------------------------------------------------------------------------
+double time_persistent(std::vector<double>& send, std::vector<double>& recv, int left, int right, int num_pts, int num_swaps){
+
+   MPI_Request requests[4];
+   MPI_Status stati[4];
+
+   MPI_Recv_init(&recv[0],       num_pts, MPI_DOUBLE, left,  49, MPI_COMM_WORLD, &requests[0]);
+   MPI_Recv_init(&recv[num_pts], num_pts, MPI_DOUBLE, right, 49, MPI_COMM_WORLD, &requests[1]);
+   MPI_Send_init(&send[0],       num_pts, MPI_DOUBLE, right, 49, MPI_COMM_WORLD, &requests[2]);
+   MPI_Send_init(&send[num_pts], num_pts, MPI_DOUBLE, left,  49, MPI_COMM_WORLD, &requests[3]);
+
+   MPI_Barrier(MPI_COMM_WORLD);
+   double start = MPI_Wtime();
+
+   for(int swap=0; swap<num_swaps; swap++){
+      MPI_Startall(4, requests);
+      MPI_Waitall(4, requests, stati);
+   }
+
+   double time = (MPI_Wtime()-start)/double(num_swaps);
+
+   for(int r=0; r<4; r++) MPI_Request_free(&requests[r]);
+
+   return time;
+
+}
+
+int main(int argc, char* argv[]){
+
+   MPI_Init(&argc, &argv);
+
+   int my_rank, num_processors;
+   MPI_Comm_rank(MPI_COMM_WORLD, &my_rank);
+   MPI_Comm_size(MPI_COMM_WORLD, &num_processors);
+
+   const int left  = (my_rank - 1 + num_processors) % num_processors;
+   const int right = (my_rank + 1) % num_processors;
+
+   if(my_rank==0) std::cout << "# ranks\tspins\tbytes\tfresh[us]\tpersistent[us]" << std::endl;
+
+   // message sizes from 1 spin to 256k spins
+   for(int num_spins=1; num_spins <= 262144; num_spins*=4){
+
+      const int num_pts = 3*num_spins;
+      std::vector<double> send(2*num_pts,1.0);
+      std::vector<double> recv(2*num_pts,0.0);
+
+      // fewer repetitions for large messages
+      const int num_swaps = num_spins < 4096 ? 1000 : 100;
+
+      // warm up connections
+      time_fresh(send, recv, left, right, num_pts, 10);
+
+      double fresh = time_fresh(send, recv, left, right, num_pts, num_swaps);
+      double persistent = time_persistent(send, recv, left, right, num_pts, num_swaps);
+
+      // take slowest rank as halo swap time
+      MPI_Allreduce(MPI_IN_PLACE, &fresh, 1, MPI_DOUBLE, MPI_MAX, MPI_COMM_WORLD);
+      MPI_Allreduce(MPI_IN_PLACE, &persistent, 1, MPI_DOUBLE, MPI_MAX, MPI_COMM_WORLD);
+
+      if(my_rank==0){
+         std::cout << num_processors << "\t" << num_spins << "\t" << num_pts*sizeof(double) << "\t";
+         std::cout << fresh*1.0e6 << "\t" << persistent*1.0e6 << std::endl;
+      }
+
+   }
+
+   MPI_Finalize();
+
+   return EXIT_SUCCESS;
+
+}
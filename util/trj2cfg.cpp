@@ -0,0 +1,350 @@
+//-----------------------------------------------------------------------------
+//
+// This source file is part of the VAMPIRE open source package under the
+// GNU GPL (version 2) licence (see licence file for details).
+//
+// (c) R F L Evans 2016. All rights reserved.
+//
+//-----------------------------------------------------------------------------
+//
+// Program to decode frames of a vampire spin trajectory (config:atoms-output-format
+// = trajectory) to the text cfg format
+//
+// ./trj2cfg                   decode all frames
+// ./trj2cfg 10 42             decode frames 10 and 42
+//
+// Reads atoms-trajectory.trj in the current directory and writes the static
+// datasets to atoms-coords.cfg and atoms-XXXXXXXX.cfg for each frame, numbered
+// by snapshot. Frames are located with the index at the end of the file, or by
+// reading the frame headers in sequence if the simulation did not finish, and
+// quantised frames are decoded from the preceding key frame. Trajectory files
+// do not store element names, so the material number is written in the element
+// column of the coordinate file.
+//
+
+// Standard Libraries
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <stdint.h>
+
+const int version = 2;
+const int rice_chunk_size = 1024;
+const int rice_escape = 24;
+
+struct index_entry_t{
+	uint64_t offset;
+	uint64_t snapshot;
+	int32_t encoding;
+	int32_t bits;
+};
+
+//-----------------------------------------------------------------------------
+// Function to read a value from a binary file
+//-----------------------------------------------------------------------------
+template <typename T> T read_value(std::ifstream& ifile){
+	T value = 0;
+	ifile.read(reinterpret_cast<char*>(&value), sizeof(T));
+	return value;
+}
+
+//-----------------------------------------------------------------------------
+// Class to unpack values from a byte stream, least significant bit first
+//-----------------------------------------------------------------------------
+class bit_reader_t{
+
+	public:
+
+		bit_reader_t(const std::vector<unsigned char>& in_bytes): bytes(in_bytes), position(0), buffer(0), count(0){}
+
+		uint32_t read(const int num_bits){
+			while(count<num_bits){
+				const uint64_t byte = position<bytes.size() ? bytes[position] : 0;
+				buffer |= byte << count;
+				position++;
+				count += 8;
+			}
+			const uint32_t value = buffer & ((uint64_t(1) << num_bits)-1);
+			buffer >>= num_bits;
+			count -= num_bits;
+			return value;
+		}
+
+	private:
+
+		const std::vector<unsigned char>& bytes;
+		uint64_t position;
+		uint64_t buffer;
+		int count;
+
+};
+
+//-----------------------------------------------------------------------------
+// Function to decode key frame block
+//-----------------------------------------------------------------------------
+void decode_key_block(const std::vector<unsigned char>& bytes, const int bits, uint16_t* q, const uint64_t n){
+	bit_reader_t reader(bytes);
+	for(uint64_t i=0; i<n; i++) q[i] = reader.read(bits);
+}
+
+//-----------------------------------------------------------------------------
+// Function to decode Rice coded differences to previous frame in place
+//-----------------------------------------------------------------------------
+void decode_delta_block(const std::vector<unsigned char>& bytes, const int bits, uint16_t* q, const uint64_t n){
+	bit_reader_t reader(bytes);
+	for(uint64_t start=0; start<n; start+=rice_chunk_size){
+		const uint64_t end = (start+rice_chunk_size < n) ? start+rice_chunk_size : n;
+		const int k = reader.read(5);
+		for(uint64_t i=start; i<end; i++){
+			uint32_t quotient = 0;
+			while(quotient<uint32_t(rice_escape) && reader.read(1)==1) quotient++;
+			uint32_t r;
+			if(quotient==uint32_t(rice_escape)) r = reader.read(bits+1);
+			else r = (quotient << k) | reader.read(k);
+			const int d = (r & 1) ? -int((r+1)/2) : int(r/2);
+			q[i] = uint16_t(int(q[i])+d);
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------
+// Function to convert octahedral encoded values to a unit vector
+//-----------------------------------------------------------------------------
+void octahedral_decode(const uint16_t qu, const uint16_t qv, const int bits, double& sx, double& sy, double& sz){
+	const double scale = 2.0/double((1<<bits)-1);
+	double u = qu*scale-1.0;
+	double v = qv*scale-1.0;
+	const double w = 1.0-fabs(u)-fabs(v);
+	if(w<0.0){
+		const double fu = (1.0-fabs(v))*(u>=0.0 ? 1.0 : -1.0);
+		const double fv = (1.0-fabs(u))*(v>=0.0 ? 1.0 : -1.0);
+		u = fu;
+		v = fv;
+	}
+	const double norm = 1.0/sqrt(u*u+v*v+w*w);
+	sx = u*norm;
+	sy = v*norm;
+	sz = w*norm;
+}
+
+//-----------------------------------------------------------------------------
+// Function to write standard file header
+//-----------------------------------------------------------------------------
+void write_header(std::ofstream& ofile, const std::string& title){
+	time_t rawtime = time(NULL);
+	struct tm * timeinfo = localtime(&rawtime);
+	ofile << "#------------------------------------------------------\n";
+	ofile << "# " << title << "\n";
+	ofile << "#------------------------------------------------------\n";
+	ofile << "# Date: " << asctime(timeinfo);
+	ofile << "#------------------------------------------------------\n";
+}
+
+//-----------------------------------------------------------------------------
+// Function to rebuild index from frame headers of an unfinished trajectory
+//-----------------------------------------------------------------------------
+void scan_frames(std::ifstream& trj, uint64_t position, const uint64_t length, const uint64_t num_spins,
+                 std::vector<index_entry_t>& index){
+	const uint64_t frame_header_size = 76;
+	while(position+frame_header_size<=length){
+		index_entry_t entry;
+		entry.offset = position;
+		trj.seekg(position);
+		entry.snapshot = read_value<uint64_t>(trj);
+		trj.seekg(7*sizeof(double), std::ios::cur);
+		entry.bits = read_value<int32_t>(trj);
+		entry.encoding = read_value<int32_t>(trj);
+		const int32_t num_chunks = read_value<int32_t>(trj);
+		if(!trj || num_chunks<1 || entry.encoding<0 || entry.encoding>2) break;
+		if(index.size()>0 && entry.snapshot<=index.back().snapshot) break;
+		uint64_t size = frame_header_size + 2*num_chunks*sizeof(uint64_t);
+		uint64_t spins = 0;
+		for(int c=0; c<num_chunks; c++){
+			spins += read_value<uint64_t>(trj);
+			size += read_value<uint64_t>(trj);
+		}
+		if(!trj || spins!=num_spins || position+size>length) break;
+		index.push_back(entry);
+		position += size;
+	}
+	trj.clear();
+}
+
+int main(int argc, char* argv[]){
+
+	// open trajectory
+	std::ifstream trj("atoms-trajectory.trj", std::ios::in | std::ios::binary);
+	if(!trj.is_open()){
+		std::cerr << "Error - unable to open atoms-trajectory.trj" << std::endl;
+		return EXIT_FAILURE;
+	}
+	trj.seekg(0, std::ios::end);
+	const uint64_t length = trj.tellg();
+	trj.seekg(0);
+
+	char id[8];
+	trj.read(id, 8);
+	const int file_version = read_value<int32_t>(trj);
+	if(std::strncmp(id, "VAMPTRJ", 8)!=0 || file_version!=version){
+		std::cerr << "Error - atoms-trajectory.trj is not a supported vampire trajectory file" << std::endl;
+		return EXIT_FAILURE;
+	}
+	const uint64_t num_spins = read_value<uint64_t>(trj);
+	const uint64_t index_offset = read_value<uint64_t>(trj);
+	const uint64_t num_indexed = read_value<uint64_t>(trj);
+	const int32_t num_materials = read_value<int32_t>(trj);
+	std::vector<double> mu_s(num_materials);
+	for(int mat=0; mat<num_materials; mat++) mu_s[mat] = read_value<double>(trj);
+	double dimensions[3];
+	for(int i=0; i<3; i++) dimensions[i] = read_value<double>(trj);
+
+	// read static datasets
+	std::vector<uint64_t> ids(num_spins);
+	std::vector<int32_t> mat(num_spins), cat(num_spins);
+	std::vector<double> coords(3*num_spins);
+	if(num_spins>0){
+		trj.read(reinterpret_cast<char*>(&ids[0]), num_spins*sizeof(uint64_t));
+		trj.read(reinterpret_cast<char*>(&mat[0]), num_spins*sizeof(int32_t));
+		trj.read(reinterpret_cast<char*>(&cat[0]), num_spins*sizeof(int32_t));
+		trj.read(reinterpret_cast<char*>(&coords[0]), 3*num_spins*sizeof(double));
+	}
+	if(!trj){
+		std::cerr << "Error - atoms-trajectory.trj is truncated" << std::endl;
+		return EXIT_FAILURE;
+	}
+	const uint64_t frames_start = trj.tellg();
+
+	std::ofstream cfile("atoms-coords.cfg");
+	write_header(cfile, "Atomistic coordinates configuration file for vampire");
+	cfile << "Number of atoms: " << num_spins << "\n";
+	cfile << "#------------------------------------------------------\n";
+	cfile << "Number of spin files: 0\n";
+	cfile << "#------------------------------------------------------\n";
+	cfile << num_spins << "\n";
+	for(uint64_t i=0; i<num_spins; i++){
+		cfile << mat[i] << "\t" << cat[i] << "\t" << coords[3*i+0] << "\t" << coords[3*i+1] << "\t" << coords[3*i+2] << "\t" << mat[i] << "\n";
+	}
+	cfile.close();
+	std::cout << "Written static datasets to atoms-coords.cfg" << std::endl;
+
+	// read index of all frames, or rebuild it if the simulation did not finish
+	std::vector<index_entry_t> index;
+	if(index_offset>=frames_start && index_offset+num_indexed*24<=length){
+		trj.seekg(index_offset);
+		for(uint64_t f=0; f<num_indexed; f++){
+			index_entry_t entry;
+			entry.offset = read_value<uint64_t>(trj);
+			entry.snapshot = read_value<uint64_t>(trj);
+			entry.encoding = read_value<int32_t>(trj);
+			entry.bits = read_value<int32_t>(trj);
+			index.push_back(entry);
+		}
+	}
+	else{
+		std::cout << "atoms-trajectory.trj has no index, reading frame headers" << std::endl;
+		scan_frames(trj, frames_start, length, num_spins, index);
+	}
+
+	// determine frames to decode
+	std::vector<uint64_t> frames;
+	for(int arg=1; arg<argc; arg++) frames.push_back(atol(argv[arg]));
+	if(frames.size()==0) for(uint64_t f=0; f<index.size(); f++) frames.push_back(f);
+
+	std::vector<uint16_t> q(2*num_spins);
+	std::vector<double> spins(3*num_spins);
+	int64_t decoded = -1; // last decoded frame held in q or spins
+
+	for(unsigned int i=0; i<frames.size(); i++){
+
+		const uint64_t frame = frames[i];
+		if(frame>=index.size()){
+			std::cerr << "Error - frame " << frame << " not in trajectory of " << index.size() << " frames" << std::endl;
+			return EXIT_FAILURE;
+		}
+
+		// start from preceding key frame unless continuing from last decoded frame
+		uint64_t first = frame;
+		while(index[first].encoding==1 && first>0) first--;
+		if(decoded>=int64_t(first) && decoded<int64_t(frame)) first = decoded+1;
+
+		double header[7];
+		uint64_t snapshot = 0;
+		int bits = 16;
+		int encoding = 0;
+
+		for(uint64_t f=first; f<=frame; f++){
+
+			trj.seekg(index[f].offset);
+			snapshot = read_value<uint64_t>(trj);
+			for(int j=0; j<7; j++) header[j] = read_value<double>(trj);
+			bits = read_value<int32_t>(trj);
+			encoding = read_value<int32_t>(trj);
+			const int num_chunks = read_value<int32_t>(trj);
+			std::vector<uint64_t> chunks(2*num_chunks);
+			for(int c=0; c<2*num_chunks; c++) chunks[c] = read_value<uint64_t>(trj);
+
+			uint64_t start = 0;
+			for(int c=0; c<num_chunks; c++){
+				std::vector<unsigned char> bytes(chunks[2*c+1]);
+				if(bytes.size()>0) trj.read(reinterpret_cast<char*>(&bytes[0]), bytes.size());
+				const uint64_t n = chunks[2*c];
+				if(encoding==0) decode_key_block(bytes, bits, &q[2*start], 2*n);
+				else if(encoding==1) decode_delta_block(bytes, bits, &q[2*start], 2*n);
+				else if(bits==32){
+					const float* sp = reinterpret_cast<const float*>(bytes.data());
+					for(uint64_t j=0; j<3*n && 4*j<bytes.size(); j++) spins[3*start+j] = sp[j];
+				}
+				else if(3*n>0 && bytes.size()>=3*n*sizeof(double)) memcpy(&spins[3*start], &bytes[0], 3*n*sizeof(double));
+				start += n;
+			}
+
+			if(!trj){
+				std::cerr << "Error - atoms-trajectory.trj is truncated at frame " << f << std::endl;
+				return EXIT_FAILURE;
+			}
+
+		}
+		decoded = frame;
+
+		if(encoding!=2){
+			for(uint64_t s=0; s<num_spins; s++) octahedral_decode(q[2*s], q[2*s+1], bits, spins[3*s+0], spins[3*s+1], spins[3*s+2]);
+		}
+
+		// write text configuration file
+		std::stringstream file_sstr;
+		file_sstr << "atoms-" << std::setfill('0') << std::setw(8) << snapshot << ".cfg";
+		std::ofstream ofile(file_sstr.str().c_str());
+
+		write_header(ofile, "Atomistic spin configuration file for vampire");
+		ofile << "Number of spins: " << num_spins << "\n";
+		ofile << "System dimensions:" << dimensions[0] << "\t" << dimensions[1] << "\t" << dimensions[2] << "\n";
+		ofile << "Coordinates-file: atoms-coord.cfg\n";
+		ofile << "Time: " << header[0] << "\n";
+		ofile << "Field: " << header[1] << "\n";
+		ofile << "Temperature: " << header[2] << "\n";
+		ofile << "Magnetisation: " << header[3] << "\t" << header[4] << "\t" << header[5] << "\t" << header[6] << "\t\n";
+		ofile << "Number of Materials: " << num_materials << "\n";
+		for(int m=0; m<num_materials; m++) ofile << mu_s[m] << "\n";
+		ofile << "#------------------------------------------------------\n";
+		ofile << "Number of spin files: 0\n";
+		ofile << "#------------------------------------------------------\n";
+		ofile << num_spins << "\n";
+		for(uint64_t s=0; s<num_spins; s++){
+			ofile << spins[3*s+0] << "\t" << spins[3*s+1] << "\t" << spins[3*s+2] << "\n";
+		}
+
+		std::cout << "Decoded frame " << frame << " to " << file_sstr.str() << std::endl;
+
+	}
+
+	return EXIT_SUCCESS;
+
+}